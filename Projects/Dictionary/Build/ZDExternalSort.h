@@ -0,0 +1,350 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <queue>
+#include <memory>
+#include <random>
+#include <fstream>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include "Serialization/ZDBinaryIO.h"
+
+namespace Dico
+{
+    //! @brief the settings of an external sort
+    struct ZDExternalSortOptions
+    {
+        //! @brief the memory used to hold words before they are sorted and written to a temporary run file
+        std::size_t memory_budget = std::size_t(256) << 20;
+
+        //! @brief the largest number of runs merged at once; with more runs, groups of runs are merged first
+        std::size_t max_fan_in = 64;
+
+        //! @brief the directory of the run files, the temporary directory of the system if empty
+        std::string temporary_directory;
+
+        //! @brief the weight of a word given several times : the sum of its weights if true, otherwise its last
+        //! weight, as ZDDictionary::insert_word gives
+        bool sum_weights = false;
+    };
+
+    //! @brief this class sorts more words than fit in memory : the words are gathered up to a memory budget,
+    //! then sorted, their duplicates merged, and written to a temporary file (a run). At the end the runs are
+    //! merged together, a word at a time, so the memory used stays about the budget whatever the number of words.
+    //! Each word carries a weight; a word given several times keeps its last weight, or the sum of its weights
+    //! (see ZDExternalSortOptions::sum_weights).
+    class ZDExternalSorter
+    {
+    public:
+        //! @brief build a sorter
+        //! @param options the settings
+        explicit ZDExternalSorter(const ZDExternalSortOptions& options = ZDExternalSortOptions())
+            : m_options(options)
+        {
+            std::random_device random;
+            m_session = std::to_string(random()) + "." + std::to_string(reinterpret_cast<std::uintptr_t>(this));
+            if (m_options.max_fan_in < 2)
+            {
+                m_options.max_fan_in = 2;
+            }
+        };
+
+        //! @brief distructor, remove the run files left
+        ~ZDExternalSorter()
+        {
+            for (const auto& run : m_runs)
+            {
+                std::remove(run.c_str());
+            }
+        };
+
+        ZDExternalSorter(const ZDExternalSorter&) = delete;
+        ZDExternalSorter& operator=(const ZDExternalSorter&) = delete;
+
+        //! @brief add a word
+        //! @param word the given word
+        //! @param weight the weight of the word
+        //! @return true if succes, false if a run file can not be written
+        bool add(const std::string& word, uint32_t weight)
+        {
+            if (m_entries.size() == m_entries.capacity() && !m_entries.empty()
+                && m_bytes + 3 * m_entries.capacity() * sizeof(Entry) > m_options.memory_budget)
+            {
+                //growing the array, which holds the old and the new array at once, would go past the budget
+                if (!spill())
+                {
+                    return false;
+                }
+            }
+            m_entries.push_back(Entry{ word, weight });
+            m_bytes += heap_size(m_entries.back().word);
+            if (m_bytes + m_entries.capacity() * sizeof(Entry) > m_options.memory_budget)
+            {
+                return spill();
+            }
+            return true;
+        };
+
+        //! @brief get the words in increasing byte order, each one once with its last weight or the sum of its weights;
+        //! the sorter is then empty
+        //! @param visitor called with each word and its weight
+        //! @return true if succes, false if a run file can not be read or written
+        template<class Visitor>
+        bool finish(Visitor visitor)
+        {
+            if (m_runs.empty())
+            {
+                sort_entries();
+                for (const auto& entry : m_entries)
+                {
+                    visitor(entry.word, entry.weight);
+                }
+                release_entries();
+                return true;
+            }
+
+            if (!m_entries.empty() && !spill())
+            {
+                return false;
+            }
+            release_entries();
+
+            //merge groups of runs until one pass is enough, each group giving a run in its place so that the runs
+            //stay in the order of the words added
+            while (m_runs.size() > m_options.max_fan_in)
+            {
+                std::vector<std::string> merged;
+                bool result = true;
+                for (std::size_t first = 0; first < m_runs.size() && result; first += m_options.max_fan_in)
+                {
+                    const std::size_t last = std::min(first + m_options.max_fan_in, m_runs.size());
+                    const std::vector<std::string> group(m_runs.begin() + first, m_runs.begin() + last);
+                    merged.push_back(new_run());
+                    std::ofstream out(merged.back(), std::ios::binary);
+                    auto writer = [&out](const std::string& word, uint32_t weight)
+                    {
+                        write_entry(out, word, weight);
+                    };
+                    result = out.is_open() && merge(group, writer);
+                    out.close();
+                    result = result && static_cast<bool>(out);
+                }
+
+                for (const auto& run : m_runs)
+                {
+                    std::remove(run.c_str());
+                }
+                m_runs.swap(merged);
+                if (!result)
+                {
+                    return false;
+                }
+            }
+
+            const bool result = merge(m_runs, visitor);
+            for (const auto& run : m_runs)
+            {
+                std::remove(run.c_str());
+            }
+            m_runs.clear();
+            return result;
+        };
+
+        //! @brief get the number of run files written so far
+        //! @return
+        std::size_t run_count() const
+        {
+            return m_runCount;
+        };
+
+    private:
+        //! @brief a word and its weight
+        struct Entry
+        {
+            std::string word;
+            uint32_t weight;
+        };
+
+        //! @brief a run being merged, and its current word
+        struct Run
+        {
+            std::ifstream file;
+            std::string word;
+            uint32_t weight = 0;
+
+            //! @brief read the next word of the run
+            //! @return false at the end of the run
+            bool next()
+            {
+                return read_string(file, word) && read_pod(file, weight);
+            };
+        };
+
+        //! @brief get the memory of a string outside of the string itself
+        static std::size_t heap_size(const std::string& word)
+        {
+            return (word.capacity() > 15) ? word.capacity() + 1 : 0;
+        };
+
+        //! @brief get the weight of a word given again : the later weight, or the sum of both without overflow
+        uint32_t combine(uint32_t earlier, uint32_t later) const
+        {
+            if (!m_options.sum_weights)
+            {
+                return later;
+            }
+            return (earlier > std::numeric_limits<uint32_t>::max() - later) ? std::numeric_limits<uint32_t>::max() : earlier + later;
+        };
+
+        //! @brief write a word and its weight to a run file
+        static void write_entry(std::ostream& out, const std::string& word, uint32_t weight)
+        {
+            write_string(out, word);
+            write_pod(out, weight);
+        };
+
+        //! @brief sort the words held in memory and merge their duplicates, which stay in the order they were added
+        void sort_entries()
+        {
+            std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b)
+            {
+                return a.word < b.word;
+            });
+            std::size_t last = 0;
+            for (std::size_t i = 1; i < m_entries.size(); ++i)
+            {
+                if (m_entries[i].word == m_entries[last].word)
+                {
+                    m_entries[last].weight = combine(m_entries[last].weight, m_entries[i].weight);
+                }
+                else if (++last != i)
+                {
+                    m_entries[last] = std::move(m_entries[i]);
+                }
+            }
+            if (!m_entries.empty())
+            {
+                m_entries.resize(last + 1);
+            }
+        };
+
+        //! @brief free the words held in memory
+        void release_entries()
+        {
+            std::vector<Entry>().swap(m_entries);
+            m_bytes = 0;
+        };
+
+        //! @brief write the words held in memory to a new run file
+        bool spill()
+        {
+            sort_entries();
+            const std::string run = new_run();
+            std::ofstream out(run, std::ios::binary);
+            for (const auto& entry : m_entries)
+            {
+                write_entry(out, entry.word, entry.weight);
+            }
+            out.close();
+            m_runs.push_back(run);
+
+            //keep the array, its size is part of the budget
+            m_entries.clear();
+            m_bytes = 0;
+            return static_cast<bool>(out);
+        };
+
+        //! @brief get the path of a new run file
+        std::string new_run()
+        {
+            const std::filesystem::path directory = m_options.temporary_directory.empty()
+                ? std::filesystem::temp_directory_path() : std::filesystem::path(m_options.temporary_directory);
+            ++m_runCount;
+            return (directory / ("zdsort." + m_session + "." + std::to_string(m_runCount))).string();
+        };
+
+        //! @brief merge sorted runs, the duplicates of different runs being merged too, in the order of the runs
+        template<class Visitor>
+        bool merge(const std::vector<std::string>& paths, Visitor& visitor)
+        {
+            std::vector<std::unique_ptr<Run>> runs;
+            for (const auto& path : paths)
+            {
+                std::unique_ptr<Run> run(new Run());
+                run->file.open(path, std::ios::binary);
+                if (!run->file.is_open())
+                {
+                    return false;
+                }
+                if (run->next())
+                {
+                    runs.push_back(std::move(run));
+                }
+            }
+
+            //the run of lowest current word on top, the earlier run first for equal words
+            auto greater = [&runs](std::size_t a, std::size_t b)
+            {
+                const int order = runs[a]->word.compare(runs[b]->word);
+                return order > 0 || (order == 0 && a > b);
+            };
+            std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> heap(greater);
+            for (std::size_t i = 0; i < runs.size(); ++i)
+            {
+                heap.push(i);
+            }
+
+            std::string word;
+            uint32_t weight = 0;
+            bool pending = false;
+            while (!heap.empty())
+            {
+                const std::size_t top = heap.top();
+                heap.pop();
+                Run& run = *runs[top];
+                if (pending && run.word == word)
+                {
+                    weight = combine(weight, run.weight);
+                }
+                else
+                {
+                    if (pending)
+                    {
+                        visitor(static_cast<const std::string&>(word), weight);
+                    }
+                    word.swap(run.word);
+                    weight = run.weight;
+                    pending = true;
+                }
+                if (run.next())
+                {
+                    heap.push(top);
+                }
+            }
+            if (pending)
+            {
+                visitor(static_cast<const std::string&>(word), weight);
+            }
+            return true;
+        };
+
+        //! @brief the settings
+        ZDExternalSortOptions m_options;
+
+        //! @brief the words held in memory, and the memory of their chars
+        std::vector<Entry> m_entries;
+        std::size_t m_bytes = 0;
+
+        //! @brief the run files not merged yet
+        std::vector<std::string> m_runs;
+
+        //! @brief the number of run files written, and a token making their names unique
+        std::size_t m_runCount = 0;
+        std::string m_session;
+    };
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "ZDDictionary.h"
+#include "Build/ZDExternalSort.h"
+#include "Serialization/ZDBinaryIO.h"
+
+namespace Dico
+{
+    //! @brief this class writes a dictionary file, as ZDDictionary::save does, from words given in increasing
+    //! order, without building the tree : only the path of the last word is kept, and the nodes are written as
+    //! the words come. The file is then read by ZDDictionary::load.
+    class ZDSnapshotWriter
+    {
+    public:
+        //! @brief start writing a dictionary to a binary stream
+        //! @param out the given stream
+        explicit ZDSnapshotWriter(std::ostream& out)
+            : m_out(out)
+        {
+            const ZDDictionary empty;
+            m_roots = empty.FrenchAlphabet;
+            std::sort(m_roots.begin(), m_roots.end(), [](char a, char b)
+            {
+                return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+            });
+            write_header(m_out, ZDDictionary::file_magic, ZDDictionary::file_version);
+        };
+
+        //! @brief convert a word as ZDDictionary::insert_word does : to lower case, the leading chars which are not
+        //! a root being skipped
+        //! @param word the given word
+        //! @return the converted word, empty if it holds no root
+        std::string normalize(const std::string& word) const
+        {
+            const std::string lowerCase = ZDDictionary::to_lower_case_word(word);
+            for (std::size_t count = 0; count < lowerCase.size(); ++count)
+            {
+                if (std::find(m_roots.begin(), m_roots.end(), lowerCase[count]) != m_roots.end())
+                {
+                    return lowerCase.substr(count);
+                }
+            }
+            return std::string();
+        };
+
+        //! @brief add a word, greater than the previous one
+        //! @param word the given word, already converted (see normalize)
+        //! @param weight the weight of the word
+        //! @return true if succes, false if the word is not converted or not greater than the previous one
+        bool add(const std::string& word, uint32_t weight)
+        {
+            const auto root = word.empty() ? m_roots.end() : std::find(m_roots.begin(), m_roots.end(), word[0]);
+            if (root == m_roots.end() || (m_words != 0 && word <= m_previous))
+            {
+                return false;
+            }
+
+            //close the nodes of the previous word which are not on the path of this one
+            std::size_t common = 0;
+            while (common < m_path.size() && common < word.size() && m_path[common] == word[common])
+            {
+                ++common;
+            }
+            close(common);
+
+            //the roots without words before this one
+            if (m_path.empty())
+            {
+                const std::size_t index = static_cast<std::size_t>(root - m_roots.begin());
+                write_empty_roots(index);
+                m_nextRoot = index + 1;
+            }
+
+            for (std::size_t depth = m_path.size(); depth < word.size(); ++depth)
+            {
+                ZDNodeData data(word[depth]);
+                if (depth + 1 == word.size())
+                {
+                    data.terminal = true;
+                    data.weight = weight;
+                    data.id = static_cast<uint32_t>(m_words);
+                }
+                ZDDictionary::write_node(m_out, data);
+                m_path.push_back(word[depth]);
+            }
+
+            m_previous = word;
+            ++m_words;
+            return static_cast<bool>(m_out);
+        };
+
+        //! @brief close the nodes still open and end the file
+        //! @return true if succes, false otherwise
+        bool finish()
+        {
+            close(0);
+            write_empty_roots(m_roots.size());
+            m_out.put(0);
+            m_out.flush();
+            return static_cast<bool>(m_out);
+        };
+
+        //! @brief get the number of words written
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_words;
+        };
+
+        //! @brief write a dictionary file from a lexico file of any size (see Lexico for its format) : the words are
+        //! sorted within a memory budget (see ZDExternalSorter) then written in order, so neither the lines nor
+        //! the tree are held in memory. A word given several times gets its last weight, as with
+        //! ZDDictionary::insert_word, or the sum of its weights (see ZDExternalSortOptions::sum_weights).
+        //! @param lexicoFile the path of the lexico file
+        //! @param dictionaryFile the path of the dictionary file to write
+        //! @param options the settings of the sort
+        //! @return true if succes, false otherwise
+        static bool build(const std::string& lexicoFile, const std::string& dictionaryFile, const ZDExternalSortOptions& options = ZDExternalSortOptions())
+        {
+            std::ifstream in(lexicoFile);
+            std::ofstream out(dictionaryFile, std::ios::binary);
+            if (!in.is_open() || !out.is_open())
+            {
+                return false;
+            }
+
+            ZDSnapshotWriter writer(out);
+            ZDExternalSorter sorter(options);
+            std::string line;
+            while (std::getline(in, line))
+            {
+                //optional "word<TAB>count" format, words without count get a null weight
+                uint32_t weight = 0;
+                const std::size_t tab = line.find('\t');
+                if (tab != std::string::npos)
+                {
+                    weight = static_cast<uint32_t>(std::strtoul(line.c_str() + tab + 1, nullptr, 10));
+                    line.erase(tab);
+                }
+
+                const std::string word = writer.normalize(line);
+                if (!word.empty() && !sorter.add(word, weight))
+                {
+                    return false;
+                }
+            }
+
+            bool written = true;
+            const bool sorted = sorter.finish([&](const std::string& word, uint32_t weight)
+            {
+                written = writer.add(word, weight) && written;
+            });
+            return sorted && written && writer.finish();
+        };
+
+    private:
+        //! @brief close the nodes of the path deeper than a depth
+        void close(std::size_t depth)
+        {
+            while (m_path.size() > depth)
+            {
+                m_out.put(0);
+                m_path.pop_back();
+            }
+        };
+
+        //! @brief write the roots without words up to a given one, excluded
+        void write_empty_roots(std::size_t end)
+        {
+            for (; m_nextRoot < end; ++m_nextRoot)
+            {
+                ZDDictionary::write_node(m_out, ZDNodeData(m_roots[m_nextRoot]));
+                m_out.put(0);
+            }
+        };
+
+        //! @brief the stream written
+        std::ostream& m_out;
+
+        //! @brief the roots of a dictionary, sorted, and the first one not written yet
+        std::vector<char> m_roots;
+        std::size_t m_nextRoot = 0;
+
+        //! @brief the chars of the nodes open, from the root
+        std::string m_path;
+
+        //! @brief the last word added, and the number of words
+        std::string m_previous;
+        std::size_t m_words = 0;
+    };
+}
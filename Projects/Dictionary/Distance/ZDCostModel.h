@@ -0,0 +1,298 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace Dico
+{
+    //! @brief the costs of the edit operations of a weighted edit distance : a substitution cost per pair of
+    //! symbols, an insertion and a deletion cost per symbol and one transposition cost (optimal string alignment,
+    //! two adjacent symbols swapped). Costs are fractional, so that a likely typo (a missing accent, a key next to
+    //! the right one) costs less than a random one.
+    //! Symbols are bytes, like the chars stored in the dictionary tree. A char of the Latin-1 range written in
+    //! UTF-8 (two bytes, C2 or C3 then a continuation byte) is one symbol, its Latin-1 byte (see fold), so the
+    //! accents are folded for UTF-8 text as for Latin-1 text; other multi-byte chars are seen as several symbols.
+    //! Insertion is for a symbol of the dictionary word missing from the given word, deletion for a symbol of the
+    //! given word not in the dictionary word.
+    class ZDCostModel
+    {
+    public:
+        //! @brief build a model where every operation of a kind has the same cost
+        //! @param substitution the cost of replacing a symbol by another one
+        //! @param insertion the cost of a missing symbol
+        //! @param deletion the cost of an extra symbol
+        //! @param transposition the cost of two adjacent symbols swapped
+        explicit ZDCostModel(float substitution = 1.0f, float insertion = 1.0f, float deletion = 1.0f, float transposition = 1.0f)
+            : m_substitution(256 * 256, substitution)
+            , m_insertion(256, insertion)
+            , m_deletion(256, deletion)
+            , m_transposition(transposition)
+        {
+            for (std::size_t c = 0; c < 256; ++c)
+            {
+                m_substitution[c * 256 + c] = 0.0f;
+            }
+        };
+
+        //! @brief set the cost of replacing a symbol by another one, both ways
+        //! @param a the first symbol
+        //! @param b the second symbol
+        //! @param cost the given cost, not negative
+        void set_substitution(char a, char b, float cost)
+        {
+            if (a != b)
+            {
+                m_substitution[index(a) * 256 + index(b)] = cost;
+                m_substitution[index(b) * 256 + index(a)] = cost;
+            }
+        };
+
+        //! @brief set the cost of a missing symbol
+        //! @param c the given symbol
+        //! @param cost the given cost, not negative
+        void set_insertion(char c, float cost)
+        {
+            m_insertion[index(c)] = cost;
+        };
+
+        //! @brief set the cost of an extra symbol
+        //! @param c the given symbol
+        //! @param cost the given cost, not negative
+        void set_deletion(char c, float cost)
+        {
+            m_deletion[index(c)] = cost;
+        };
+
+        //! @brief set the cost of two adjacent symbols swapped
+        //! @param cost the given cost, not negative
+        void set_transposition(float cost)
+        {
+            m_transposition = cost;
+        };
+
+        //! @brief lower the cost of replacing an accented letter by its base letter, or by another accented form
+        //! of it ("é" for "e" or "è"), for Latin-1 text and UTF-8 text (see fold)
+        //! @param cost the given cost
+        void add_accents(float cost)
+        {
+            static const char* const groups[] = {
+                "a\xE0\xE2\xE4", "c\xE7", "e\xE8\xE9\xEA\xEB", "i\xEE\xEF", "o\xF4\xF6", "u\xF9\xFB\xFC", "y\xFF"
+            };
+            for (const char* group : groups)
+            {
+                add_group(group, cost);
+            }
+        };
+
+        //! @brief lower the cost of replacing a letter by a key next to it on a keyboard. The rows are given from
+        //! the top, each one shifted a bit to the right of the one above : a key touches its neighbours of the
+        //! same row, the keys above it at the same column and at the next one, and the keys below it at the same
+        //! column and at the previous one. A space stands for a key which is not a letter.
+        //! @param rows the letters of the keyboard, by row
+        //! @param cost the given cost
+        void add_keyboard(const std::vector<std::string>& rows, float cost)
+        {
+            for (std::size_t row = 0; row < rows.size(); ++row)
+            {
+                for (std::size_t column = 0; column < rows[row].size(); ++column)
+                {
+                    const char key = rows[row][column];
+                    if (key == ' ')
+                    {
+                        continue;
+                    }
+                    if (column + 1 < rows[row].size())
+                    {
+                        lower_substitution(key, rows[row][column + 1], cost);
+                    }
+                    if (row + 1 < rows.size())
+                    {
+                        const std::string& below = rows[row + 1];
+                        if (column < below.size())
+                        {
+                            lower_substitution(key, below[column], cost);
+                        }
+                        if (column > 0 && column - 1 < below.size())
+                        {
+                            lower_substitution(key, below[column - 1], cost);
+                        }
+                    }
+                }
+            }
+        };
+
+        //! @brief lower the cost of replacing a letter by a key next to it on a french AZERTY keyboard
+        //! @param cost the given cost
+        void add_azerty(float cost)
+        {
+            add_keyboard({ "azertyuiop", "qsdfghjklm", " wxcvbn" }, cost);
+        };
+
+        //! @brief get a model for french typing errors : accents missing or wrong, keys next to the right one on
+        //! an AZERTY keyboard, and swapped letters, are cheaper than other errors
+        //! @return
+        static ZDCostModel french()
+        {
+            ZDCostModel model(1.0f, 1.0f, 1.0f, 0.5f);
+            model.add_azerty(0.5f);
+            model.add_accents(0.25f);
+            return model;
+        };
+
+        //! @brief get the cost of replacing a symbol by another one
+        //! @return
+        float substitution(char a, char b) const
+        {
+            return m_substitution[index(a) * 256 + index(b)];
+        };
+
+        //! @brief get the costs of replacing a given symbol by each of the 256 symbols, or the other way round, the
+        //! substitution costs being the same both ways
+        //! @return
+        const float* substitutions(char a) const
+        {
+            return m_substitution.data() + index(a) * 256;
+        };
+
+        //! @brief get the cost of a missing symbol
+        //! @return
+        float insertion(char c) const
+        {
+            return m_insertion[index(c)];
+        };
+
+        //! @brief get the cost of an extra symbol
+        //! @return
+        float deletion(char c) const
+        {
+            return m_deletion[index(c)];
+        };
+
+        //! @brief get the cost of two adjacent symbols swapped
+        //! @return
+        float transposition() const
+        {
+            return m_transposition;
+        };
+
+        //! @brief compute the weighted distance between a given word and a dictionary word (optimal string
+        //! alignment : a swapped pair is not edited again)
+        //! @param given the given word
+        //! @param dictionaryWord the dictionary word
+        //! @return the lowest total cost of the operations turning word into reference
+        float distance(const std::string& given, const std::string& dictionaryWord) const
+        {
+            const std::string word = fold(given);
+            const std::string reference = fold(dictionaryWord);
+            const std::size_t columns = word.size() + 1;
+            std::vector<float> d((reference.size() + 1) * columns);
+            for (std::size_t i = 1; i < columns; ++i)
+            {
+                d[i] = d[i - 1] + deletion(word[i - 1]);
+            }
+            for (std::size_t j = 1; j <= reference.size(); ++j)
+            {
+                float* current = d.data() + j * columns;
+                const float* previous = current - columns;
+                const char letter = reference[j - 1];
+                current[0] = previous[0] + insertion(letter);
+                for (std::size_t i = 1; i < columns; ++i)
+                {
+                    current[i] = std::min({ previous[i] + insertion(letter),
+                                            current[i - 1] + deletion(word[i - 1]),
+                                            previous[i - 1] + substitution(word[i - 1], letter) });
+                    if (i > 1 && j > 1 && word[i - 1] == reference[j - 2] && word[i - 2] == letter)
+                    {
+                        current[i] = std::min(current[i], (previous - columns)[i - 2] + m_transposition);
+                    }
+                }
+            }
+            return d.back();
+        };
+
+        //! @brief true if a byte starts a char of the Latin-1 range written in UTF-8 (U+0080 to U+00FF)
+        //! @return
+        static inline bool is_latin1_lead(char c)
+        {
+            return c == '\xC2' || c == '\xC3';
+        };
+
+        //! @brief true if a byte is the continuation byte of a multi-byte UTF-8 char
+        //! @return
+        static inline bool is_continuation(char c)
+        {
+            return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+        };
+
+        //! @brief get the Latin-1 byte of a char written in UTF-8 as a lead byte (see is_latin1_lead) and a
+        //! continuation byte ("\xC3\xA9" gives '\xE9', "é")
+        //! @return
+        static inline char to_latin1(char lead, char continuation)
+        {
+            return static_cast<char>(((static_cast<unsigned char>(lead) & 0x03) << 6) | (static_cast<unsigned char>(continuation) & 0x3F));
+        };
+
+        //! @brief convert the chars of the Latin-1 range written in UTF-8 to their Latin-1 byte, the other bytes
+        //! being kept, so that a word is seen as symbols
+        //! @param word the given word
+        //! @return
+        static std::string fold(const std::string& word)
+        {
+            std::string result;
+            result.reserve(word.size());
+            for (std::size_t i = 0; i < word.size(); ++i)
+            {
+                if (is_latin1_lead(word[i]) && i + 1 < word.size() && is_continuation(word[i + 1]))
+                {
+                    result.push_back(to_latin1(word[i], word[i + 1]));
+                    ++i;
+                }
+                else
+                {
+                    result.push_back(word[i]);
+                }
+            }
+            return result;
+        };
+
+    private:
+        //! @brief get the index of a symbol in the tables
+        static inline std::size_t index(char c)
+        {
+            return static_cast<unsigned char>(c);
+        };
+
+        //! @brief lower the cost of replacing a symbol by another one, both ways, a lower cost being kept
+        void lower_substitution(char a, char b, float cost)
+        {
+            if (a != ' ' && b != ' ')
+            {
+                set_substitution(a, b, std::min(cost, substitution(a, b)));
+            }
+        };
+
+        //! @brief lower the cost of replacing any symbol of a group by another one of the group
+        void add_group(const std::string& group, float cost)
+        {
+            for (std::size_t i = 0; i < group.size(); ++i)
+            {
+                for (std::size_t j = i + 1; j < group.size(); ++j)
+                {
+                    lower_substitution(group[i], group[j], cost);
+                }
+            }
+        };
+
+        //! @brief the cost of replacing a symbol by another one, by pair of symbols
+        std::vector<float> m_substitution;
+
+        //! @brief the costs of a missing and of an extra symbol, by symbol
+        std::vector<float> m_insertion;
+        std::vector<float> m_deletion;
+
+        //! @brief the cost of two adjacent symbols swapped
+        float m_transposition;
+    };
+}
@@ -0,0 +1,524 @@
+#pragma once
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Dico
+{
+    //! @brief count the bits set in a 64 bits word
+    //! @param value the given word
+    //! @return the number of bits set
+    inline int popcount64(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(value));
+#else
+        return __builtin_popcountll(value);
+#endif
+    }
+
+    //! @brief the bit-vector state of one DP row of Myers' algorithm : the distances between
+    //! every prefix of the pattern and the text read so far, stored as vertical deltas.
+    //! When walking a trie, one row per depth is all the state needed.
+    struct ZDMyersRow
+    {
+        uint64_t vp;    //!< bit i set if D[i+1] - D[i] == +1
+        uint64_t vn;    //!< bit i set if D[i+1] - D[i] == -1
+        int score;      //!< distance between the whole pattern and the text read so far
+        int column;     //!< number of text symbols read so far, that is D[0]
+    };
+
+    //! @brief precomputed match masks of a pattern for Myers' bit-vector edit distance.
+    //! The pattern is compiled once and can then be compared against many texts, each
+    //! comparison costing one pass over the text with a handful of word operations per symbol.
+    //! Symbols are bytes, like the chars stored in the dictionary tree. Nothing is allocated.
+    class ZDMyersPattern
+    {
+    public:
+        //! @brief maximum pattern size handled by the bit-vector kernel (one machine word)
+        static constexpr std::size_t max_size = 64;
+
+        //! @brief default constructor, empty pattern
+        ZDMyersPattern()
+            : m_size(0)
+        {
+            std::fill(m_peq, m_peq + 256, uint64_t(0));
+        };
+
+        //! @brief build the match masks of a given pattern
+        //! @param pattern the pattern, at most max_size symbols
+        explicit ZDMyersPattern(const std::string& pattern)
+            : ZDMyersPattern()
+        {
+            assign(pattern);
+        };
+
+        //! @brief replace the compiled pattern
+        //! @param pattern the new pattern, at most max_size symbols
+        void assign(const std::string& pattern)
+        {
+            assign(pattern.data(), pattern.size());
+        };
+
+        //! @brief replace the compiled pattern
+        //! @param pattern the new pattern
+        //! @param size the size of the pattern, at most max_size symbols
+        void assign(const char* pattern, std::size_t size)
+        {
+            //reset only the masks set by the previous pattern
+            for (std::size_t i = 0; i < m_size; ++i)
+            {
+                m_peq[static_cast<unsigned char>(m_symbols[i])] = 0;
+            }
+
+            assert(size <= max_size);
+            m_size = std::min(size, max_size);
+
+            for (std::size_t i = 0; i < m_size; ++i)
+            {
+                m_symbols[i] = pattern[i];
+                m_peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+            }
+        };
+
+        //! @brief get the size of the compiled pattern
+        //! @return
+        std::size_t size() const
+        {
+            return m_size;
+        };
+
+        //! @brief get the match mask of a symbol
+        //! @param symbol the given symbol
+        //! @return a mask with bit i set if pattern[i] == symbol
+        uint64_t mask(char symbol) const
+        {
+            return m_peq[static_cast<unsigned char>(symbol)];
+        };
+
+        //! @brief get the row of the empty text
+        //! @return
+        ZDMyersRow first_row() const
+        {
+            const uint64_t ones = (m_size == 64) ? ~uint64_t(0) : ((uint64_t(1) << m_size) - 1);
+            return ZDMyersRow{ ones, 0, static_cast<int>(m_size), 0 };
+        };
+
+        //! @brief compute the row following a given one when the text is extended by one symbol
+        //! @param row the row of the text read so far
+        //! @param symbol the next symbol of the text
+        //! @return the new row
+        ZDMyersRow advance(const ZDMyersRow& row, char symbol) const
+        {
+            ZDMyersRow next = row;
+            ++next.column;
+            if (m_size == 0)
+            {
+                next.score = next.column;
+                return next;
+            }
+
+            const uint64_t last = uint64_t(1) << (m_size - 1);
+            const uint64_t x = mask(symbol) | row.vn;
+            const uint64_t d0 = (((x & row.vp) + row.vp) ^ row.vp) | x;
+            uint64_t hp = row.vn | ~(d0 | row.vp);
+            uint64_t hn = row.vp & d0;
+
+            if (hp & last) ++next.score;
+            if (hn & last) --next.score;
+
+            hp = (hp << 1) | 1;
+            hn = hn << 1;
+            next.vp = hn | ~(d0 | hp);
+            next.vn = hp & d0;
+            return next;
+        };
+
+        //! @brief get the lowest distance between a prefix of the pattern and the text read so far,
+        //! when it is at most max_error. No extension of the text can end closer than this value,
+        //! so a trie walk can prune the subtree below a row whose minimum exceeds max_error.
+        //! @param row the given row
+        //! @param max_error the maximum number of errors
+        //! @return the minimum of the row if it is at most max_error, max_error + 1 otherwise
+        int minimum(const ZDMyersRow& row, int max_error) const
+        {
+            //D[i] >= |i - column|, so only the band [column - max_error, column + max_error] can be low enough
+            const int low = std::max(0, row.column - max_error);
+            const int high = std::min(static_cast<int>(m_size), row.column + max_error);
+            if (low > high)
+            {
+                return max_error + 1;
+            }
+
+            const uint64_t below = (low == 64) ? ~uint64_t(0) : ((uint64_t(1) << low) - 1);
+            int value = row.column + popcount64(row.vp & below) - popcount64(row.vn & below);
+            int result = value;
+            for (int i = low; i < high; ++i)
+            {
+                value += static_cast<int>((row.vp >> i) & 1) - static_cast<int>((row.vn >> i) & 1);
+                result = std::min(result, value);
+            }
+            return std::min(result, max_error + 1);
+        };
+
+        //! @brief compute the Levenshtein distance between the pattern and a given text
+        //! @param text the given text
+        //! @param size the size of the text
+        //! @return the edit distance (substitution, addition, deletion)
+        int distance(const char* text, std::size_t size) const
+        {
+            ZDMyersRow row = first_row();
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                row = advance(row, text[j]);
+            }
+            return row.score;
+        };
+
+        //! @brief compute the Levenshtein distance between the pattern and a given text
+        //! @param text the given text
+        //! @return the edit distance (substitution, addition, deletion)
+        int distance(const std::string& text) const
+        {
+            return distance(text.data(), text.size());
+        };
+
+        //! @brief compute the Levenshtein distance between the pattern and a given text, giving up
+        //! as soon as it is known to exceed a threshold
+        //! @param text the given text
+        //! @param size the size of the text
+        //! @param max_error the threshold
+        //! @return the edit distance if it is at most max_error, max_error + 1 otherwise
+        int distance(const char* text, std::size_t size, int max_error) const
+        {
+            const int remaining = static_cast<int>(size);
+            if (std::abs(remaining - static_cast<int>(m_size)) > max_error)
+            {
+                return max_error + 1;
+            }
+
+            ZDMyersRow row = first_row();
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                row = advance(row, text[j]);
+                //each remaining symbol lowers the final distance by one at best
+                if (row.score - (remaining - row.column) > max_error)
+                {
+                    return max_error + 1;
+                }
+            }
+            return std::min(row.score, max_error + 1);
+        };
+
+    private:
+        //! @brief match masks, indexed by byte value
+        uint64_t m_peq[256];
+
+        //! @brief the compiled pattern
+        char m_symbols[max_size];
+
+        //! @brief the size of the compiled pattern
+        std::size_t m_size;
+    };
+
+    //! @brief Myers' bit-vector edit distance for patterns longer than one machine word : the
+    //! DP column is split in blocks of 64 rows, the horizontal delta being carried from one block
+    //! to the next. The match masks are allocated once when the pattern is compiled, comparisons
+    //! allocate nothing.
+    class ZDMyersBlockPattern
+    {
+    public:
+        //! @brief maximum number of 64 rows blocks
+        static constexpr std::size_t max_blocks = 16;
+
+        //! @brief maximum pattern size handled by the block kernel
+        static constexpr std::size_t max_size = max_blocks * 64;
+
+        //! @brief default constructor, empty pattern
+        ZDMyersBlockPattern() = default;
+
+        //! @brief build the match masks of a given pattern
+        //! @param pattern the pattern, at most max_size symbols
+        explicit ZDMyersBlockPattern(const std::string& pattern)
+        {
+            assign(pattern);
+        };
+
+        //! @brief replace the compiled pattern
+        //! @param pattern the new pattern, at most max_size symbols
+        void assign(const std::string& pattern)
+        {
+            assert(pattern.size() <= max_size);
+            m_size = std::min(pattern.size(), max_size);
+            m_blocks = (m_size + 63) / 64;
+
+            m_peq.assign(256 * m_blocks, 0);
+            for (std::size_t i = 0; i < m_size; ++i)
+            {
+                m_peq[static_cast<unsigned char>(pattern[i]) * m_blocks + i / 64] |= uint64_t(1) << (i % 64);
+            }
+        };
+
+        //! @brief get the size of the compiled pattern
+        //! @return
+        std::size_t size() const
+        {
+            return m_size;
+        };
+
+        //! @brief compute the Levenshtein distance between the pattern and a given text
+        //! @param text the given text
+        //! @param size the size of the text
+        //! @return the edit distance (substitution, addition, deletion)
+        int distance(const char* text, std::size_t size) const
+        {
+            return distance(text, size, static_cast<int>(m_size + size));
+        };
+
+        //! @brief compute the Levenshtein distance between the pattern and a given text
+        //! @param text the given text
+        //! @return the edit distance (substitution, addition, deletion)
+        int distance(const std::string& text) const
+        {
+            return distance(text.data(), text.size());
+        };
+
+        //! @brief compute the Levenshtein distance between the pattern and a given text, giving up
+        //! as soon as it is known to exceed a threshold. Only the blocks crossing the diagonal band
+        //! of width 2 * max_error + 1 are computed, lower blocks are started when the band reaches them.
+        //! @param text the given text
+        //! @param size the size of the text
+        //! @param max_error the threshold
+        //! @return the edit distance if it is at most max_error, max_error + 1 otherwise
+        int distance(const char* text, std::size_t size, int max_error) const
+        {
+            const int n = static_cast<int>(size);
+            const int m = static_cast<int>(m_size);
+            if (m == 0 || n == 0 || std::abs(n - m) > max_error)
+            {
+                return std::min(std::abs(n - m), max_error + 1);
+            }
+
+            uint64_t vp[max_blocks];
+            uint64_t vn[max_blocks];
+            int scores[max_blocks];     //score of the last row of each block
+
+            const std::size_t lastBlock = m_blocks - 1;
+            const uint64_t lastBit = uint64_t(1) << ((m - 1) % 64);
+
+            //the first active block, other blocks are started when the band reaches them
+            std::size_t active = 0;
+            vp[0] = ~uint64_t(0);
+            vn[0] = 0;
+            scores[0] = (lastBlock == 0) ? m : 64;
+
+            for (int j = 0; j < n; ++j)
+            {
+                //rows deeper than j + 1 + max_error are out of the band for this column
+                const std::size_t needed = std::min(lastBlock, static_cast<std::size_t>((j + max_error) / 64));
+                while (active < needed)
+                {
+                    //start the next block as if its rows had grown by one from the block above;
+                    //this over estimates cells which are out of the band, and so never matter
+                    ++active;
+                    vp[active] = ~uint64_t(0);
+                    vn[active] = 0;
+                    scores[active] = scores[active - 1] + ((active == lastBlock) ? (m - 64 * static_cast<int>(active)) : 64);
+                }
+
+                const unsigned char symbol = static_cast<unsigned char>(text[j]);
+                int hin = 1;
+                for (std::size_t b = 0; b <= active; ++b)
+                {
+                    uint64_t eq = m_peq[symbol * m_blocks + b];
+                    const uint64_t high = (b == lastBlock) ? lastBit : (uint64_t(1) << 63);
+                    const uint64_t hinNegative = (hin < 0) ? 1 : 0;
+
+                    const uint64_t xv = eq | vn[b];
+                    eq |= hinNegative;
+                    const uint64_t xh = (((eq & vp[b]) + vp[b]) ^ vp[b]) | eq;
+                    uint64_t hp = vn[b] | ~(xh | vp[b]);
+                    uint64_t hn = vp[b] & xh;
+
+                    int hout = 0;
+                    if (hp & high) hout = 1;
+                    if (hn & high) hout = -1;
+                    scores[b] += hout;
+
+                    hp = (hp << 1) | ((hin > 0) ? 1 : 0);
+                    hn = (hn << 1) | hinNegative;
+                    vp[b] = hn | ~(xv | hp);
+                    vn[b] = hp & xv;
+                    hin = hout;
+                }
+
+                //once the last row is computed, each remaining symbol lowers it by one at best
+                if (active == lastBlock && scores[lastBlock] - (n - j - 1) > max_error)
+                {
+                    return max_error + 1;
+                }
+            }
+
+            return (active == lastBlock) ? std::min(scores[lastBlock], max_error + 1) : max_error + 1;
+        };
+
+    private:
+        //! @brief match masks, indexed by byte value then block
+        std::vector<uint64_t> m_peq;
+
+        //! @brief the size of the compiled pattern
+        std::size_t m_size = 0;
+
+        //! @brief the number of blocks of the compiled pattern
+        std::size_t m_blocks = 0;
+    };
+
+    //! @brief compute the Levenshtein distance with the classic two rows dynamic programming,
+    //! used when both words are too long for the bit-vector kernels
+    //! @param a the first word
+    //! @param b the second word
+    //! @return the edit distance (substitution, addition, deletion)
+    inline int levenshtein_distance_dp(const std::string& a, const std::string& b)
+    {
+        std::vector<int> previous(b.size() + 1);
+        std::vector<int> current(b.size() + 1);
+
+        for (std::size_t j = 0; j <= b.size(); ++j)
+        {
+            previous[j] = static_cast<int>(j);
+        }
+
+        for (std::size_t i = 1; i <= a.size(); ++i)
+        {
+            current[0] = static_cast<int>(i);
+            for (std::size_t j = 1; j <= b.size(); ++j)
+            {
+                const int cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+                current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost });
+            }
+            std::swap(previous, current);
+        }
+
+        return previous[b.size()];
+    }
+
+    //! @brief compute the Levenshtein distance between two words, using Myers' bit-vector
+    //! algorithm with one machine word when one of them fits, with blocks otherwise
+    //! @param a the first word
+    //! @param b the second word
+    //! @return the edit distance (substitution, addition, deletion)
+    inline int levenshtein_distance(const std::string& a, const std::string& b)
+    {
+        const std::string& shortest = (a.size() <= b.size()) ? a : b;
+        const std::string& longest = (a.size() <= b.size()) ? b : a;
+
+        if (shortest.size() <= ZDMyersPattern::max_size)
+        {
+            return ZDMyersPattern(shortest).distance(longest);
+        }
+        if (shortest.size() <= ZDMyersBlockPattern::max_size)
+        {
+            return ZDMyersBlockPattern(shortest).distance(longest);
+        }
+        return levenshtein_distance_dp(a, b);
+    }
+
+    //! @brief compute the Levenshtein distance between two words, giving up as soon as it is known
+    //! to exceed a threshold
+    //! @param a the first word
+    //! @param b the second word
+    //! @param max_error the threshold
+    //! @return the edit distance if it is at most max_error, max_error + 1 otherwise
+    inline int levenshtein_distance(const std::string& a, const std::string& b, int max_error)
+    {
+        const std::string& shortest = (a.size() <= b.size()) ? a : b;
+        const std::string& longest = (a.size() <= b.size()) ? b : a;
+
+        if (longest.size() - shortest.size() > static_cast<std::size_t>(std::max(max_error, 0)))
+        {
+            return max_error + 1;
+        }
+        if (shortest.size() <= ZDMyersPattern::max_size)
+        {
+            return ZDMyersPattern(shortest).distance(longest.data(), longest.size(), max_error);
+        }
+        if (shortest.size() <= ZDMyersBlockPattern::max_size)
+        {
+            return ZDMyersBlockPattern(shortest).distance(longest.data(), longest.size(), max_error);
+        }
+        return std::min(levenshtein_distance_dp(a, b), max_error + 1);
+    }
+
+    //! @brief check if two words are within a given number of edits
+    //! @param a the first word
+    //! @param b the second word
+    //! @param max_error the maximum number of errors (substitution, addition, deletion)
+    //! @return true if the edit distance is at most max_error, false otherwise
+    inline bool within_distance(const std::string& a, const std::string& b, int max_error)
+    {
+        return max_error >= 0 && levenshtein_distance(a, b, max_error) <= max_error;
+    }
+
+    //! @brief compute the (unrestricted) Damerau-Levenshtein distance between two words,
+    //! adjacent transpositions count as one error. Unlike the optimal string alignment
+    //! variant this is a true metric, so it can order a BK-tree.
+    //! @param a the first word
+    //! @param b the second word
+    //! @return the edit distance (substitution, addition, deletion, transposition)
+    inline int damerau_distance(const std::string& a, const std::string& b)
+    {
+        const std::size_t rows = a.size() + 2;
+        const std::size_t cols = b.size() + 2;
+        const int infinity = static_cast<int>(a.size() + b.size());
+
+        std::vector<int> d(rows * cols);
+        std::size_t lastRow[256] = { 0 };
+
+        auto at = [&](std::size_t i, std::size_t j) -> int& { return d[i * cols + j]; };
+
+        at(0, 0) = infinity;
+        for (std::size_t i = 0; i <= a.size(); ++i)
+        {
+            at(i + 1, 0) = infinity;
+            at(i + 1, 1) = static_cast<int>(i);
+        }
+        for (std::size_t j = 0; j <= b.size(); ++j)
+        {
+            at(0, j + 1) = infinity;
+            at(1, j + 1) = static_cast<int>(j);
+        }
+
+        for (std::size_t i = 1; i <= a.size(); ++i)
+        {
+            std::size_t lastCol = 0;
+            for (std::size_t j = 1; j <= b.size(); ++j)
+            {
+                const std::size_t i1 = lastRow[static_cast<unsigned char>(b[j - 1])];
+                const std::size_t j1 = lastCol;
+                int cost = 1;
+                if (a[i - 1] == b[j - 1])
+                {
+                    cost = 0;
+                    lastCol = j;
+                }
+
+                at(i + 1, j + 1) = std::min({ at(i, j) + cost,
+                                              at(i + 1, j) + 1,
+                                              at(i, j + 1) + 1,
+                                              at(i1, j1) + static_cast<int>(i - i1 - 1) + 1 + static_cast<int>(j - j1 - 1) });
+            }
+            lastRow[static_cast<unsigned char>(a[i - 1])] = i;
+        }
+
+        return at(a.size() + 1, b.size() + 1);
+    }
+}
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "Distance/ZDEditDistance.h"
+
+namespace Dico
+{
+    //! @brief a node of a flat dictionary tree (see ZDStaticDictionary). The fields are laid out from the largest,
+    //! so a node takes 20 bytes and an array of nodes can be written as a constant in a source file.
+    struct ZDStaticNode
+    {
+        uint32_t first_child;       //!< the index of the first child, the children of a node being next to each other
+        uint32_t words;             //!< the number of words ending on this node or below it
+        uint32_t weight;            //!< the weight of the word ending on this letter, if any
+        uint32_t max_weight;        //!< the highest weight of the words ending on this node or below it
+        uint16_t child_count;       //!< the number of children
+        uint8_t letter;             //!< the letter
+        uint8_t terminal;           //!< 1 if a word of the dictionary ends on this letter
+    };
+
+    //! @brief this class is a read-only view of a dictionary flattened into an array of nodes : the nodes are
+    //! stored breadth first, so the children of a node are next to each other and are reached by index. The
+    //! array is typicaly a constant compiled into the binary (see ZDStaticDictionaryWriter and the generated
+    //! ZDEmbeddedLexico.h), so the view needs no loading : it lives in the read-only pages of the binary,
+    //! shared by the processes running it. The first node is a root with no letter, whose children are the
+    //! roots of the dictionary. The view answers as ZDDictionary does : words are converted to lower case, the
+    //! leading chars which are not a root are skipped. The words are numbered by their alphabetical rank (see
+    //! rank and select), the nodes do not keep the ids of ZDDictionary::word_id.
+    class ZDStaticDictionary
+    {
+    public:
+        //! @brief defaut constructor, no word
+        constexpr ZDStaticDictionary() = default;
+
+        //! @brief build a view of an array of nodes, the array is not copied
+        //! @param nodes the nodes, breadth first, the root with no letter first
+        //! @param count the number of nodes
+        constexpr ZDStaticDictionary(const ZDStaticNode* nodes, std::size_t count)
+            : m_nodes(nodes), m_count(count)
+        {
+        };
+
+        //! @brief find if a word exist in the dictionary
+        //! @param word the word to be found
+        //! @return true if the word is found, false otherwise
+        bool find_word(const std::string& word) const
+        {
+            const ZDStaticNode* node = find_node(to_lower_case_word(word));
+            return node != nullptr && node->terminal != 0;
+        };
+
+        //! @brief find if a word exist in the dictionary, with some errors
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return true if a word is found, false otherwise
+        bool find_word(const std::string& word, int max_error) const
+        {
+            return !find_words(word, max_error).empty();
+        };
+
+        //! @brief find the words of the dictionary close to a given word
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return the found words with their number of errors, by increasing errors
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            const std::string key = to_lower_case_word(word);
+            if (max_error < 0 || m_count == 0)
+            {
+                return result;
+            }
+
+            std::string path;
+            if (key.size() > ZDMyersPattern::max_size)
+            {
+                collect(0, path, [&key, max_error, &result](const std::string& candidate)
+                {
+                    const int errors = levenshtein_distance(key, candidate, max_error);
+                    if (errors <= max_error)
+                    {
+                        result.emplace_back(candidate, errors);
+                    }
+                });
+            }
+            else
+            {
+                const ZDMyersPattern pattern(key);
+                fuzzy(0, pattern, pattern.first_row(), max_error, path, result);
+            }
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            return result;
+        };
+
+        //! @brief get the weight of a word
+        //! @param word the given word
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the word is found, false othserwise
+        //! - uint32_t              : if founded, the weight of the word
+        std::tuple<bool, uint32_t> word_weight(const std::string& word) const
+        {
+            const ZDStaticNode* node = find_node(to_lower_case_word(word));
+            if (node == nullptr || node->terminal == 0)
+            {
+                return std::tuple<bool, uint32_t>(false, 0);
+            }
+            return std::tuple<bool, uint32_t>(true, node->weight);
+        };
+
+        //! @brief get the number of words coming before a given word alphabetically, as ZDDictionary::rank; the
+        //! word needs not be in the dictionary
+        //! @param word the given word
+        //! @return the number of words before it
+        std::size_t rank(const std::string& word) const
+        {
+            const std::string key = skip_to_root(to_lower_case_word(word));
+            if (key.empty())
+            {
+                return 0;
+            }
+
+            std::size_t result = 0;
+            const ZDStaticNode* node = &m_nodes[0];
+            for (const char charr : key)
+            {
+                //the word of the node is a prefix of the word, the previous children hold lower words
+                result += node->terminal;
+
+                //the roots are kept in the order of the tree, the other children are sorted
+                const unsigned char letter = static_cast<unsigned char>(charr);
+                const bool roots = node == &m_nodes[0];
+                const ZDStaticNode* child = m_nodes + node->first_child;
+                const ZDStaticNode* last = child + node->child_count;
+                while (child != last && (roots ? child->letter != letter : child->letter < letter))
+                {
+                    result += child->words;
+                    ++child;
+                }
+                if (child == last || child->letter != letter)
+                {
+                    return result;
+                }
+                node = child;
+            }
+            return result;
+        };
+
+        //! @brief get the word of a given rank, alphabetically, as ZDDictionary::select with no prefix
+        //! @param index the rank of the word
+        //! @return the word, empty if the index is not lower than word_count()
+        std::string select(std::size_t index) const
+        {
+            std::string result;
+            if (index >= word_count())
+            {
+                return result;
+            }
+
+            const ZDStaticNode* node = &m_nodes[0];
+            while (true)
+            {
+                if (node->terminal)
+                {
+                    if (index == 0)
+                    {
+                        break;
+                    }
+                    --index;
+                }
+
+                //skip the children whose words all come before the index
+                node = m_nodes + node->first_child;
+                while (index >= node->words)
+                {
+                    index -= node->words;
+                    ++node;
+                }
+                result.push_back(static_cast<char>(node->letter));
+            }
+            return result;
+        };
+
+        //! @brief count the words starting with a given prefix
+        //! @param prefix the given prefix, empty for the whole dictionary
+        //! @return the number of words
+        std::size_t count_prefix(const std::string& prefix) const
+        {
+            if (prefix.empty())
+            {
+                return word_count();
+            }
+            const ZDStaticNode* node = find_node(to_lower_case_word(prefix));
+            return (node != nullptr) ? node->words : 0;
+        };
+
+        //! @brief find the words of highest weight starting with a given prefix, best first as
+        //! ZDDictionary::complete
+        //! @param prefix the given prefix, empty for the whole dictionary
+        //! @param count the maximum number of words
+        //! @return the words with their weight, by decreasing weight
+        std::vector<std::pair<std::string, uint32_t>> complete(const std::string& prefix, std::size_t count) const
+        {
+            std::vector<std::pair<std::string, uint32_t>> result;
+
+            //an entry is either a subtree ranked by its highest weight, or a word ranked by its weight; the
+            //nodes have no parent, so an entry keeps the chars of its path
+            struct Entry
+            {
+                uint32_t weight;
+                const ZDStaticNode* node;
+                bool word;
+                std::string path;
+
+                bool operator<(const Entry& other) const
+                {
+                    //on equal weights, words come out before subtrees are opened
+                    return weight < other.weight || (weight == other.weight && !word && other.word);
+                }
+            };
+
+            std::priority_queue<Entry> queue;
+            if (m_count == 0)
+            {
+                return result;
+            }
+            if (prefix.empty())
+            {
+                queue.push(Entry{ m_nodes[0].max_weight, &m_nodes[0], false, std::string() });
+            }
+            else
+            {
+                const std::string key = skip_to_root(to_lower_case_word(prefix));
+                if (const ZDStaticNode* node = find_node(key))
+                {
+                    queue.push(Entry{ node->max_weight, node, false, key });
+                }
+            }
+
+            while (!queue.empty() && result.size() < count)
+            {
+                Entry entry = queue.top();
+                queue.pop();
+
+                if (entry.word)
+                {
+                    result.emplace_back(std::move(entry.path), entry.weight);
+                    continue;
+                }
+
+                if (entry.node->terminal)
+                {
+                    queue.push(Entry{ entry.node->weight, entry.node, true, entry.path });
+                }
+                const ZDStaticNode* child = m_nodes + entry.node->first_child;
+                for (const ZDStaticNode* last = child + entry.node->child_count; child != last; ++child)
+                {
+                    if (child->words != 0)
+                    {
+                        queue.push(Entry{ child->max_weight, child, false, entry.path + static_cast<char>(child->letter) });
+                    }
+                }
+            }
+
+            return result;
+        };
+
+        //! @brief get the number of words of the dictionary
+        //! @return
+        std::size_t word_count() const
+        {
+            return (m_count == 0) ? 0 : m_nodes[0].words;
+        };
+
+        //! @brief get the number of nodes, the root with no letter included
+        //! @return
+        std::size_t node_count() const
+        {
+            return m_count;
+        };
+
+        //! @brief get the size of the nodes in bytes
+        //! @return
+        std::size_t byte_size() const
+        {
+            return m_count * sizeof(ZDStaticNode);
+        };
+
+    private:
+        //! @brief skip the leading chars of a word which are not a root, as ZDDictionary::insert_word does
+        //! @param word the given word, already in lower case
+        //! @return the word from its first root char, empty if it holds no root
+        std::string skip_to_root(const std::string& word) const
+        {
+            if (m_count == 0)
+            {
+                return std::string();
+            }
+            const ZDStaticNode* roots = m_nodes + m_nodes[0].first_child;
+            for (std::size_t count = 0; count < word.size(); ++count)
+            {
+                for (uint16_t i = 0; i < m_nodes[0].child_count; ++i)
+                {
+                    if (roots[i].letter == static_cast<unsigned char>(word[count]))
+                    {
+                        return word.substr(count);
+                    }
+                }
+            }
+            return std::string();
+        };
+
+        //! @brief find the node where a word finish, the word being already in lower case
+        //! @param word the given word
+        //! @return the node, null if the word is not a path of the dictionary
+        const ZDStaticNode* find_node(const std::string& word) const
+        {
+            const std::string key = skip_to_root(word);
+            if (key.empty())
+            {
+                return nullptr;
+            }
+
+            const ZDStaticNode* node = &m_nodes[0];
+            for (const char charr : key)
+            {
+                const ZDStaticNode* child = m_nodes + node->first_child;
+                const ZDStaticNode* last = child + node->child_count;
+                while (child != last && child->letter != static_cast<unsigned char>(charr))
+                {
+                    ++child;
+                }
+                if (child == last)
+                {
+                    return nullptr;
+                }
+                node = child;
+            }
+            return node;
+        };
+
+        //! @brief walk the subtree of a node with the DP row of its path, the subtrees too far from the word
+        //! being skipped
+        void fuzzy(uint32_t index, const ZDMyersPattern& pattern, const ZDMyersRow& parentRow, int max_error, std::string& path,
+            std::vector<std::pair<std::string, int>>& result) const
+        {
+            const ZDStaticNode& node = m_nodes[index];
+            for (uint32_t child = node.first_child; child != node.first_child + node.child_count; ++child)
+            {
+                const ZDMyersRow row = pattern.advance(parentRow, static_cast<char>(m_nodes[child].letter));
+                if (pattern.minimum(row, max_error) > max_error)
+                {
+                    continue;
+                }
+
+                path.push_back(static_cast<char>(m_nodes[child].letter));
+                if (m_nodes[child].terminal && row.score <= max_error)
+                {
+                    result.emplace_back(path, row.score);
+                }
+                fuzzy(child, pattern, row, max_error, path, result);
+                path.pop_back();
+            }
+        };
+
+        //! @brief call a function with each word of the subtree of a node
+        template<class Visitor>
+        void collect(uint32_t index, std::string& path, Visitor visitor) const
+        {
+            const ZDStaticNode& node = m_nodes[index];
+            if (node.terminal)
+            {
+                visitor(path);
+            }
+            for (uint32_t child = node.first_child; child != node.first_child + node.child_count; ++child)
+            {
+                path.push_back(static_cast<char>(m_nodes[child].letter));
+                collect(child, path, visitor);
+                path.pop_back();
+            }
+        };
+
+        //! @brief convert from upper case string to lower case string, string sould we ansi
+        static inline std::string to_lower_case_word(const std::string& upperCase)
+        {
+            std::string lowerCase(upperCase);
+            std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
+            return lowerCase;
+        };
+
+        //! @brief the nodes, breadth first
+        const ZDStaticNode* m_nodes = nullptr;
+
+        //! @brief the number of nodes
+        std::size_t m_count = 0;
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include "ZDDictionary.h"
+#include "Embed/ZDStaticDictionary.h"
+
+namespace Dico
+{
+    //! @brief this class flattens a dictionary into the nodes of a ZDStaticDictionary, and writes them as a C++
+    //! source file holding a constant array and its view, with a header declaring the view. It is run at build
+    //! time by DictionaryEmbed, so a tool using a fixed lexicon reads it from its binary instead of loading it.
+    class ZDStaticDictionaryWriter
+    {
+    public:
+        //! @brief flatten the tree of a dictionary, breadth first
+        //! @param dictionary the given dictionary
+        //! @return the nodes, the root with no letter first
+        static std::vector<ZDStaticNode> flatten(const ZDDictionary& dictionary)
+        {
+            const ZDDictionaryTree& tree = dictionary.m_internalTree;
+
+            //the tree nodes in the order of the array, null for the root with no letter
+            std::vector<const TreeNode<ZDNodeData>*> order(1, nullptr);
+            std::vector<ZDStaticNode> result;
+
+            for (std::size_t index = 0; index < order.size(); ++index)
+            {
+                const TreeNode<ZDNodeData>* node = order[index];
+                ZDStaticNode flat = ZDStaticNode();
+                flat.first_child = static_cast<uint32_t>(order.size());
+
+                const TreeNode<ZDNodeData>* child = (node == nullptr) ? tree.head->next_sibling : node->first_child;
+                const TreeNode<ZDNodeData>* end = (node == nullptr) ? tree.feet : nullptr;
+                for (; child != end; child = child->next_sibling)
+                {
+                    order.push_back(child);
+                    ++flat.child_count;
+                    if (node == nullptr)
+                    {
+                        flat.words += child->data.words;
+                        flat.max_weight = std::max(flat.max_weight, child->data.max_weight);
+                    }
+                }
+
+                if (node != nullptr)
+                {
+                    flat.words = node->data.words;
+                    flat.weight = node->data.terminal ? node->data.weight : 0;
+                    flat.max_weight = node->data.max_weight;
+                    flat.letter = static_cast<uint8_t>(node->data.letter);
+                    flat.terminal = node->data.terminal ? 1 : 0;
+                }
+                result.push_back(flat);
+            }
+            return result;
+        };
+
+        //! @brief write a dictionary as a source file and its header
+        //! @param dictionary the given dictionary
+        //! @param source the stream of the source file, defining the nodes and the view
+        //! @param header the stream of the header, declaring the view
+        //! @param name the name of the view, in the namespace Dico
+        //! @param headerName the name the source file includes the header by
+        //! @return true if succes, false otherwise
+        static bool write(const ZDDictionary& dictionary, std::ostream& source, std::ostream& header, const std::string& name,
+            const std::string& headerName)
+        {
+            const std::vector<ZDStaticNode> nodes = flatten(dictionary);
+
+            header << "// generated by DictionaryEmbed, do not edit\n"
+                << "#pragma once\n\n"
+                << "#include \"Embed/ZDStaticDictionary.h\"\n\n"
+                << "namespace Dico\n{\n"
+                << "    //! @brief the dictionary compiled into the binary, " << nodes[0].words << " words\n"
+                << "    extern const ZDStaticDictionary " << name << ";\n"
+                << "}\n";
+
+            source << "// generated by DictionaryEmbed, do not edit\n"
+                << "#include \"" << headerName << "\"\n\n"
+                << "namespace Dico\n{\n"
+                << "    namespace\n    {\n"
+                << "        //first_child, words, weight, max_weight, child_count, letter, terminal\n"
+                << "        const ZDStaticNode " << name << "_nodes[" << nodes.size() << "] =\n        {\n";
+            for (std::size_t i = 0; i < nodes.size(); ++i)
+            {
+                const ZDStaticNode& node = nodes[i];
+                source << ((i % nodes_per_line == 0) ? "            " : " ")
+                    << '{' << node.first_child << ',' << node.words << ',' << node.weight << ',' << node.max_weight << ','
+                    << node.child_count << ',' << static_cast<unsigned int>(node.letter) << ',' << static_cast<unsigned int>(node.terminal) << "},"
+                    << ((i % nodes_per_line == nodes_per_line - 1 || i + 1 == nodes.size()) ? "\n" : "");
+            }
+            source << "        };\n    }\n\n"
+                << "    const ZDStaticDictionary " << name << "(" << name << "_nodes, " << nodes.size() << ");\n"
+                << "}\n";
+
+            return static_cast<bool>(source) && static_cast<bool>(header);
+        };
+
+        //! @brief write a dictionary as a source file and its header, given by path; the source file includes the
+        //! header by its file name, so both are expected in the same directory
+        //! @param dictionary the given dictionary
+        //! @param sourceFile the path of the source file, replaced
+        //! @param headerFile the path of the header, replaced
+        //! @param name the name of the view, in the namespace Dico
+        //! @return true if succes, false otherwise
+        static bool write(const ZDDictionary& dictionary, const std::string& sourceFile, const std::string& headerFile, const std::string& name)
+        {
+            std::ofstream source(sourceFile);
+            std::ofstream header(headerFile);
+            const std::size_t slash = headerFile.find_last_of("/\\");
+            const std::string headerName = (slash == std::string::npos) ? headerFile : headerFile.substr(slash + 1);
+            return source.is_open() && header.is_open() && write(dictionary, source, header, name, headerName);
+        };
+
+    private:
+        //! @brief the number of nodes written on a line of the source file
+        static constexpr std::size_t nodes_per_line = 8;
+    };
+}
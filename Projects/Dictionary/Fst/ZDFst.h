@@ -0,0 +1,523 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include "Serialization/ZDBinaryIO.h"
+
+namespace Dico
+{
+    //! @brief this class is a minimal acyclic finite state transducer mapping words to integers : the words share
+    //! their prefixes and their suffixes, and the output of a word is the sum of the outputs of the arcs of its path
+    //! and of the output of its final state. Outputs are pushed as close to the start state as possible, so the
+    //! states near the ends of the words carry none and can be shared.
+    //! The transducer is read-only and stored in one byte array : each state is a varint (number of arcs * 2 +
+    //! final), the varint output of the state if final, then for each arc its byte, its varint output and the
+    //! varint offset of its target state. It is built by ZDFstBuilder.
+    //! Words are converted to lower case, like in ZDDictionary.
+    class ZDFst
+    {
+    public:
+        //! @brief defaut constructor, no word
+        ZDFst() = default;
+
+        //! @brief find the output of a word, in one walk
+        //! @param word the word to be found
+        //! @param output the output of the word, if found
+        //! @return true if the word is found, false otherwise
+        bool find_word(const std::string& word, uint64_t& output) const
+        {
+            if (m_bytes.empty())
+            {
+                return false;
+            }
+
+            std::size_t position = m_root;
+            uint64_t sum = 0;
+            for (const char c : word)
+            {
+                const uint8_t symbol = static_cast<uint8_t>(::tolower(c));
+                const uint64_t header = read_varint(position);
+                if (header & 1)
+                {
+                    read_varint(position);
+                }
+
+                //the arcs are sorted by byte
+                bool found = false;
+                for (uint64_t arc = header >> 1; arc != 0; --arc)
+                {
+                    const uint8_t label = m_bytes[position++];
+                    const uint64_t arcOutput = read_varint(position);
+                    const uint64_t target = read_varint(position);
+                    if (label == symbol)
+                    {
+                        sum += arcOutput;
+                        position = static_cast<std::size_t>(target);
+                        found = true;
+                        break;
+                    }
+                    if (label > symbol)
+                    {
+                        break;
+                    }
+                }
+                if (!found)
+                {
+                    return false;
+                }
+            }
+
+            const uint64_t header = read_varint(position);
+            if ((header & 1) == 0)
+            {
+                return false;
+            }
+            output = sum + read_varint(position);
+            return true;
+        };
+
+        //! @brief find if a word exist in the transducer
+        //! @param word the word to be found
+        //! @return true if the word is found, false otherwise
+        bool find_word(const std::string& word) const
+        {
+            uint64_t output = 0;
+            return find_word(word, output);
+        };
+
+        //! @brief call a function with each word and its output, in alphabetical order
+        //! @param visitor called with the word and its output
+        template<class Visitor>
+        void for_each(Visitor visitor) const
+        {
+            if (!m_bytes.empty())
+            {
+                std::string word;
+                visit(m_root, 0, word, visitor);
+            }
+        };
+
+        //! @brief get the number of words
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_words;
+        };
+
+        //! @brief get the size of the transducer in bytes
+        //! @return
+        std::size_t byte_size() const
+        {
+            return m_bytes.size();
+        };
+
+        //! @brief write the transducer to a binary stream
+        //! @param out the given stream
+        //! @return true if succes, false otherwise
+        bool save(std::ostream& out) const
+        {
+            write_header(out, file_magic, file_version);
+            write_pod(out, static_cast<uint64_t>(m_root));
+            write_pod(out, static_cast<uint64_t>(m_words));
+            write_string(out, m_bytes);
+            return static_cast<bool>(out);
+        };
+
+        //! @brief read a transducer written by save, the current one is replaced
+        //! @param in the given stream
+        //! @return true if succes, false otherwise
+        bool load(std::istream& in)
+        {
+            uint64_t root = 0;
+            uint64_t words = 0;
+            std::string bytes;
+            if (!read_header(in, file_magic, file_version) || !read_pod(in, root) || !read_pod(in, words) || !read_string(in, bytes)
+                || !valid(bytes, root, words))
+            {
+                return false;
+            }
+            m_root = static_cast<std::size_t>(root);
+            m_words = static_cast<std::size_t>(words);
+            m_bytes.swap(bytes);
+            return true;
+        };
+
+        //! @brief write the transducer to a given path file
+        //! @param outputFile the given path file
+        //! @return true if succes, false otherwise
+        bool save(const std::string& outputFile) const
+        {
+            std::ofstream file(outputFile, std::ios::binary);
+            return file.is_open() && save(file);
+        };
+
+        //! @brief read the transducer from a given path file
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool load(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile, std::ios::binary);
+            return file.is_open() && load(file);
+        };
+
+        //! @brief the longest word of a transducer
+        static constexpr std::size_t max_word = 1 << 12;
+
+    private:
+        friend class ZDFstBuilder;
+
+        //! @brief the file type and version of the binary format
+        static constexpr char file_magic[5] = "ZDFS";
+        static constexpr uint32_t file_version = 1;
+
+        //! @brief check the states read from a file, so that no walk reads out of them nor loops : the byte array
+        //! is a sequence of whole states, each arc has a byte greater than the previous one and targets a state
+        //! written before its own, the root is a state, and the paths from it are the given number of words, none
+        //! longer than max_word
+        static bool valid(const std::string& bytes, uint64_t root, uint64_t words)
+        {
+            if (bytes.empty())
+            {
+                return root == 0 && words == 0;
+            }
+
+            //the offset of each state, the number of words and the longest word reachable from it
+            std::vector<uint64_t> offsets;
+            std::vector<uint64_t> counts;
+            std::vector<std::size_t> depths;
+            std::size_t position = 0;
+            while (position < bytes.size())
+            {
+                const uint64_t offset = position;
+                uint64_t header = 0;
+                uint64_t value = 0;
+                if (!read_varint(bytes, position, header) || ((header & 1) && !read_varint(bytes, position, value)) || (header >> 1) > 256)
+                {
+                    return false;
+                }
+
+                uint64_t count = header & 1;
+                std::size_t depth = 0;
+                int previous = -1;
+                for (uint64_t arc = header >> 1; arc != 0; --arc)
+                {
+                    uint64_t target = 0;
+                    if (position >= bytes.size())
+                    {
+                        return false;
+                    }
+                    const int label = static_cast<uint8_t>(bytes[position++]);
+                    if (label <= previous || !read_varint(bytes, position, value) || !read_varint(bytes, position, target) || target >= offset)
+                    {
+                        return false;
+                    }
+                    const auto state = std::lower_bound(offsets.begin(), offsets.end(), target);
+                    if (state == offsets.end() || *state != target)
+                    {
+                        return false;
+                    }
+                    const std::size_t index = static_cast<std::size_t>(state - offsets.begin());
+                    count = std::min(count + counts[index], words + 1);
+                    depth = std::max(depth, depths[index] + 1);
+                    previous = label;
+                }
+                if (depth > max_word)
+                {
+                    return false;
+                }
+                offsets.push_back(offset);
+                counts.push_back(count);
+                depths.push_back(depth);
+            }
+
+            const auto state = std::lower_bound(offsets.begin(), offsets.end(), root);
+            return state != offsets.end() && *state == root && counts[static_cast<std::size_t>(state - offsets.begin())] == words;
+        };
+
+        //! @brief read a varint of a byte array, checking its bounds
+        //! @param position the offset of the varint, moved after it
+        //! @return false if the varint goes past the end of the array or past 64 bits
+        static bool read_varint(const std::string& bytes, std::size_t& position, uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && position < bytes.size(); shift += 7)
+            {
+                const uint8_t byte = static_cast<uint8_t>(bytes[position++]);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        //! @brief read a varint of the byte array
+        //! @param position the offset of the varint, moved after it
+        uint64_t read_varint(std::size_t& position) const
+        {
+            uint64_t value = 0;
+            int shift = 0;
+            uint8_t byte = 0;
+            do
+            {
+                byte = static_cast<uint8_t>(m_bytes[position++]);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            return value;
+        };
+
+        //! @brief enumerate the words reachable from a state
+        template<class Visitor>
+        void visit(std::size_t position, uint64_t sum, std::string& word, Visitor& visitor) const
+        {
+            const uint64_t header = read_varint(position);
+            if (header & 1)
+            {
+                visitor(static_cast<const std::string&>(word), sum + read_varint(position));
+            }
+            for (uint64_t arc = header >> 1; arc != 0; --arc)
+            {
+                const char label = m_bytes[position++];
+                const uint64_t arcOutput = read_varint(position);
+                const uint64_t target = read_varint(position);
+                word.push_back(label);
+                visit(static_cast<std::size_t>(target), sum + arcOutput, word, visitor);
+                word.pop_back();
+            }
+        };
+
+        //! @brief the states, the start state at m_root
+        std::string m_bytes;
+        std::size_t m_root = 0;
+
+        //! @brief the number of words
+        std::size_t m_words = 0;
+    };
+
+    //! @brief this class builds a ZDFst from words given in increasing order (Daciuk and Mihov's incremental
+    //! algorithm, with outputs) : only the states of the path of the last word are kept open, and a state is
+    //! written, or merged with an equal state already written, as soon as no later word can reach it.
+    class ZDFstBuilder
+    {
+    public:
+        //! @brief defaut constructor, no word
+        ZDFstBuilder()
+        {
+            m_frontier.resize(1);
+        };
+
+        //! @brief add a word, greater than the previous one
+        //! @param word the given word, converted to lower case
+        //! @param output the output of the word
+        //! @return true if succes, false if the word is empty, longer than ZDFst::max_word or not greater than the
+        //! previous one
+        bool add(const std::string& word, uint64_t output)
+        {
+            std::string key(word);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            if (key.empty() || key.size() > ZDFst::max_word || (m_words != 0 && key <= m_previous))
+            {
+                return false;
+            }
+
+            std::size_t common = 0;
+            while (common < m_previous.size() && m_previous[common] == key[common])
+            {
+                ++common;
+            }
+
+            //the states of the previous word beyond the common prefix can not be reached anymore
+            freeze(common);
+
+            m_frontier.resize(key.size() + 1);
+            for (std::size_t depth = common; depth < key.size(); ++depth)
+            {
+                m_frontier[depth].arcs.push_back(Arc{ static_cast<uint8_t>(key[depth]), 0, 0 });
+            }
+            m_frontier[key.size()].final = true;
+
+            //keep on the shared arcs the part of the output common to all their words, push the rest further
+            for (std::size_t depth = 0; depth < common; ++depth)
+            {
+                Arc& arc = m_frontier[depth].arcs.back();
+                const uint64_t shared = std::min(arc.output, output);
+                const uint64_t rest = arc.output - shared;
+                arc.output = shared;
+                output -= shared;
+                if (rest != 0)
+                {
+                    State& next = m_frontier[depth + 1];
+                    for (auto& nextArc : next.arcs)
+                    {
+                        nextArc.output += rest;
+                    }
+                    if (next.final)
+                    {
+                        next.output += rest;
+                    }
+                }
+            }
+            m_frontier[common].arcs.back().output = output;
+
+            m_previous.swap(key);
+            ++m_words;
+            return true;
+        };
+
+        //! @brief write the open states and get the transducer; the builder is then empty
+        //! @return
+        ZDFst finish()
+        {
+            freeze(0);
+            ZDFst result;
+            result.m_root = write(m_frontier[0]);
+            result.m_words = m_words;
+            result.m_bytes.swap(m_bytes);
+
+            m_frontier.assign(1, State());
+            m_registry.clear();
+            m_previous.clear();
+            m_words = 0;
+            return result;
+        };
+
+        //! @brief build a transducer from words in any order
+        //! @param words the words and their outputs; for a word given several times, the first output is kept
+        //! @return
+        static ZDFst build(std::vector<std::pair<std::string, uint64_t>> words)
+        {
+            for (auto& word : words)
+            {
+                std::transform(word.first.begin(), word.first.end(), word.first.begin(), ::tolower);
+            }
+            std::stable_sort(words.begin(), words.end(), [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b)
+            {
+                return a.first < b.first;
+            });
+
+            ZDFstBuilder builder;
+            for (const auto& word : words)
+            {
+                builder.add(word.first, word.second);
+            }
+            return builder.finish();
+        };
+
+        //! @brief build a transducer from a file of "word<TAB>output" lines, sorted or not
+        //! @param inputFile the given path file
+        //! @param fst the built transducer
+        //! @return true if succes, false if the file can not be read
+        static bool build(const std::string& inputFile, ZDFst& fst)
+        {
+            std::ifstream file(inputFile);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            std::vector<std::pair<std::string, uint64_t>> words;
+            std::string line;
+            while (std::getline(file, line))
+            {
+                const std::size_t tab = line.find('\t');
+                const uint64_t output = (tab != std::string::npos) ? std::strtoull(line.c_str() + tab + 1, nullptr, 10) : 0;
+                words.emplace_back(line.substr(0, tab), output);
+            }
+            fst = build(std::move(words));
+            return true;
+        };
+
+    private:
+        //! @brief an arc of an open state, the target being written already except for the last arc
+        struct Arc
+        {
+            uint8_t label;
+            uint64_t output;
+            uint64_t target;
+        };
+
+        //! @brief an open state
+        struct State
+        {
+            std::vector<Arc> arcs;
+            bool final = false;
+            uint64_t output = 0;
+        };
+
+        //! @brief write the open states deeper than a depth, each one being the target of the last arc of the
+        //! state before it
+        void freeze(std::size_t depth)
+        {
+            for (std::size_t open = m_previous.size(); open > depth; --open)
+            {
+                m_frontier[open - 1].arcs.back().target = write(m_frontier[open]);
+                m_frontier[open] = State();
+            }
+        };
+
+        //! @brief write a state, or find the equal state already written
+        //! @return the offset of the state
+        uint64_t write(const State& state)
+        {
+            std::string& encoded = m_encoded;
+            encoded.clear();
+            append_varint(encoded, (static_cast<uint64_t>(state.arcs.size()) << 1) | (state.final ? 1 : 0));
+            if (state.final)
+            {
+                append_varint(encoded, state.output);
+            }
+            for (const auto& arc : state.arcs)
+            {
+                encoded.push_back(static_cast<char>(arc.label));
+                append_varint(encoded, arc.output);
+                append_varint(encoded, arc.target);
+            }
+
+            const auto found = m_registry.find(encoded);
+            if (found != m_registry.end())
+            {
+                return found->second;
+            }
+            const uint64_t offset = m_bytes.size();
+            m_bytes += encoded;
+            m_registry.emplace(encoded, offset);
+            return offset;
+        };
+
+        //! @brief append a varint to a buffer
+        static void append_varint(std::string& buffer, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            buffer.push_back(static_cast<char>(value));
+        };
+
+        //! @brief the open states, one per prefix of the last word
+        std::vector<State> m_frontier;
+
+        //! @brief the last word added
+        std::string m_previous;
+
+        //! @brief the states written, and their offsets by encoding
+        std::string m_bytes;
+        std::unordered_map<std::string, uint64_t> m_registry;
+
+        //! @brief the encoding of the state being written, kept to reuse its memory
+        std::string m_encoded;
+
+        //! @brief the number of words
+        std::size_t m_words = 0;
+    };
+}
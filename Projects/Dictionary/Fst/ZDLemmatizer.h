@@ -0,0 +1,231 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+#include "Fst/ZDFst.h"
+#include "Serialization/ZDBinaryIO.h"
+
+namespace Dico
+{
+    //! @brief this class maps inflected forms to their lemmas ("mangeons" -> "manger") with a ZDFst : the output
+    //! of a form is the index of its lemma in a sorted table of lemmas, times two. A form having several lemmas
+    //! ("suis" -> "être", "suivre") gets instead the index of its set of lemmas, times two plus one.
+    //! Forms are converted to lower case, like in ZDDictionary.
+    class ZDLemmatizer
+    {
+    public:
+        //! @brief defaut constructor, no form
+        ZDLemmatizer() = default;
+
+        //! @brief build the lemmatizer from a file of "form<TAB>lemma" lines, in any order
+        //! @param inputFile the given path file
+        //! @return true if succes, false if the file can not be read
+        bool read(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            std::vector<std::pair<std::string, std::string>> forms;
+            std::string line;
+            while (std::getline(file, line))
+            {
+                const std::size_t tab = line.find('\t');
+                if (tab != std::string::npos)
+                {
+                    forms.emplace_back(line.substr(0, tab), line.substr(tab + 1));
+                }
+            }
+            build(std::move(forms));
+            return true;
+        };
+
+        //! @brief build the lemmatizer from forms and their lemmas, in any order
+        //! @param forms the forms and their lemmas, a form may be given once per lemma
+        void build(std::vector<std::pair<std::string, std::string>> forms)
+        {
+            for (auto& form : forms)
+            {
+                std::transform(form.first.begin(), form.first.end(), form.first.begin(), ::tolower);
+            }
+            std::sort(forms.begin(), forms.end());
+            forms.erase(std::unique(forms.begin(), forms.end()), forms.end());
+
+            //the table of lemmas
+            std::vector<std::string> lemmas;
+            lemmas.reserve(forms.size());
+            for (const auto& form : forms)
+            {
+                lemmas.push_back(form.second);
+            }
+            std::sort(lemmas.begin(), lemmas.end());
+            lemmas.erase(std::unique(lemmas.begin(), lemmas.end()), lemmas.end());
+            m_lemmas.clear();
+            m_lemmaOffsets.assign(1, 0);
+            for (const auto& lemma : lemmas)
+            {
+                m_lemmas += lemma;
+                m_lemmaOffsets.push_back(static_cast<uint32_t>(m_lemmas.size()));
+            }
+
+            //the forms, in order, each with its lemma or its set of lemmas
+            m_setOffsets.assign(1, 0);
+            m_setLemmas.clear();
+            std::map<std::vector<uint32_t>, uint32_t> sets;
+            ZDFstBuilder builder;
+            for (std::size_t first = 0; first < forms.size();)
+            {
+                std::vector<uint32_t> ids;
+                std::size_t last = first;
+                for (; last < forms.size() && forms[last].first == forms[first].first; ++last)
+                {
+                    ids.push_back(static_cast<uint32_t>(std::lower_bound(lemmas.begin(), lemmas.end(), forms[last].second) - lemmas.begin()));
+                }
+
+                uint64_t output = static_cast<uint64_t>(ids[0]) << 1;
+                if (ids.size() > 1)
+                {
+                    const auto found = sets.emplace(ids, static_cast<uint32_t>(sets.size()));
+                    if (found.second)
+                    {
+                        m_setLemmas.insert(m_setLemmas.end(), ids.begin(), ids.end());
+                        m_setOffsets.push_back(static_cast<uint32_t>(m_setLemmas.size()));
+                    }
+                    output = (static_cast<uint64_t>(found.first->second) << 1) | 1;
+                }
+                builder.add(forms[first].first, output);
+                first = last;
+            }
+            m_fst = builder.finish();
+        };
+
+        //! @brief find the lemmas of a form
+        //! @param form the given form
+        //! @return the lemmas of the form, sorted; empty if the form is unknown
+        std::vector<std::string> lemmas(const std::string& form) const
+        {
+            std::vector<std::string> result;
+            uint64_t output = 0;
+            if (!m_fst.find_word(form, output))
+            {
+                return result;
+            }
+            if ((output & 1) == 0)
+            {
+                result.push_back(lemma(static_cast<uint32_t>(output >> 1)));
+                return result;
+            }
+            const uint64_t set = output >> 1;
+            for (uint32_t i = m_setOffsets[set]; i < m_setOffsets[set + 1]; ++i)
+            {
+                result.push_back(lemma(m_setLemmas[i]));
+            }
+            return result;
+        };
+
+        //! @brief find the first lemma of a form
+        //! @param form the given form
+        //! @param result the first lemma of the form, alphabetically
+        //! @return true if the form is known, false otherwise
+        bool lemma(const std::string& form, std::string& result) const
+        {
+            uint64_t output = 0;
+            if (!m_fst.find_word(form, output))
+            {
+                return false;
+            }
+            result = lemma((output & 1) ? m_setLemmas[m_setOffsets[output >> 1]] : static_cast<uint32_t>(output >> 1));
+            return true;
+        };
+
+        //! @brief get the number of forms
+        //! @return
+        std::size_t form_count() const
+        {
+            return m_fst.word_count();
+        };
+
+        //! @brief get the number of lemmas
+        //! @return
+        std::size_t lemma_count() const
+        {
+            return m_lemmaOffsets.size() - 1;
+        };
+
+        //! @brief get the size of the lemmatizer in bytes, the transducer and the tables
+        //! @return
+        std::size_t byte_size() const
+        {
+            return m_fst.byte_size() + m_lemmas.size() + sizeof(uint32_t) * (m_lemmaOffsets.size() + m_setOffsets.size() + m_setLemmas.size());
+        };
+
+        //! @brief write the lemmatizer to a binary stream
+        //! @param out the given stream
+        //! @return true if succes, false otherwise
+        bool save(std::ostream& out) const
+        {
+            write_header(out, file_magic, file_version);
+            write_string(out, m_lemmas);
+            write_vector(out, m_lemmaOffsets);
+            write_vector(out, m_setOffsets);
+            write_vector(out, m_setLemmas);
+            return m_fst.save(out);
+        };
+
+        //! @brief read a lemmatizer written by save, the current one is replaced
+        //! @param in the given stream
+        //! @return true if succes, false otherwise
+        bool load(std::istream& in)
+        {
+            return read_header(in, file_magic, file_version) && read_string(in, m_lemmas) && read_vector(in, m_lemmaOffsets)
+                && read_vector(in, m_setOffsets) && read_vector(in, m_setLemmas) && m_fst.load(in);
+        };
+
+        //! @brief write the lemmatizer to a given path file
+        //! @param outputFile the given path file
+        //! @return true if succes, false otherwise
+        bool save(const std::string& outputFile) const
+        {
+            std::ofstream file(outputFile, std::ios::binary);
+            return file.is_open() && save(file);
+        };
+
+        //! @brief read the lemmatizer from a given path file
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool load(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile, std::ios::binary);
+            return file.is_open() && load(file);
+        };
+
+    private:
+        //! @brief the file type and version of the binary format
+        static constexpr char file_magic[5] = "ZDLM";
+        static constexpr uint32_t file_version = 1;
+
+        //! @brief get a lemma of the table
+        std::string lemma(uint32_t id) const
+        {
+            return m_lemmas.substr(m_lemmaOffsets[id], m_lemmaOffsets[id + 1] - m_lemmaOffsets[id]);
+        };
+
+        //! @brief the lemmas, sorted and put end to end, and the offset of each one
+        std::string m_lemmas;
+        std::vector<uint32_t> m_lemmaOffsets = std::vector<uint32_t>(1, 0);
+
+        //! @brief the sets of lemmas of the forms having several ones, put end to end, and the offset of each set
+        std::vector<uint32_t> m_setOffsets = std::vector<uint32_t>(1, 0);
+        std::vector<uint32_t> m_setLemmas;
+
+        //! @brief the forms, and their lemma or set of lemmas
+        ZDFst m_fst;
+    };
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+namespace Dico
+{
+    //! @brief this class indexes a list of words by their sorted letters signature ("maison" -> "aimnos"),
+    //! to answer anagram queries ("which words use exactly these letters") and sub-anagram queries
+    //! ("which words use at most these letters", a rack of a word game).
+    //! Words are sorted by signature, so the anagrams of a signature are a contiguous range of word
+    //! ids. The signatures are stored in a flat trie over sorted letters : the children of a node are
+    //! contiguous and sorted, and each node knows the range of words whose signature ends on it.
+    class ZDAnagramIndex
+    {
+    public:
+        //! @brief the char standing for a blank tile in a rack, it can replace any letter
+        static constexpr char blank = '?';
+
+        //! @brief defaut constructor
+        ZDAnagramIndex() = default;
+
+        //! @brief build the index from a list of words (typicaly Lexico::getWords()), words are
+        //! converted to lower case and duplicates are ignored
+        //! @param words the given words
+        void build(const std::vector<std::string>& words)
+        {
+            m_nodes.clear();
+            m_offsets.clear();
+            m_pool.clear();
+
+            std::vector<std::pair<std::string, std::string>> entries;
+            entries.reserve(words.size());
+            for (const auto& word : words)
+            {
+                std::string lower = to_lower_case_word(word);
+                entries.emplace_back(signature(lower), lower);
+            }
+            //std::string orders its chars as unsigned char, as signature and find_child do
+            std::sort(entries.begin(), entries.end());
+            entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+            //the words, in signature order; signatures are kept aside for the build only
+            std::vector<std::string> signatures;
+            signatures.reserve(entries.size());
+            m_offsets.reserve(entries.size() + 1);
+            for (auto& entry : entries)
+            {
+                m_offsets.push_back(static_cast<uint32_t>(m_pool.size()));
+                m_pool += entry.second;
+                signatures.push_back(std::move(entry.first));
+            }
+            m_offsets.push_back(static_cast<uint32_t>(m_pool.size()));
+            entries.clear();
+            entries.shrink_to_fit();
+
+            //build the trie breadth first : the words of a node share its depth first letters, they are
+            //split by their next letter, the words ending on the node coming first
+            struct Task
+            {
+                uint32_t node;
+                uint32_t begin;
+                uint32_t end;
+                uint32_t depth;
+            };
+
+            std::vector<Task> tasks;
+            m_nodes.push_back(Node{ 0, 0, 0, 0, 0 });
+            tasks.push_back(Task{ 0, 0, static_cast<uint32_t>(signatures.size()), 0 });
+
+            for (std::size_t t = 0; t < tasks.size(); ++t)
+            {
+                const Task task = tasks[t];
+
+                uint32_t i = task.begin;
+                while (i < task.end && signatures[i].size() == task.depth)
+                {
+                    ++i;
+                }
+                m_nodes[task.node].word_begin = task.begin;
+                m_nodes[task.node].word_end = i;
+                m_nodes[task.node].first_child = static_cast<uint32_t>(m_nodes.size());
+
+                while (i < task.end)
+                {
+                    const char letter = signatures[i][task.depth];
+                    uint32_t groupEnd = i;
+                    while (groupEnd < task.end && signatures[groupEnd][task.depth] == letter)
+                    {
+                        ++groupEnd;
+                    }
+
+                    tasks.push_back(Task{ static_cast<uint32_t>(m_nodes.size()), i, groupEnd, task.depth + 1 });
+                    m_nodes.push_back(Node{ letter, 0, 0, 0, 0 });
+                    i = groupEnd;
+                }
+
+                m_nodes[task.node].child_count = static_cast<uint32_t>(m_nodes.size()) - m_nodes[task.node].first_child;
+            }
+        };
+
+        //! @brief find the words using exactly the given letters
+        //! @param letters the given letters, in any order
+        //! @return the ids of the words, a contiguous range
+        std::vector<uint32_t> find_anagram_ids(const std::string& letters) const
+        {
+            std::vector<uint32_t> result;
+            if (m_nodes.empty())
+            {
+                return result;
+            }
+
+            const std::string key = signature(to_lower_case_word(letters));
+            const Node* node = &m_nodes[0];
+            for (auto letter : key)
+            {
+                node = find_child(*node, letter);
+                if (node == 0)
+                {
+                    return result;
+                }
+            }
+
+            for (uint32_t id = node->word_begin; id < node->word_end; ++id)
+            {
+                result.push_back(id);
+            }
+            return result;
+        };
+
+        //! @brief find the words using exactly the given letters
+        //! @param letters the given letters, in any order
+        //! @return the words
+        std::vector<std::string> find_anagrams(const std::string& letters) const
+        {
+            return words(find_anagram_ids(letters));
+        };
+
+        //! @brief find the words using at most the given letters, each letter being used at most as many
+        //! times as it appears; a blank ('?') can replace any letter
+        //! @param letters the given letters (the rack), in any order
+        //! @param min_size the minimum size of the words
+        //! @return the ids of the words, by increasing signature
+        std::vector<uint32_t> find_sub_anagram_ids(const std::string& letters, std::size_t min_size = 1) const
+        {
+            std::vector<uint32_t> result;
+            if (m_nodes.empty())
+            {
+                return result;
+            }
+
+            int counts[256] = { 0 };
+            int blanks = 0;
+            for (auto letter : to_lower_case_word(letters))
+            {
+                if (letter == blank)
+                {
+                    ++blanks;
+                }
+                else
+                {
+                    ++counts[static_cast<unsigned char>(letter)];
+                }
+            }
+
+            collect(m_nodes[0], 0, counts, blanks, min_size, result);
+            return result;
+        };
+
+        //! @brief find the words using at most the given letters, each letter being used at most as many
+        //! times as it appears; a blank ('?') can replace any letter
+        //! @param letters the given letters (the rack), in any order
+        //! @param min_size the minimum size of the words
+        //! @return the words
+        std::vector<std::string> find_sub_anagrams(const std::string& letters, std::size_t min_size = 1) const
+        {
+            return words(find_sub_anagram_ids(letters, min_size));
+        };
+
+        //! @brief get the number of words in the index
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+        };
+
+        //! @brief get a word of the index from its id
+        //! @param id the id of the word, in [0, word_count())
+        //! @return
+        std::string word(uint32_t id) const
+        {
+            return m_pool.substr(m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+        };
+
+        //! @brief compute the signature of a word : its letters, sorted as unsigned bytes, so that accented
+        //! letters come after the plain ones, as in the trie
+        //! @param word the given word
+        //! @return
+        static inline std::string signature(std::string word)
+        {
+            std::sort(word.begin(), word.end(), less);
+            return word;
+        };
+
+    private:
+
+        //! @brief a node of the signature trie
+        struct Node
+        {
+            char letter;            //!< the letter leading to this node
+            uint32_t first_child;   //!< index of the first child, children are sorted by letter
+            uint32_t child_count;   //!< number of children
+            uint32_t word_begin;    //!< first id of the words whose signature ends on this node
+            uint32_t word_end;      //!< last id (excluded) of the words whose signature ends on this node
+        };
+
+        //! @brief compare two letters as unsigned bytes, the order of std::string
+        static inline bool less(char a, char b)
+        {
+            return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+        };
+
+        //! @brief find the child of a node leading to a given letter
+        const Node* find_child(const Node& node, char letter) const
+        {
+            const Node* first = m_nodes.data() + node.first_child;
+            const Node* last = first + node.child_count;
+            first = std::lower_bound(first, last, letter, [](const Node& n, char l) { return less(n.letter, l); });
+            return (first != last && first->letter == letter) ? first : 0;
+        };
+
+        //! @brief walk the subtree of a node, using the letters left in the rack
+        void collect(const Node& node, std::size_t depth, int* counts, int blanks, std::size_t min_size, std::vector<uint32_t>& result) const
+        {
+            if (depth >= min_size)
+            {
+                for (uint32_t id = node.word_begin; id < node.word_end; ++id)
+                {
+                    result.push_back(id);
+                }
+            }
+
+            const Node* child = m_nodes.data() + node.first_child;
+            const Node* last = child + node.child_count;
+            for (; child != last; ++child)
+            {
+                int& count = counts[static_cast<unsigned char>(child->letter)];
+                //letter count pruning : the subtree needs one more of this letter
+                if (count > 0)
+                {
+                    --count;
+                    collect(*child, depth + 1, counts, blanks, min_size, result);
+                    ++count;
+                }
+                else if (blanks > 0)
+                {
+                    collect(*child, depth + 1, counts, blanks - 1, min_size, result);
+                }
+            }
+        };
+
+        //! @brief get the words of a list of ids
+        std::vector<std::string> words(const std::vector<uint32_t>& ids) const
+        {
+            std::vector<std::string> result;
+            result.reserve(ids.size());
+            for (auto id : ids)
+            {
+                result.push_back(word(id));
+            }
+            return result;
+        };
+
+        //! @brief convert from upper case string to lower case string, string sould we ansi
+        static inline std::string to_lower_case_word(const std::string& upperCase)
+        {
+            std::string lowerCase(upperCase);
+            std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
+            return lowerCase;
+        };
+
+        //! @brief the nodes of the signature trie, the root is the first one
+        std::vector<Node> m_nodes;
+
+        //! @brief the offset of each word in the pool, plus the end offset
+        std::vector<uint32_t> m_offsets;
+
+        //! @brief all the words, concatenated in signature order
+        std::string m_pool;
+    };
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <tuple>
+#include <cstdint>
+#include <algorithm>
+#include "Distance/ZDEditDistance.h"
+
+namespace Dico
+{
+    //! @brief the distance used to order a BK-tree
+    enum class ZDBKMetric
+    {
+        Levenshtein,    //!< substitution, addition, deletion (bit-vector kernel)
+        Damerau         //!< Levenshtein plus transposition of adjacent chars
+    };
+
+    //! @brief this class is a BK-tree (Burkhard-Keller) over a list of words, an alternative
+    //! fuzzy engine to the error tolerant ZDDictionary::find_word.
+    //! The tree is stored flat : nodes live in one array and the children of a node are
+    //! contiguous in that array, sorted by their distance to the parent; the words live in
+    //! one char pool. Nothing is allocated per node.
+    class ZDBKTree
+    {
+    public:
+        //! @brief constructor
+        //! @param metric the distance used to build and search the tree
+        explicit ZDBKTree(ZDBKMetric metric = ZDBKMetric::Levenshtein)
+            : m_metric(metric)
+        {
+        };
+
+        //! @brief build the tree from a list of words (typicaly Lexico::getWords()), words are
+        //! converted to lower case and duplicates are ignored
+        //! @param words the given words
+        void build(const std::vector<std::string>& words)
+        {
+            m_nodes.clear();
+            m_offsets.clear();
+            m_pool.clear();
+
+            //store the sorted unique words in the pool
+            std::vector<std::string> sorted;
+            sorted.reserve(words.size());
+            for (const auto& word : words)
+            {
+                sorted.push_back(to_lower_case_word(word));
+            }
+            std::sort(sorted.begin(), sorted.end());
+            sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+            m_offsets.reserve(sorted.size() + 1);
+            for (const auto& word : sorted)
+            {
+                m_offsets.push_back(static_cast<uint32_t>(m_pool.size()));
+                m_pool += word;
+            }
+            m_offsets.push_back(static_cast<uint32_t>(m_pool.size()));
+
+            if (sorted.empty())
+            {
+                return;
+            }
+            sorted.clear();
+            sorted.shrink_to_fit();
+
+            //the tree is built breadth first : each pending range of words is split by its
+            //distance to a pivot word, each group becomes a child whose own words are
+            //processed later, so the children of a node are always appended together
+            std::vector<uint32_t> ids(word_count());
+            for (uint32_t i = 0; i < ids.size(); ++i)
+            {
+                ids[i] = i;
+            }
+
+            struct Task
+            {
+                uint32_t node;
+                uint32_t begin;
+                uint32_t end;
+            };
+
+            std::vector<Task> tasks;
+            std::vector<std::pair<uint32_t, uint32_t>> distances;
+            ZDMyersPattern pattern;
+
+            m_nodes.reserve(ids.size());
+            m_nodes.push_back(Node{ ids[0], 0, 0, 0 });
+            tasks.push_back(Task{ 0, 1, static_cast<uint32_t>(ids.size()) });
+
+            for (std::size_t t = 0; t < tasks.size(); ++t)
+            {
+                const Task task = tasks[t];
+                const std::string pivot = word(m_nodes[task.node].word);
+                const bool bitVector = m_metric == ZDBKMetric::Levenshtein && pivot.size() <= ZDMyersPattern::max_size;
+                if (bitVector)
+                {
+                    pattern.assign(pivot);
+                }
+
+                distances.clear();
+                for (uint32_t i = task.begin; i < task.end; ++i)
+                {
+                    const int dist = bitVector ? pattern.distance(m_pool.data() + m_offsets[ids[i]], m_offsets[ids[i] + 1] - m_offsets[ids[i]])
+                                               : distance(pivot, word(ids[i]));
+                    distances.emplace_back(static_cast<uint32_t>(dist), ids[i]);
+                }
+                std::sort(distances.begin(), distances.end());
+
+                m_nodes[task.node].first_child = static_cast<uint32_t>(m_nodes.size());
+
+                std::size_t i = 0;
+                while (i < distances.size())
+                {
+                    std::size_t groupEnd = i;
+                    while (groupEnd < distances.size() && distances[groupEnd].first == distances[i].first)
+                    {
+                        ids[task.begin + groupEnd] = distances[groupEnd].second;
+                        ++groupEnd;
+                    }
+
+                    const uint32_t child = static_cast<uint32_t>(m_nodes.size());
+                    m_nodes.push_back(Node{ ids[task.begin + i], distances[i].first, 0, 0 });
+                    if (groupEnd - i > 1)
+                    {
+                        tasks.push_back(Task{ child, static_cast<uint32_t>(task.begin + i + 1), static_cast<uint32_t>(task.begin + groupEnd) });
+                    }
+                    i = groupEnd;
+                }
+
+                m_nodes[task.node].child_count = static_cast<uint32_t>(m_nodes.size()) - m_nodes[task.node].first_child;
+            }
+        };
+
+        //! @brief find all words of the tree within a maximum distance of a given word
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors
+        //! @return the matching words with their distance, sorted by distance then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            search(to_lower_case_word(word), max_error, [&](uint32_t id, int dist)
+            {
+                result.emplace_back(this->word(id), dist);
+                return true;
+            });
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            return result;
+        };
+
+        //! @brief find if a word of the tree is within a maximum distance of a given word
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors
+        //! @return true if such a word exists, false otherwise
+        bool find_word(const std::string& word, int max_error) const
+        {
+            bool result = false;
+            search(to_lower_case_word(word), max_error, [&](uint32_t, int)
+            {
+                result = true;
+                return false;
+            });
+            return result;
+        };
+
+        //! @brief get the number of words in the tree
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+        };
+
+        //! @brief get a word of the tree from its index
+        //! @param id the index of the word, in [0, word_count())
+        //! @return
+        std::string word(uint32_t id) const
+        {
+            return m_pool.substr(m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+        };
+
+        //! @brief get the metric used by the tree
+        //! @return
+        ZDBKMetric metric() const
+        {
+            return m_metric;
+        };
+
+    private:
+
+        //! @brief a node of the tree, its children are nodes [first_child, first_child + child_count)
+        struct Node
+        {
+            uint32_t word;          //!< index of the word in the pool
+            uint32_t distance;      //!< distance between this word and the parent word
+            uint32_t first_child;   //!< index of the first child node
+            uint32_t child_count;   //!< number of children
+        };
+
+        //! @brief walk the tree, calling visitor(word id, distance) for each word within max_error;
+        //! the walk stops when the visitor returns false
+        template<class Visitor>
+        void search(const std::string& word, int max_error, Visitor visitor) const
+        {
+            if (m_nodes.empty() || max_error < 0)
+            {
+                return;
+            }
+
+            //for Levenshtein, compile the query once for all the comparisons
+            const bool bitVector = m_metric == ZDBKMetric::Levenshtein && word.size() <= ZDMyersPattern::max_size;
+            ZDMyersPattern pattern;
+            if (bitVector)
+            {
+                pattern.assign(word);
+            }
+
+            std::vector<uint32_t> stack;
+            stack.push_back(0);
+
+            while (!stack.empty())
+            {
+                const Node& node = m_nodes[stack.back()];
+                stack.pop_back();
+
+                const char* text = m_pool.data() + m_offsets[node.word];
+                const std::size_t size = m_offsets[node.word + 1] - m_offsets[node.word];
+                const int dist = bitVector ? pattern.distance(text, size) : distance(word, std::string(text, size));
+
+                if (dist <= max_error && !visitor(node.word, dist))
+                {
+                    return;
+                }
+
+                //triangle inequality : only children at distance [dist - max_error, dist + max_error] may match
+                const Node* first = m_nodes.data() + node.first_child;
+                const Node* last = first + node.child_count;
+                const uint32_t low = static_cast<uint32_t>(std::max(0, dist - max_error));
+                const uint32_t high = static_cast<uint32_t>(dist + max_error);
+
+                first = std::lower_bound(first, last, low, [](const Node& n, uint32_t d) { return n.distance < d; });
+                for (; first != last && first->distance <= high; ++first)
+                {
+                    stack.push_back(static_cast<uint32_t>(first - m_nodes.data()));
+                }
+            }
+        };
+
+        //! @brief compute the distance between two words with the metric of the tree
+        int distance(const std::string& a, const std::string& b) const
+        {
+            return m_metric == ZDBKMetric::Levenshtein ? levenshtein_distance(a, b) : damerau_distance(a, b);
+        };
+
+        //! @brief convert from upper case string to lower case string, string sould we ansi
+        static inline std::string to_lower_case_word(const std::string& upperCase)
+        {
+            std::string lowerCase(upperCase);
+            std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
+            return lowerCase;
+        };
+
+        //! @brief the metric of the tree
+        ZDBKMetric m_metric;
+
+        //! @brief the nodes of the tree, the root is the first one
+        std::vector<Node> m_nodes;
+
+        //! @brief the offset of each word in the pool, plus the end offset
+        std::vector<uint32_t> m_offsets;
+
+        //! @brief all the words, concatenated
+        std::string m_pool;
+    };
+}
@@ -0,0 +1,532 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <tuple>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include "ZDDictionary.h"
+#include "Distance/ZDEditDistance.h"
+
+namespace Dico
+{
+    //! @brief where a phonetic rule applies in a word
+    enum class ZDPhoneticContext
+    {
+        Anywhere,           //!< at any position
+        Start,              //!< at the start of the word
+        End,                //!< at the end of the word
+        BeforeFrontVowel,   //!< followed by 'e', 'i' or 'y', accented or not ("ce", "gi")
+        BeforeBackVowel,    //!< followed by 'a', 'o' or 'u' ("gea", "geo")
+        BeforeConsonant,    //!< followed by a consonant other than 'n' and 'm', or at the end (nasal vowels)
+        BetweenVowels       //!< with a vowel on each side ("rose")
+    };
+
+    //! @brief a rule of a phonetic key : the chars replaced, their sound, and where the rule applies
+    struct ZDPhoneticRule
+    {
+        std::string from;
+        std::string to;
+        ZDPhoneticContext context;
+    };
+
+    //! @brief this class turns a word into a phonetic key (Soundex/Phonex style), so that words sounding alike
+    //! get the same key ("photographie" and "fotographie" -> "fotografi"). The word is read from left to right :
+    //! at each position, the first rule matching there gives the sound of its chars; a letter matched by no rule
+    //! is kept as it is, any other char is dropped. Repeated sounds are then merged into one.
+    class ZDPhoneticEncoder
+    {
+    public:
+        //! @brief defaut constructor, no rule : the key of a word is its letters, without repeats
+        ZDPhoneticEncoder()
+            : m_byFirst(256)
+        {
+        };
+
+        //! @brief add a rule, tried after the rules already added
+        //! @param from the chars replaced, in lower case, not empty
+        //! @param to their sound
+        //! @param context where the rule applies
+        void add_rule(const std::string& from, const std::string& to, ZDPhoneticContext context = ZDPhoneticContext::Anywhere)
+        {
+            if (!from.empty())
+            {
+                m_byFirst[static_cast<unsigned char>(from[0])].push_back(static_cast<uint32_t>(m_rules.size()));
+                m_rules.push_back(ZDPhoneticRule{ from, to, context });
+            }
+        };
+
+        //! @brief compute the phonetic key of a word
+        //! @param word the given word, converted to lower case
+        //! @return
+        std::string key(const std::string& word) const
+        {
+            std::string lower(word);
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+            std::string result;
+            std::size_t position = 0;
+            while (position < lower.size())
+            {
+                const ZDPhoneticRule* found = 0;
+                for (auto id : m_byFirst[static_cast<unsigned char>(lower[position])])
+                {
+                    if (matches(m_rules[id], lower, position))
+                    {
+                        found = &m_rules[id];
+                        break;
+                    }
+                }
+
+                if (found != 0)
+                {
+                    result += found->to;
+                    position += found->from.size();
+                }
+                else
+                {
+                    if (lower[position] >= 'a' && lower[position] <= 'z')
+                    {
+                        result.push_back(lower[position]);
+                    }
+                    ++position;
+                }
+            }
+
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        };
+
+        //! @brief get the rules of french spelling : silent endings, consonant groups ("ph", "qu", soft "c" and
+        //! "g"), vowel groups ("eau", "ai", "ou"), nasal vowels ("an", "in", "on") and accents, in Latin-1 and
+        //! in UTF-8
+        //! @return
+        static ZDPhoneticEncoder french()
+        {
+            using Context = ZDPhoneticContext;
+            ZDPhoneticEncoder encoder;
+
+            //silent endings, before the rules of the same letters
+            for (const char* ending : { "er", "ez", "et" })
+            {
+                encoder.add_rule(ending, "e", Context::End);
+            }
+            for (const char* ending : { "es", "e", "s", "t", "d", "x" })
+            {
+                encoder.add_rule(ending, "", Context::End);
+            }
+
+            //consonants
+            encoder.add_rule("tion", "siO");
+            encoder.add_rule("sch", "X");
+            encoder.add_rule("ch", "X");
+            encoder.add_rule("sh", "X");
+            encoder.add_rule("ph", "f");
+            encoder.add_rule("th", "t");
+            encoder.add_rule("rh", "r");
+            encoder.add_rule("gn", "N");
+            encoder.add_rule("qu", "k");
+            encoder.add_rule("q", "k");
+            encoder.add_rule("ck", "k");
+            encoder.add_rule("cc", "ks", Context::BeforeFrontVowel);
+            encoder.add_rule("c", "s", Context::BeforeFrontVowel);
+            encoder.add_rule("c", "k");
+            encoder.add_rule("gu", "g", Context::BeforeFrontVowel);
+            encoder.add_rule("ge", "j", Context::BeforeBackVowel);
+            encoder.add_rule("g", "j", Context::BeforeFrontVowel);
+            encoder.add_rule("x", "ks");
+            encoder.add_rule("w", "v");
+            encoder.add_rule("s", "z", Context::BetweenVowels);
+            encoder.add_rule("h", "");
+
+            //vowels, the nasal ones before the groups they start with
+            encoder.add_rule("eau", "o");
+            encoder.add_rule("au", "o");
+            for (const char* nasal : { "ain", "aim", "ein", "in", "im", "yn", "ym", "un" })
+            {
+                encoder.add_rule(nasal, "I", Context::BeforeConsonant);
+            }
+            encoder.add_rule("oin", "oI", Context::BeforeConsonant);
+            for (const char* nasal : { "on", "om" })
+            {
+                encoder.add_rule(nasal, "O", Context::BeforeConsonant);
+            }
+            for (const char* nasal : { "an", "am", "en", "em" })
+            {
+                encoder.add_rule(nasal, "A", Context::BeforeConsonant);
+            }
+            encoder.add_rule("ai", "e");
+            encoder.add_rule("ay", "e");
+            encoder.add_rule("ei", "e");
+            encoder.add_rule("eu", "e");
+            encoder.add_rule("oi", "oa");
+            encoder.add_rule("oy", "oa");
+            encoder.add_rule("ou", "u");
+            encoder.add_rule("y", "i");
+
+            //accents, Latin-1 then UTF-8
+            const char* const accents[][2] = {
+                { "\xE0", "a" }, { "\xE2", "a" }, { "\xE4", "a" }, { "\xE7", "s" }, { "\xE8", "e" }, { "\xE9", "e" },
+                { "\xEA", "e" }, { "\xEB", "e" }, { "\xEE", "i" }, { "\xEF", "i" }, { "\xF4", "o" }, { "\xF6", "o" },
+                { "\xF9", "u" }, { "\xFB", "u" }, { "\xFC", "u" }, { "\xFF", "i" },
+                { "\xC3\xA0", "a" }, { "\xC3\xA2", "a" }, { "\xC3\xA4", "a" }, { "\xC3\xA7", "s" }, { "\xC3\xA8", "e" },
+                { "\xC3\xA9", "e" }, { "\xC3\xAA", "e" }, { "\xC3\xAB", "e" }, { "\xC3\xAE", "i" }, { "\xC3\xAF", "i" },
+                { "\xC3\xB4", "o" }, { "\xC3\xB6", "o" }, { "\xC3\xB9", "u" }, { "\xC3\xBB", "u" }, { "\xC3\xBC", "u" },
+                { "\xC3\xBF", "i" }, { "\xC5\x93", "e" }
+            };
+            for (const auto& accent : accents)
+            {
+                encoder.add_rule(accent[0], accent[1]);
+            }
+            return encoder;
+        };
+
+    private:
+        //! @brief check if a rule applies at a position of a word
+        bool matches(const ZDPhoneticRule& rule, const std::string& word, std::size_t position) const
+        {
+            if (word.compare(position, rule.from.size(), rule.from) != 0)
+            {
+                return false;
+            }
+
+            const std::size_t next = position + rule.from.size();
+            switch (rule.context)
+            {
+            case ZDPhoneticContext::Start:
+                return position == 0;
+            case ZDPhoneticContext::End:
+                return next == word.size();
+            case ZDPhoneticContext::BeforeFrontVowel:
+                return front_vowel(word, next);
+            case ZDPhoneticContext::BeforeBackVowel:
+                return next < word.size() && (word[next] == 'a' || word[next] == 'o' || word[next] == 'u');
+            case ZDPhoneticContext::BeforeConsonant:
+                return next == word.size() || (!vowel(word, next) && word[next] != 'n' && word[next] != 'm');
+            case ZDPhoneticContext::BetweenVowels:
+                return position > 0 && vowel(word, position - 1) && vowel(word, next);
+            default:
+                return true;
+            }
+        };
+
+        //! @brief check if the char at a position is a vowel, the accented letters counting as vowels
+        static inline bool vowel(const std::string& word, std::size_t position)
+        {
+            if (position >= word.size())
+            {
+                return false;
+            }
+            const unsigned char c = static_cast<unsigned char>(word[position]);
+            return c >= 0x80 || c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u' || c == 'y';
+        };
+
+        //! @brief check if the char at a position is 'e', 'i' or 'y', accented or not
+        static inline bool front_vowel(const std::string& word, std::size_t position)
+        {
+            if (position >= word.size())
+            {
+                return false;
+            }
+            unsigned char c = static_cast<unsigned char>(word[position]);
+            if (c == 0xC3 && position + 1 < word.size())
+            {
+                //UTF-8, the second byte is the Latin-1 char less 0x40
+                c = static_cast<unsigned char>(static_cast<unsigned char>(word[position + 1]) + 0x40);
+            }
+            return c == 'e' || c == 'i' || c == 'y' || (c >= 0xE8 && c <= 0xEB) || c == 0xEE || c == 0xEF;
+        };
+
+        //! @brief the rules, in order
+        std::vector<ZDPhoneticRule> m_rules;
+
+        //! @brief the rules by the first char they replace, in order
+        std::vector<std::vector<uint32_t>> m_byFirst;
+    };
+
+    //! @brief this class is a secondary index of a list of words by phonetic key (see ZDPhoneticEncoder), to find
+    //! sound-alike words ("fotographie" -> "photographie") whose edit distance is too large for an error tolerant
+    //! search : a lookup is one probe of a hash table, giving the range of ids of the words sharing the key of the
+    //! given word, then a short check of each of them.
+    //! The words are numbered in alphabetical order; the ids of a key are contiguous in one array, and the words
+    //! and the keys are stored in two char pools.
+    class ZDPhoneticIndex
+    {
+    public:
+        //! @brief constructor
+        //! @param encoder the rules of the phonetic keys
+        explicit ZDPhoneticIndex(const ZDPhoneticEncoder& encoder = ZDPhoneticEncoder::french())
+            : m_encoder(encoder)
+        {
+        };
+
+        //! @brief build the index from a list of words (typicaly Lexico::getWords()), words are converted to lower
+        //! case and duplicates are ignored
+        //! @param words the given words
+        void build(const std::vector<std::string>& words)
+        {
+            std::vector<std::string> sorted;
+            sorted.reserve(words.size());
+            for (const auto& word : words)
+            {
+                std::string lower(word);
+                std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+                sorted.push_back(std::move(lower));
+            }
+            std::sort(sorted.begin(), sorted.end());
+            sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+            assign(sorted);
+        };
+
+        //! @brief build the index from the words of a dictionary, in one walk of its tree, typicaly once it is
+        //! loaded; the ids of the index are the word ids of the dictionary (see ZDDictionary::word_id)
+        //! @param dictionary the given dictionary
+        void build(const ZDDictionary& dictionary)
+        {
+            std::vector<std::string> words(dictionary.id_capacity());
+            dictionary.for_each_word([&words](const std::string& word, uint32_t id, uint32_t)
+            {
+                words[id] = word;
+            });
+            assign(words);
+        };
+
+        //! @brief read a dictionary from a binary stream (see ZDDictionary::load), then build the index of its
+        //! words, so both are ready at once and the index follows the words the dictionary holds, even after a
+        //! failure
+        //! @param dictionary the dictionary to read
+        //! @param in the given stream
+        //! @return true if succes, false otherwise
+        bool load(ZDDictionary& dictionary, std::istream& in)
+        {
+            const bool result = dictionary.load(in);
+            build(dictionary);
+            return result;
+        };
+
+        //! @brief read a dictionary from a given path file, then build the index of its words
+        //! @param dictionary the dictionary to read
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool load(ZDDictionary& dictionary, const std::string& inputFile)
+        {
+            std::ifstream file(inputFile, std::ios::binary);
+            return file.is_open() && load(dictionary, file);
+        };
+
+        //! @brief find the words having the same phonetic key as a given word
+        //! @param word the given word
+        //! @return the ids of the words, in alphabetical order
+        std::vector<uint32_t> find_ids(const std::string& word) const
+        {
+            const uint32_t key = find_key(m_encoder.key(word));
+            if (key == no_key)
+            {
+                return std::vector<uint32_t>();
+            }
+            return std::vector<uint32_t>(m_ids.begin() + m_idOffsets[key], m_ids.begin() + m_idOffsets[key + 1]);
+        };
+
+        //! @brief find the words sounding like a given word, within a number of errors of it : the words of the
+        //! same phonetic key are checked with the banded bit-vector edit distance, so homophones spelled too
+        //! differently ("vers", "verre", "vert") can be left out
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            const uint32_t key = find_key(m_encoder.key(word));
+            if (key == no_key || max_error < 0)
+            {
+                return result;
+            }
+
+            std::string lower(word);
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+            const bool bitVector = lower.size() <= ZDMyersPattern::max_size;
+            const ZDMyersPattern pattern(bitVector ? lower : std::string());
+
+            for (uint32_t i = m_idOffsets[key]; i < m_idOffsets[key + 1]; ++i)
+            {
+                const uint32_t id = m_ids[i];
+                const char* text = m_pool.data() + m_offsets[id];
+                const std::size_t size = m_offsets[id + 1] - m_offsets[id];
+                const int errors = bitVector ? pattern.distance(text, size, max_error)
+                                             : levenshtein_distance(lower, std::string(text, size), max_error);
+                if (errors <= max_error)
+                {
+                    result.emplace_back(std::string(text, size), errors);
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            return result;
+        };
+
+        //! @brief find if a word sounding like a given word exist, within a number of errors of it
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors
+        //! @return true if a word is found, false otherwise
+        bool find_word(const std::string& word, int max_error) const
+        {
+            return !find_words(word, max_error).empty();
+        };
+
+        //! @brief compute the phonetic key of a word
+        //! @param word the given word
+        //! @return
+        std::string key(const std::string& word) const
+        {
+            return m_encoder.key(word);
+        };
+
+        //! @brief get the number of ids of the index : the number of words, or the id capacity of the dictionary
+        //! it is built from, whose free ids have no word
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+        };
+
+        //! @brief get the number of different phonetic keys
+        //! @return
+        std::size_t key_count() const
+        {
+            return m_keyOffsets.empty() ? 0 : m_keyOffsets.size() - 1;
+        };
+
+        //! @brief get a word of the index from its id
+        //! @param id the id of the word, in [0, word_count())
+        //! @return the word, empty for a free id of a dictionary
+        std::string word(uint32_t id) const
+        {
+            return m_pool.substr(m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+        };
+
+    private:
+        //! @brief the value of an empty slot of the hash table, and of a key not found
+        static constexpr uint32_t no_key = 0xFFFFFFFF;
+
+        //! @brief a slot of the hash table : the hash of a key and its index
+        struct Slot
+        {
+            uint32_t hash;
+            uint32_t key;
+        };
+
+        //! @brief fill the index from unique words, indexed by their id; an empty word is a free id
+        void assign(const std::vector<std::string>& words)
+        {
+            m_pool.clear();
+            m_offsets.clear();
+            m_offsets.reserve(words.size() + 1);
+            for (const auto& word : words)
+            {
+                m_offsets.push_back(static_cast<uint32_t>(m_pool.size()));
+                m_pool += word;
+            }
+            m_offsets.push_back(static_cast<uint32_t>(m_pool.size()));
+
+            //group the ids by key
+            std::vector<std::pair<std::string, uint32_t>> entries;
+            entries.reserve(words.size());
+            for (uint32_t id = 0; id < words.size(); ++id)
+            {
+                if (!words[id].empty())
+                {
+                    entries.emplace_back(m_encoder.key(words[id]), id);
+                }
+            }
+            std::sort(entries.begin(), entries.end());
+
+            m_ids.clear();
+            m_ids.reserve(entries.size());
+            m_idOffsets.clear();
+            m_keys.clear();
+            m_keyOffsets.assign(1, 0);
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                if (i == 0 || entries[i].first != entries[i - 1].first)
+                {
+                    m_idOffsets.push_back(static_cast<uint32_t>(m_ids.size()));
+                    m_keys += entries[i].first;
+                    m_keyOffsets.push_back(static_cast<uint32_t>(m_keys.size()));
+                }
+                m_ids.push_back(entries[i].second);
+            }
+            m_idOffsets.push_back(static_cast<uint32_t>(m_ids.size()));
+
+            //the hash table, at most half full
+            std::size_t size = 16;
+            while (size < 2 * key_count())
+            {
+                size *= 2;
+            }
+            m_slots.assign(size, Slot{ 0, no_key });
+            for (uint32_t key = 0; key < key_count(); ++key)
+            {
+                const uint32_t keyHash = hash(m_keys.data() + m_keyOffsets[key], m_keyOffsets[key + 1] - m_keyOffsets[key]);
+                std::size_t slot = keyHash & (m_slots.size() - 1);
+                while (m_slots[slot].key != no_key)
+                {
+                    slot = (slot + 1) & (m_slots.size() - 1);
+                }
+                m_slots[slot] = Slot{ keyHash, key };
+            }
+        };
+
+        //! @brief find the index of a key in the hash table
+        uint32_t find_key(const std::string& key) const
+        {
+            if (m_slots.empty())
+            {
+                return no_key;
+            }
+            const uint32_t keyHash = hash(key.data(), key.size());
+            for (std::size_t slot = keyHash & (m_slots.size() - 1); m_slots[slot].key != no_key; slot = (slot + 1) & (m_slots.size() - 1))
+            {
+                const Slot& found = m_slots[slot];
+                if (found.hash == keyHash && m_keys.compare(m_keyOffsets[found.key], m_keyOffsets[found.key + 1] - m_keyOffsets[found.key], key) == 0)
+                {
+                    return found.key;
+                }
+            }
+            return no_key;
+        };
+
+        //! @brief hash a key (FNV-1a)
+        static inline uint32_t hash(const char* key, std::size_t size)
+        {
+            uint32_t result = 2166136261u;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                result = (result ^ static_cast<unsigned char>(key[i])) * 16777619u;
+            }
+            return result;
+        };
+
+        //! @brief the rules of the phonetic keys
+        ZDPhoneticEncoder m_encoder;
+
+        //! @brief all the words, concatenated in alphabetical order, and the offset of each one plus the end offset
+        std::string m_pool;
+        std::vector<uint32_t> m_offsets;
+
+        //! @brief all the keys, concatenated in order, and the offset of each one plus the end offset
+        std::string m_keys;
+        std::vector<uint32_t> m_keyOffsets;
+
+        //! @brief the ids of the words by key, and the offset of the ids of each key plus the end offset
+        std::vector<uint32_t> m_ids;
+        std::vector<uint32_t> m_idOffsets;
+
+        //! @brief the hash table of the keys, open addressing with linear probing
+        std::vector<Slot> m_slots;
+    };
+}
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+#include "Serialization/ZDBinaryIO.h"
+
+namespace Dico
+{
+    //! @brief this class is a suffix array over a list of words, answering "which words contain
+    //! 'aiss'" and "which words end with 'ment'" without walking the whole dictionary.
+    //! The words are sorted, then concatenated, each one followed by a separator; the suffix array
+    //! holds every position inside a word, sorted by the rest of the word from that position. The
+    //! matches of a query are a contiguous range of the array : its start is found by binary search,
+    //! its end by scanning the LCP array (longest common prefix of neighbouring suffixes).
+    class ZDSuffixIndex
+    {
+    public:
+        //! @brief defaut constructor
+        ZDSuffixIndex() = default;
+
+        //! @brief build the index from a list of words (typicaly Lexico::getWords()), words are
+        //! converted to lower case and duplicates are ignored
+        //! @param words the given words
+        void build(const std::vector<std::string>& words)
+        {
+            std::vector<std::string> sorted;
+            sorted.reserve(words.size());
+            for (const auto& word : words)
+            {
+                sorted.push_back(to_lower_case_word(word));
+            }
+            std::sort(sorted.begin(), sorted.end());
+            sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+            m_text.clear();
+            m_offsets.clear();
+            m_offsets.reserve(sorted.size() + 1);
+            for (const auto& word : sorted)
+            {
+                m_offsets.push_back(static_cast<uint32_t>(m_text.size()));
+                m_text += word;
+                m_text.push_back(separator);
+            }
+            m_offsets.push_back(static_cast<uint32_t>(m_text.size()));
+            sorted.clear();
+            sorted.shrink_to_fit();
+
+            //all the positions inside a word
+            m_suffixes.clear();
+            m_suffixes.reserve(m_text.size());
+            for (uint32_t i = 0; i < m_text.size(); ++i)
+            {
+                if (m_text[i] != separator)
+                {
+                    m_suffixes.push_back(i);
+                }
+            }
+
+            const char* text = m_text.data();
+            std::sort(m_suffixes.begin(), m_suffixes.end(), [text](uint32_t a, uint32_t b)
+            {
+                const int order = compare(text + a, text + b);
+                return order < 0 || (order == 0 && a < b);
+            });
+
+            build_lcp();
+        };
+
+        //! @brief find the words containing a given string
+        //! @param part the given string
+        //! @return the ids of the words, sorted
+        std::vector<uint32_t> find_containing(const std::string& part) const
+        {
+            std::vector<uint32_t> result;
+            const std::string key = to_lower_case_word(part);
+            if (key.empty())
+            {
+                return all_ids();
+            }
+
+            const std::size_t first = lower_bound(key);
+            if (first == m_suffixes.size() || prefix_length(m_text.data() + m_suffixes[first], key) < key.size())
+            {
+                return result;
+            }
+
+            result.push_back(word_of(m_suffixes[first]));
+            for (std::size_t i = first + 1; i < m_suffixes.size() && m_lcp[i] >= key.size(); ++i)
+            {
+                result.push_back(word_of(m_suffixes[i]));
+            }
+
+            //a word containing the string several times appears several times
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        };
+
+        //! @brief find the words ending with a given string
+        //! @param suffix the given string
+        //! @return the ids of the words, sorted
+        std::vector<uint32_t> find_ending_with(const std::string& suffix) const
+        {
+            std::vector<uint32_t> result;
+            const std::string key = to_lower_case_word(suffix);
+            if (key.empty())
+            {
+                return all_ids();
+            }
+
+            //the suffixes equal to the key come first in the range of suffixes starting with it
+            std::size_t i = lower_bound(key);
+            while (i < m_suffixes.size() && compare_key(m_text.data() + m_suffixes[i], key) == 0)
+            {
+                result.push_back(word_of(m_suffixes[i]));
+                ++i;
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        };
+
+        //! @brief find the words containing a given string
+        //! @param part the given string
+        //! @return the words, sorted
+        std::vector<std::string> find_words_containing(const std::string& part) const
+        {
+            return words(find_containing(part));
+        };
+
+        //! @brief find the words ending with a given string
+        //! @param suffix the given string
+        //! @return the words, sorted
+        std::vector<std::string> find_words_ending_with(const std::string& suffix) const
+        {
+            return words(find_ending_with(suffix));
+        };
+
+        //! @brief get the number of words in the index
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+        };
+
+        //! @brief get a word of the index from its id, ids follow the alphabetical order
+        //! @param id the id of the word, in [0, word_count())
+        //! @return
+        std::string word(uint32_t id) const
+        {
+            return m_text.substr(m_offsets[id], m_offsets[id + 1] - m_offsets[id] - 1);
+        };
+
+        //! @brief write the index to a binary stream
+        //! @param out the given stream
+        //! @return true if succes, false otherwise
+        bool save(std::ostream& out) const
+        {
+            write_header(out, magic, version);
+            write_string(out, m_text);
+            write_vector(out, m_offsets);
+            write_vector(out, m_suffixes);
+            write_vector(out, m_lcp);
+            return static_cast<bool>(out);
+        };
+
+        //! @brief read the index from a binary stream written by save
+        //! @param in the given stream
+        //! @return true if succes, false otherwise
+        bool load(std::istream& in)
+        {
+            const bool result = read_header(in, magic, version)
+                && read_string(in, m_text)
+                && read_vector(in, m_offsets)
+                && read_vector(in, m_suffixes)
+                && read_vector(in, m_lcp)
+                && valid();
+
+            if (!result)
+            {
+                *this = ZDSuffixIndex();
+            }
+            return result;
+        };
+
+        //! @brief write the index to a given path file
+        //! @param outputFile the given path file
+        //! @return true if succes, false otherwise
+        bool save(const std::string& outputFile) const
+        {
+            std::ofstream file(outputFile, std::ios::binary);
+            return file.is_open() && save(file);
+        };
+
+        //! @brief read the index from a given path file
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool load(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile, std::ios::binary);
+            return file.is_open() && load(file);
+        };
+
+    private:
+
+        //! @brief the char ending each word in the text
+        static constexpr char separator = '\0';
+
+        //! @brief the file type and version of the binary format
+        static constexpr char magic[5] = "ZDSX";
+        static constexpr uint32_t version = 1;
+
+        //! @brief check the arrays read from a file, so that no query reads out of the text : the offsets go up
+        //! from 0 to the size of the text, each word ends with the only separator it holds, and each suffix starts
+        //! inside a word
+        bool valid() const
+        {
+            if (m_offsets.empty())
+            {
+                //the index of no word, never built
+                return m_text.empty() && m_suffixes.empty() && m_lcp.empty();
+            }
+            if (m_offsets.front() != 0 || m_offsets.back() != m_text.size() || m_lcp.size() != m_suffixes.size())
+            {
+                return false;
+            }
+            for (std::size_t i = 1; i < m_offsets.size(); ++i)
+            {
+                if (m_offsets[i] <= m_offsets[i - 1] || m_offsets[i] > m_text.size() || m_text[m_offsets[i] - 1] != separator)
+                {
+                    return false;
+                }
+            }
+            if (static_cast<std::size_t>(std::count(m_text.begin(), m_text.end(), separator)) != m_offsets.size() - 1)
+            {
+                return false;
+            }
+            for (const uint32_t suffix : m_suffixes)
+            {
+                if (suffix >= m_text.size() || m_text[suffix] == separator)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        //! @brief compare two suffixes, up to the end of their word
+        static inline int compare(const char* a, const char* b)
+        {
+            while (*a != separator && *a == *b)
+            {
+                ++a;
+                ++b;
+            }
+            return static_cast<int>(static_cast<unsigned char>(*a)) - static_cast<int>(static_cast<unsigned char>(*b));
+        };
+
+        //! @brief compare a suffix, up to the end of its word, with a key
+        static inline int compare_key(const char* suffix, const std::string& key)
+        {
+            for (std::size_t i = 0; i < key.size(); ++i)
+            {
+                //the end of the word comes before any char
+                if (suffix[i] == separator)
+                {
+                    return -1;
+                }
+                if (suffix[i] != key[i])
+                {
+                    return (static_cast<unsigned char>(suffix[i]) < static_cast<unsigned char>(key[i])) ? -1 : 1;
+                }
+            }
+            return (suffix[key.size()] == separator) ? 0 : 1;
+        };
+
+        //! @brief get the number of chars shared by a suffix and a key
+        static inline std::size_t prefix_length(const char* suffix, const std::string& key)
+        {
+            std::size_t i = 0;
+            while (i < key.size() && suffix[i] != separator && suffix[i] == key[i])
+            {
+                ++i;
+            }
+            return i;
+        };
+
+        //! @brief find the first suffix not lower than a key
+        std::size_t lower_bound(const std::string& key) const
+        {
+            const char* text = m_text.data();
+            auto found = std::lower_bound(m_suffixes.begin(), m_suffixes.end(), key, [text](uint32_t suffix, const std::string& k)
+            {
+                return compare_key(text + suffix, k) < 0;
+            });
+            return static_cast<std::size_t>(found - m_suffixes.begin());
+        };
+
+        //! @brief build the LCP array with Kasai's algorithm : m_lcp[i] is the common prefix of suffixes
+        //! i - 1 and i, up to the end of their word
+        void build_lcp()
+        {
+            std::vector<uint32_t> rank(m_text.size(), 0);
+            for (uint32_t i = 0; i < m_suffixes.size(); ++i)
+            {
+                rank[m_suffixes[i]] = i;
+            }
+
+            m_lcp.assign(m_suffixes.size(), 0);
+            uint32_t h = 0;
+            for (uint32_t position = 0; position < m_text.size(); ++position)
+            {
+                if (m_text[position] == separator)
+                {
+                    h = 0;
+                    continue;
+                }
+
+                const uint32_t r = rank[position];
+                if (r > 0)
+                {
+                    const uint32_t previous = m_suffixes[r - 1];
+                    while (m_text[position + h] != separator && m_text[position + h] == m_text[previous + h])
+                    {
+                        ++h;
+                    }
+                    m_lcp[r] = h;
+                    if (h > 0)
+                    {
+                        --h;
+                    }
+                }
+                else
+                {
+                    h = 0;
+                }
+            }
+        };
+
+        //! @brief get the id of the word holding a position of the text
+        uint32_t word_of(uint32_t position) const
+        {
+            return static_cast<uint32_t>(std::upper_bound(m_offsets.begin(), m_offsets.end(), position) - m_offsets.begin()) - 1;
+        };
+
+        //! @brief get the ids of all the words
+        std::vector<uint32_t> all_ids() const
+        {
+            std::vector<uint32_t> result(word_count());
+            for (uint32_t i = 0; i < result.size(); ++i)
+            {
+                result[i] = i;
+            }
+            return result;
+        };
+
+        //! @brief get the words of a list of ids
+        std::vector<std::string> words(const std::vector<uint32_t>& ids) const
+        {
+            std::vector<std::string> result;
+            result.reserve(ids.size());
+            for (auto id : ids)
+            {
+                result.push_back(word(id));
+            }
+            return result;
+        };
+
+        //! @brief convert from upper case string to lower case string, string sould we ansi
+        static inline std::string to_lower_case_word(const std::string& upperCase)
+        {
+            std::string lowerCase(upperCase);
+            std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
+            return lowerCase;
+        };
+
+        //! @brief the sorted words, each one followed by a separator
+        std::string m_text;
+
+        //! @brief the offset of each word in the text, plus the end offset
+        std::vector<uint32_t> m_offsets;
+
+        //! @brief the suffix array : positions inside the words, sorted by the rest of their word
+        std::vector<uint32_t> m_suffixes;
+
+        //! @brief the LCP array
+        std::vector<uint32_t> m_lcp;
+    };
+}
@@ -4,10 +4,13 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <cstdint>
+#include <cstdlib>
 
 namespace Dico
 {
 	//! @brief This class juste wrap a std::vector<string> representing the lexico data base.
+	//! Each line is a word, optionally followed by a tab and its weight (typicaly its frequency count).
 	class Lexico
 	{
 	public:
@@ -26,6 +29,17 @@ namespace Dico
 				std::string line;
 				while (std::getline(file, line))
 				{
+					//optional "word<TAB>count" format, words without count get a null weight
+					const std::size_t tab = line.find('\t');
+					if (tab != std::string::npos)
+					{
+						m_weights.push_back(static_cast<uint32_t>(std::strtoul(line.c_str() + tab + 1, nullptr, 10)));
+						line.erase(tab);
+					}
+					else
+					{
+						m_weights.push_back(0);
+					}
 					m_words.push_back(line.c_str());
 				}
 				file.close();
@@ -45,7 +59,15 @@ namespace Dico
 			return m_words;
 		}
 
+		//! @brief get the weight of each word of the lexico data base, in the order of getWords()
+		//! @return 
+		const std::vector<uint32_t>& getWeights()
+		{
+			return m_weights;
+		}
+
 	private:
 		std::vector<std::string> m_words;
+		std::vector<uint32_t> m_weights;
 	};
 }
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Dico
+{
+    //! @brief the pages backing a placed block
+    enum class ZDHugePages
+    {
+        None,               //!< the pages of the system, 4 KB
+        Transparent,        //!< 2 MB pages given by the kernel when it can (transparent huge pages, madvise)
+        Explicit            //!< 2 MB pages reserved by the administrator (MAP_HUGETLB), transparent ones if none is left
+    };
+
+    //! @brief where and how a large block of memory is placed
+    struct ZDPlacementOptions
+    {
+        //! @brief the pages backing the block
+        ZDHugePages huge_pages = ZDHugePages::None;
+
+        //! @brief the NUMA node the block should live on, -1 for the policy of the system (first touch)
+        int numa_node = -1;
+
+        //! @brief fault all the pages in at once, so the first lookups do not pay a page fault for each page they
+        //! touch
+        bool prefault = false;
+
+        //! @brief lock the pages in memory (mlock), so they are never swapped out; the pages are faulted in too
+        bool lock = false;
+
+        //! @brief the size from which a block is placed, smaller ones come from the heap
+        std::size_t min_size = std::size_t(1) << 20;
+
+        //! @brief check if any option differs from the placement of the heap
+        //! @return
+        bool enabled() const
+        {
+            return huge_pages != ZDHugePages::None || numa_node >= 0 || prefault || lock;
+        };
+    };
+
+    //! @brief what was applied to the last block placed : every option falls back silently when the system refuses
+    //! it (no huge page reserved, no NUMA, mlock limit), the report tells which ones held
+    struct ZDPlacementReport
+    {
+        bool mapped = false;        //!< the block was mapped apart from the heap
+        bool huge_pages = false;    //!< backed by huge pages (reserved ones, or advised for transparent ones)
+        bool numa = false;          //!< bound to the NUMA node
+        bool prefaulted = false;    //!< all its pages faulted in
+        bool locked = false;        //!< locked in memory
+    };
+
+    //! @brief get the number of NUMA nodes of the host
+    //! @return the highest online node plus one, 1 without NUMA
+    inline int numa_node_count()
+    {
+#if defined(__linux__)
+        //a list of ranges, like "0-1" or "0,2-3"
+        std::ifstream file("/sys/devices/system/node/online");
+        std::string ranges;
+        if (!std::getline(file, ranges))
+        {
+            return 1;
+        }
+        int highest = 0;
+        int value = 0;
+        bool digits = false;
+        for (const char c : ranges + ",")
+        {
+            if (c >= '0' && c <= '9')
+            {
+                value = value * 10 + (c - '0');
+                digits = true;
+            }
+            else
+            {
+                if (digits && value > highest)
+                {
+                    highest = value;
+                }
+                value = 0;
+                digits = false;
+            }
+        }
+        return highest + 1;
+#else
+        return 1;
+#endif
+    }
+
+    //! @brief get the NUMA node of the CPU running the calling thread
+    //! @return the node, 0 if unknown
+    inline int current_numa_node()
+    {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned int cpu = 0;
+        unsigned int node = 0;
+        if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+        {
+            return static_cast<int>(node);
+        }
+#endif
+        return 0;
+    }
+
+    //! @brief get the NUMA node of the calling thread as current_numa_node does, the node being kept per thread and
+    //! asked again only every numa_refresh calls : a thread rarely moves to another node, and a stale node only
+    //! costs remote reads until the next refresh
+    //! @return the node, 0 if unknown
+    inline int cached_numa_node()
+    {
+        constexpr unsigned int numa_refresh = 1024;
+        thread_local int node = -1;
+        thread_local unsigned int calls = 0;
+        if (node < 0 || ++calls == numa_refresh)
+        {
+            node = current_numa_node();
+            calls = 0;
+        }
+        return node;
+    }
+
+    //! @brief this class maps the large blocks of memory of a structure with given placement options, and keeps
+    //! the blocks it mapped to release them. On Linux a block is an anonymous mapping : aligned on 2 MB and advised
+    //! for transparent huge pages, or backed by reserved huge pages, bound to a NUMA node (mbind, preferred policy,
+    //! so the kernel can still use another node when the node is full), then faulted in and locked. On other
+    //! systems the options are ignored.
+    class ZDPlacedMemory
+    {
+    public:
+        //! @brief the size of a huge page
+        static constexpr std::size_t huge_page = std::size_t(2) << 20;
+
+        //! @brief defaut constructor, blocks from the heap
+        ZDPlacedMemory() = default;
+
+        //! @brief distructor, release the blocks left
+        ~ZDPlacedMemory()
+        {
+            while (!m_blocks.empty())
+            {
+                release(m_blocks.back().address);
+            }
+        };
+
+        ZDPlacedMemory(const ZDPlacedMemory&) = delete;
+        ZDPlacedMemory& operator=(const ZDPlacedMemory&) = delete;
+
+        //! @brief set the options of the blocks allocated from now on
+        //! @param options the given options
+        void set_options(const ZDPlacementOptions& options)
+        {
+            m_options = options;
+        };
+
+        //! @brief get the options of the blocks
+        //! @return
+        const ZDPlacementOptions& options() const
+        {
+            return m_options;
+        };
+
+        //! @brief get what was applied to the last block placed, still allocated
+        //! @return
+        ZDPlacementReport report() const
+        {
+            return m_blocks.empty() ? ZDPlacementReport() : m_blocks.back().report;
+        };
+
+        //! @brief allocate a block placed with the options, if it is large enough
+        //! @param size the size of the block in bytes
+        //! @return the block, null if it should come from the heap or can not be mapped
+        void* allocate(std::size_t size)
+        {
+            if (!m_options.enabled() || size < m_options.min_size || size == 0)
+            {
+                return nullptr;
+            }
+
+            ZDPlacementReport report;
+            std::size_t length = 0;
+            void* address = map(size, report, length);
+            if (address == nullptr)
+            {
+                return nullptr;
+            }
+            m_blocks.push_back(Block{ address, length, report });
+            return address;
+        };
+
+        //! @brief release a block allocated by allocate
+        //! @param address the block
+        //! @return false if the block was not allocated by allocate
+        bool release(void* address)
+        {
+            for (std::size_t i = 0; i < m_blocks.size(); ++i)
+            {
+                if (m_blocks[i].address == address)
+                {
+#if defined(__linux__)
+                    ::munmap(address, m_blocks[i].length);
+#else
+                    ::operator delete(address);
+#endif
+                    m_blocks.erase(m_blocks.begin() + i);
+                    return true;
+                }
+            }
+            return false;
+        };
+
+    private:
+        //! @brief a block mapped, its size and what was applied to it
+        struct Block
+        {
+            void* address;
+            std::size_t length;
+            ZDPlacementReport report;
+        };
+
+        //! @brief map a block with the options
+        void* map(std::size_t size, ZDPlacementReport& report, std::size_t& length)
+        {
+#if defined(__linux__)
+            const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            void* address = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+            if (m_options.huge_pages == ZDHugePages::Explicit)
+            {
+                length = round_up(size, huge_page);
+                address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                report.huge_pages = address != MAP_FAILED;
+            }
+#endif
+            if (address == MAP_FAILED && m_options.huge_pages != ZDHugePages::None)
+            {
+                //map one huge page more, to keep a part aligned on a huge page
+                length = round_up(size, huge_page);
+                void* mapping = ::mmap(nullptr, length + huge_page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapping != MAP_FAILED)
+                {
+                    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(mapping);
+                    const std::uintptr_t aligned = round_up(start, huge_page);
+                    if (aligned != start)
+                    {
+                        ::munmap(mapping, aligned - start);
+                    }
+                    ::munmap(reinterpret_cast<void*>(aligned + length), huge_page - (aligned - start));
+                    address = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+                    report.huge_pages = ::madvise(address, length, MADV_HUGEPAGE) == 0;
+#endif
+                }
+            }
+            if (address == MAP_FAILED)
+            {
+                length = round_up(size, page);
+                address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            }
+            if (address == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            report.mapped = true;
+
+#if defined(SYS_mbind)
+            //before any page is faulted in, the policy applies to the pages faulted later
+            if (m_options.numa_node >= 0 && m_options.numa_node < 64 * numa_mask_words)
+            {
+                unsigned long mask[numa_mask_words] = { 0 };
+                mask[m_options.numa_node / 64] = 1UL << (m_options.numa_node % 64);
+                report.numa = ::syscall(SYS_mbind, address, length, mpol_preferred, mask, 64 * numa_mask_words + 1, 0) == 0;
+            }
+#endif
+
+            if (m_options.prefault || m_options.lock)
+            {
+                //write each page, reading would map the shared zero page
+                volatile char* bytes = static_cast<volatile char*>(address);
+                for (std::size_t offset = 0; offset < length; offset += page)
+                {
+                    bytes[offset] = 0;
+                }
+                report.prefaulted = true;
+            }
+            if (m_options.lock)
+            {
+                report.locked = ::mlock(address, length) == 0;
+            }
+            return address;
+#else
+            length = size;
+            (void)report;
+            return ::operator new(size);
+#endif
+        };
+
+        //! @brief round a size up to a multiple of a power of two
+        static inline std::size_t round_up(std::size_t size, std::size_t alignment)
+        {
+            return (size + alignment - 1) & ~(alignment - 1);
+        };
+
+        //! @brief the NUMA policy preferring a node, and the size of the node mask in 64 bits words (as in the kernel)
+        static constexpr int mpol_preferred = 1;
+        static constexpr int numa_mask_words = 16;
+
+        //! @brief the options of the blocks
+        ZDPlacementOptions m_options;
+
+        //! @brief the blocks mapped, not released yet, in the order of allocation
+        std::vector<Block> m_blocks;
+    };
+
+    //! @brief an allocator placing its large allocations (the block of nodes of ZDTree::relayout) with ZDPlacedMemory,
+    //! the small ones (a node at a time) coming from the heap. The copies of an allocator share its placement.
+    template<class T>
+    class ZDPlacedAllocator
+    {
+    public:
+        typedef T value_type;
+
+        //! @brief defaut constructor, no placement
+        ZDPlacedAllocator()
+            : m_memory(std::make_shared<ZDPlacedMemory>())
+        {
+        };
+
+        //! @brief build an allocator sharing the placement of another one
+        template<class U>
+        ZDPlacedAllocator(const ZDPlacedAllocator<U>& other)
+            : m_memory(other.memory())
+        {
+        };
+
+        //! @brief allocate n objects, placed if they are large enough
+        T* allocate(std::size_t n)
+        {
+            void* placed = m_memory->allocate(n * sizeof(T));
+            return (placed != nullptr) ? static_cast<T*>(placed) : std::allocator<T>().allocate(n);
+        };
+
+        //! @brief release n objects
+        void deallocate(T* p, std::size_t n)
+        {
+            if (!m_memory->release(p))
+            {
+                std::allocator<T>().deallocate(p, n);
+            }
+        };
+
+        //! @brief get the placement shared by the copies of the allocator
+        //! @return
+        const std::shared_ptr<ZDPlacedMemory>& memory() const
+        {
+            return m_memory;
+        };
+
+        template<class U>
+        bool operator==(const ZDPlacedAllocator<U>& other) const
+        {
+            return m_memory == other.memory();
+        };
+
+        template<class U>
+        bool operator!=(const ZDPlacedAllocator<U>& other) const
+        {
+            return m_memory != other.memory();
+        };
+
+    private:
+        //! @brief the placement of the large allocations
+        std::shared_ptr<ZDPlacedMemory> m_memory;
+    };
+}
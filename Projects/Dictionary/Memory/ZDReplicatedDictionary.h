@@ -0,0 +1,130 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <sstream>
+#include <fstream>
+#include "ZDDictionary.h"
+#include "Memory/ZDPlacement.h"
+
+namespace Dico
+{
+    //! @brief this class keeps one copy of a dictionary per NUMA node, each one placed on its node, so that a
+    //! thread reads the nodes of the dictionary from the memory of its own socket instead of crossing the
+    //! interconnect at each lookup. Without NUMA there is a single copy, placed with the other options.
+    //! The copies are read only : to change the words, build them again from the changed dictionary.
+    class ZDReplicatedDictionary
+    {
+    public:
+        //! @brief defaut constructor, no copy
+        ZDReplicatedDictionary() = default;
+
+        //! @brief build an empty set of copies with given placement options
+        //! @param options the options of each copy, numa_node is set to the node of the copy
+        explicit ZDReplicatedDictionary(const ZDPlacementOptions& options)
+            : m_options(options)
+        {
+        };
+
+        ZDReplicatedDictionary(const ZDReplicatedDictionary&) = delete;
+        ZDReplicatedDictionary& operator=(const ZDReplicatedDictionary&) = delete;
+
+        //! @brief copy a dictionary on each NUMA node, the current copies are replaced
+        //! @param source the given dictionary
+        //! @return true if succes, false otherwise
+        bool build(const ZDDictionary& source)
+        {
+            std::stringstream snapshot;
+            if (!source.save(snapshot))
+            {
+                return false;
+            }
+            return load(snapshot);
+        };
+
+        //! @brief read a dictionary written by ZDDictionary::save on each NUMA node, the current copies are replaced
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool load(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile, std::ios::binary);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            std::stringstream snapshot;
+            snapshot << file.rdbuf();
+            return load(snapshot);
+        };
+
+        //! @brief get the copy of the NUMA node running the calling thread, the node being refreshed now and then
+        //! (see cached_numa_node)
+        //! @return the copy, the first one if the node has none; the copies must have been built
+        const ZDDictionary& local() const
+        {
+            return (m_replicas.size() == 1) ? *m_replicas.front() : replica(cached_numa_node());
+        };
+
+        //! @brief get the copy of a NUMA node
+        //! @param node the given node
+        //! @return the copy, the first one if the node has none; the copies must have been built
+        const ZDDictionary& replica(int node) const
+        {
+            return (node >= 0 && static_cast<std::size_t>(node) < m_replicas.size()) ? *m_replicas[node] : *m_replicas.front();
+        };
+
+        //! @brief get the number of copies
+        //! @return
+        std::size_t replica_count() const
+        {
+            return m_replicas.size();
+        };
+
+        //! @brief check if the placement options were all applied to every copy
+        //! @return
+        bool placement_applied() const
+        {
+            return m_applied;
+        };
+
+    private:
+        //! @brief read the snapshot of a dictionary into one copy per node
+        bool load(std::stringstream& snapshot)
+        {
+            const int nodes = numa_node_count();
+            std::vector<std::unique_ptr<ZDDictionary>> replicas;
+            bool applied = true;
+            for (int node = 0; node < nodes; ++node)
+            {
+                ZDPlacementOptions options = m_options;
+                //a single node is where the memory goes anyway, binding it would only fail without NUMA
+                options.numa_node = (nodes > 1) ? node : -1;
+
+                //the options are set on the empty copy, its nodes are placed by load
+                std::unique_ptr<ZDDictionary> replica(new ZDDictionary());
+                replica->set_placement(options);
+                snapshot.clear();
+                snapshot.seekg(0);
+                if (!replica->load(snapshot))
+                {
+                    return false;
+                }
+                applied = replica->placement_applied() && applied;
+                replicas.push_back(std::move(replica));
+            }
+            m_replicas.swap(replicas);
+            m_applied = applied;
+            return true;
+        };
+
+        //! @brief the placement options of the copies
+        ZDPlacementOptions m_options;
+
+        //! @brief the copies, indexed by NUMA node
+        std::vector<std::unique_ptr<ZDDictionary>> m_replicas;
+
+        //! @brief true if the options were all applied to every copy
+        bool m_applied = false;
+    };
+}
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <bitset>
+#include <cstdint>
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+#include "ZDDictionaryTree.h"
+
+namespace Dico
+{
+    //! @brief this class compiles a wildcard pattern into an automaton over bytes.
+    //! The syntax is :
+    //! - '?'       any single char
+    //! - '*'       any sequence of chars, possibly empty
+    //! - '[ae]'    one char of a class, ranges ('[a-f]') and negation ('[^ae]') are allowed
+    //! - '\\x'     the char x itself
+    //! - any other char matches itself
+    //!
+    //! The pattern is a small NFA whose states are the positions between the elements of the
+    //! pattern, a set of states being a 64 bits mask. Its DFA is built lazily, one transition at
+    //! a time, while the dictionary is walked.
+    class ZDPattern
+    {
+    public:
+        //! @brief maximum number of elements (chars, wildcards, classes) of a pattern
+        static constexpr std::size_t max_elements = 63;
+
+        //! @brief a state of the DFA
+        typedef int32_t State;
+
+        //! @brief the state reached when no word can match any more
+        static constexpr State dead_state = 0;
+
+        //! @brief default constructor, invalid pattern
+        ZDPattern() = default;
+
+        //! @brief compile a given pattern
+        //! @param pattern the given pattern
+        explicit ZDPattern(const std::string& pattern)
+        {
+            compile(pattern);
+        };
+
+        //! @brief compile a given pattern
+        //! @param pattern the given pattern
+        //! @return true if succes, false if the pattern is malformed or too long
+        bool compile(const std::string& pattern)
+        {
+            m_elements.clear();
+            m_sets.clear();
+            m_transitions.clear();
+            m_index.clear();
+            m_valid = false;
+
+            std::size_t i = 0;
+            while (i < pattern.size())
+            {
+                Element element;
+                const char charr = pattern[i];
+
+                if (charr == '*')
+                {
+                    element.star = true;
+                    element.symbols.set();
+                    //consecutive stars are the same as one
+                    if (!m_elements.empty() && m_elements.back().star)
+                    {
+                        ++i;
+                        continue;
+                    }
+                    ++i;
+                }
+                else if (charr == '?')
+                {
+                    element.symbols.set();
+                    ++i;
+                }
+                else if (charr == '[')
+                {
+                    std::size_t end = i + 1;
+                    bool negate = false;
+                    if (end < pattern.size() && pattern[end] == '^')
+                    {
+                        negate = true;
+                        ++end;
+                    }
+                    const std::size_t first = end;
+                    while (end < pattern.size() && (pattern[end] != ']' || end == first))
+                    {
+                        const unsigned char low = static_cast<unsigned char>(pattern[end]);
+                        if (end + 2 < pattern.size() && pattern[end + 1] == '-' && pattern[end + 2] != ']')
+                        {
+                            const unsigned char high = static_cast<unsigned char>(pattern[end + 2]);
+                            for (unsigned int c = low; c <= high; ++c)
+                            {
+                                element.symbols.set(c);
+                            }
+                            end += 3;
+                        }
+                        else
+                        {
+                            element.symbols.set(low);
+                            ++end;
+                        }
+                    }
+                    //unterminated class
+                    if (end >= pattern.size())
+                    {
+                        return false;
+                    }
+                    if (negate)
+                    {
+                        element.symbols.flip();
+                    }
+                    i = end + 1;
+                }
+                else
+                {
+                    if (charr == '\\' && i + 1 < pattern.size())
+                    {
+                        ++i;
+                    }
+                    element.symbols.set(static_cast<unsigned char>(pattern[i]));
+                    ++i;
+                }
+
+                m_elements.push_back(element);
+                if (m_elements.size() > max_elements)
+                {
+                    m_elements.clear();
+                    return false;
+                }
+            }
+
+            //state 0 is the dead state, state 1 the start state
+            add_state(0);
+            m_start = add_state(closure(uint64_t(1)));
+            m_valid = true;
+            return true;
+        };
+
+        //! @brief convert the literal chars of a pattern to lower case, as the words of a dictionary are; the
+        //! classes are kept as written, so '[^A-Z]' still excludes the upper case letters only
+        //! @param pattern the given pattern
+        //! @return the pattern with its literal chars in lower case
+        static std::string lower_case_literals(const std::string& pattern)
+        {
+            std::string result(pattern);
+            std::size_t i = 0;
+            while (i < result.size())
+            {
+                if (result[i] == '[')
+                {
+                    //skip the class as compile reads it : a ']' right after '[' or '[^' is a member
+                    std::size_t end = i + 1;
+                    if (end < result.size() && result[end] == '^')
+                    {
+                        ++end;
+                    }
+                    const std::size_t first = end;
+                    while (end < result.size() && (result[end] != ']' || end == first))
+                    {
+                        ++end;
+                    }
+                    i = end + 1;
+                    continue;
+                }
+                if (result[i] == '\\' && i + 1 < result.size())
+                {
+                    ++i;
+                }
+                result[i] = static_cast<char>(::tolower(static_cast<unsigned char>(result[i])));
+                ++i;
+            }
+            return result;
+        };
+
+        //! @brief check if the pattern was compiled succesfully
+        //! @return
+        bool is_valid() const
+        {
+            return m_valid;
+        };
+
+        //! @brief get the start state of the DFA
+        //! @return
+        State start() const
+        {
+            return m_start;
+        };
+
+        //! @brief compute the state reached from a given state when reading a given char
+        //! @param state the given state
+        //! @param symbol the char read
+        //! @return the next state, dead_state if no word can match any more
+        State next(State state, char symbol)
+        {
+            const std::size_t slot = static_cast<std::size_t>(state) * 256 + static_cast<unsigned char>(symbol);
+            State result = m_transitions[slot];
+            if (result < 0)
+            {
+                result = add_state(step(m_sets[state], static_cast<unsigned char>(symbol)));
+                m_transitions[slot] = result;
+            }
+            return result;
+        };
+
+        //! @brief check if a state accepts the chars read so far
+        //! @param state the given state
+        //! @return true if the chars read so far match the whole pattern
+        bool is_accepting(State state) const
+        {
+            return (m_sets[state] >> m_elements.size()) & 1;
+        };
+
+        //! @brief check if a given word matches the pattern
+        //! @param word the given word
+        //! @return true if the word matches, false otherwise
+        bool matches(const std::string& word)
+        {
+            if (!m_valid)
+            {
+                return false;
+            }
+            State state = m_start;
+            for (auto charr : word)
+            {
+                state = next(state, charr);
+                if (state == dead_state)
+                {
+                    return false;
+                }
+            }
+            return is_accepting(state);
+        };
+
+    private:
+
+        //! @brief an element of the pattern : the set of chars it accepts, and if it may repeat
+        struct Element
+        {
+            std::bitset<256> symbols;
+            bool star = false;
+        };
+
+        //! @brief add the states reachable without reading any char : a star may match nothing
+        uint64_t closure(uint64_t set) const
+        {
+            for (std::size_t i = 0; i < m_elements.size(); ++i)
+            {
+                if (((set >> i) & 1) && m_elements[i].star)
+                {
+                    set |= uint64_t(1) << (i + 1);
+                }
+            }
+            return set;
+        };
+
+        //! @brief compute the NFA states reached from a set of states when reading a char
+        uint64_t step(uint64_t set, unsigned char symbol) const
+        {
+            uint64_t result = 0;
+            for (std::size_t i = 0; i < m_elements.size(); ++i)
+            {
+                if (((set >> i) & 1) && m_elements[i].symbols.test(symbol))
+                {
+                    result |= uint64_t(1) << (m_elements[i].star ? i : i + 1);
+                }
+            }
+            return closure(result);
+        };
+
+        //! @brief get the DFA state of a set of NFA states, creating it if needed
+        State add_state(uint64_t set)
+        {
+            auto found = m_index.find(set);
+            if (found != m_index.end())
+            {
+                return found->second;
+            }
+
+            const State state = static_cast<State>(m_sets.size());
+            m_sets.push_back(set);
+            m_transitions.resize(m_transitions.size() + 256, (state == dead_state) ? dead_state : -1);
+            m_index.emplace(set, state);
+            return state;
+        };
+
+        //! @brief the elements of the pattern
+        std::vector<Element> m_elements;
+
+        //! @brief the set of NFA states of each DFA state
+        std::vector<uint64_t> m_sets;
+
+        //! @brief the DFA transitions, 256 per state, -1 if not computed yet
+        std::vector<State> m_transitions;
+
+        //! @brief the DFA state of each known set of NFA states
+        std::unordered_map<uint64_t, State> m_index;
+
+        //! @brief the start state
+        State m_start = dead_state;
+
+        //! @brief true if the pattern was compiled succesfully
+        bool m_valid = false;
+    };
+
+    //! @brief this class streams the words of a dictionary tree matching a pattern : the tree and the
+    //! pattern automaton are walked together, depth first, and the subtrees where the automaton is
+    //! dead are skipped. Words are produced one at a time by next(), nothing is computed ahead.
+    //! The tree must not be modified while the matches are read.
+    class ZDPatternMatches
+    {
+    public:
+        //! @brief constructor
+        //! @param tree the dictionary tree
+        //! @param pattern the compiled pattern
+        ZDPatternMatches(const ZDDictionaryTree& tree, const ZDPattern& pattern)
+            : m_pattern(pattern)
+        {
+            if (m_pattern.is_valid())
+            {
+                //push the roots in reverse order, so words come out in the order of the tree
+                for (auto root = tree.feet->prev_sibling; root != tree.head; root = root->prev_sibling)
+                {
+                    m_stack.push_back(Frame{ root, m_pattern.start(), 1 });
+                }
+            }
+        };
+
+        //! @brief get the next matching word
+        //! @param word the matching word, if any
+        //! @return true if a word was found, false if there is no more matching word
+        bool next(std::string& word)
+        {
+            while (!m_stack.empty())
+            {
+                const Frame frame = m_stack.back();
+                m_stack.pop_back();
+
+                const ZDPattern::State state = m_pattern.next(frame.parent_state, frame.node->data.letter);
+                if (state == ZDPattern::dead_state)
+                {
+                    continue;
+                }
+
+                m_path.resize(frame.depth - 1);
+                m_path.push_back(frame.node->data.letter);
+
+                for (auto child = frame.node->last_child; child != 0; child = child->prev_sibling)
+                {
+                    m_stack.push_back(Frame{ child, state, frame.depth + 1 });
+                }
+
+                if (frame.node->data.terminal && m_pattern.is_accepting(state))
+                {
+                    word = m_path;
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        //! @brief read all the remaining matching words
+        //! @return
+        std::vector<std::string> all()
+        {
+            std::vector<std::string> result;
+            std::string word;
+            while (next(word))
+            {
+                result.push_back(word);
+            }
+            return result;
+        };
+
+    private:
+
+        //! @brief a node to visit, with the state of the automaton on its parent
+        struct Frame
+        {
+            const TreeNode<ZDNodeData>* node;
+            ZDPattern::State parent_state;
+            std::size_t depth;
+        };
+
+        //! @brief the pattern, its DFA grows during the walk
+        ZDPattern m_pattern;
+
+        //! @brief the nodes to visit
+        std::vector<Frame> m_stack;
+
+        //! @brief the chars of the current path
+        std::string m_path;
+    };
+}
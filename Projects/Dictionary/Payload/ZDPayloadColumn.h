@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Dico
+{
+    //! @brief this class stores one value of a given type per word of a dictionary, indexed by the word id
+    //! (see ZDDictionary::word_id). The values are stored in one array, so the memory used is
+    //! sizeof(T) per word, the word itself being only stored in the dictionary.
+    //! A word keeps its id while other words are inserted or removed, so its value stays in place : after
+    //! inserting words, resize the column to ZDDictionary::id_capacity(); the id of a removed word is given
+    //! to the next word inserted, whose value is then to be set.
+    template<class T>
+    class ZDPayloadColumn
+    {
+    public:
+        //! @brief defaut constructor, empty column
+        ZDPayloadColumn() = default;
+
+        //! @brief build a column for a given number of words
+        //! @param size the number of words, typicaly ZDDictionary::id_capacity()
+        //! @param value the initial value of each word
+        explicit ZDPayloadColumn(std::size_t size, const T& value = T())
+            : m_values(size, value)
+        {
+        };
+
+        //! @brief change the number of words, new words get a given value
+        //! @param size the new number of words
+        //! @param value the value of the new words
+        void resize(std::size_t size, const T& value = T())
+        {
+            const bool shrinking = size < m_values.size();
+            m_values.resize(size, value);
+            if (shrinking)
+            {
+                m_values.shrink_to_fit();
+            }
+        };
+
+        //! @brief get the value of a word
+        //! @param id the id of the word
+        //! @return
+        T& operator[](uint32_t id)
+        {
+            return m_values[id];
+        };
+
+        //! @brief get the value of a word
+        //! @param id the id of the word
+        //! @return
+        const T& operator[](uint32_t id) const
+        {
+            return m_values[id];
+        };
+
+        //! @brief get the number of words
+        //! @return
+        std::size_t size() const
+        {
+            return m_values.size();
+        };
+
+        //! @brief get the values, in word id order
+        //! @return
+        const T* data() const
+        {
+            return m_values.data();
+        };
+
+    private:
+        //! @brief the values, in word id order
+        std::vector<T> m_values;
+    };
+}
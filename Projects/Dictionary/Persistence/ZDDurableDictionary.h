@@ -0,0 +1,438 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ZDDictionary.h"
+#include "Persistence/ZDWriteAheadLog.h"
+
+namespace Dico
+{
+    //! @brief the settings of a durable dictionary
+    struct ZDDurableOptions
+    {
+        //! @brief true to return from a change only once it is durable, the dictionary holding durable changes only;
+        //! false to return at once, the change being durable a few milliseconds later (see sync)
+        bool wait_durable = true;
+
+        //! @brief the size of the log above which it is folded into a new snapshot, which bounds the recovery time
+        uint64_t compaction_size = 8 << 20;
+    };
+
+    //! @brief this class is a dictionary whose changes survive a restart. The directory holds a snapshot of the
+    //! dictionary (see ZDDictionary::save) and the write-ahead logs of the changes made since (see
+    //! ZDWriteAheadLog) : "snapshot.<n>" holds the changes of the logs before generation n, and "log.<n>",
+    //! "log.<n+1>"... the following ones. On open the newest snapshot is loaded and its logs replayed on top.
+    //! When the current log grows past a given size, a new log is started and a thread of its own folds the
+    //! previous ones into a new snapshot, built apart from the dictionary in use, then removes them.
+    //! Linux only.
+    class ZDDurableDictionary
+    {
+    public:
+        //! @brief defaut constructor, closed
+        ZDDurableDictionary() = default;
+
+        //! @brief distructor, close
+        ~ZDDurableDictionary()
+        {
+            close();
+        };
+
+        ZDDurableDictionary(const ZDDurableDictionary&) = delete;
+        ZDDurableDictionary& operator=(const ZDDurableDictionary&) = delete;
+
+        //! @brief open a durable dictionary : load its snapshot and replay its logs
+        //! @param directory the directory of the files, it must exist
+        //! @param base the dictionary to start with if the directory holds no snapshot yet (typicaly the lexico)
+        //! @param options the settings
+        //! @return true if succes, false otherwise
+        bool open(const std::string& directory, const ZDDictionary& base, const ZDDurableOptions& options = ZDDurableOptions())
+        {
+            close();
+            m_directory = directory;
+            m_options = options;
+
+            //the newest snapshot, the older files are leftovers of an interrupted compaction
+            std::vector<uint64_t> snapshots;
+            std::vector<uint64_t> logs;
+            list_files(snapshots, logs);
+            if (snapshots.empty())
+            {
+                if (!write_snapshot(base, 0))
+                {
+                    return false;
+                }
+                snapshots.push_back(0);
+            }
+            m_snapshot = *std::max_element(snapshots.begin(), snapshots.end());
+
+            if (!m_dictionary.load(snapshot_path(m_snapshot)))
+            {
+                return false;
+            }
+
+            m_generation = m_snapshot;
+            for (auto generation : logs)
+            {
+                if (generation >= m_snapshot)
+                {
+                    uint64_t end = 0;
+                    ZDWriteAheadLog::replay(log_path(generation), [this](const ZDChange& change) { apply(m_dictionary, change); }, end);
+                    m_generation = std::max(m_generation, generation);
+                }
+            }
+            remove_before(m_snapshot);
+
+            if (!m_log.open(log_path(m_generation)))
+            {
+                return false;
+            }
+
+            m_turns = 0;
+            m_applied = 0;
+            m_stop = false;
+            m_compactor = std::thread([this]() { compaction_loop(); });
+            return true;
+        };
+
+        //! @brief make the changes durable, wait for a running compaction, and close the files
+        void close()
+        {
+            if (m_compactor.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_compactionMutex);
+                    m_stop = true;
+                }
+                m_compactionReady.notify_all();
+                m_compactor.join();
+            }
+            m_log.close();
+        };
+
+        //! @brief insert a new word to the dictionary
+        //! @param word the given word to be inserted
+        //! @return return true if succes, false otherwise
+        bool insert_word(const std::string& word)
+        {
+            ZDChange change;
+            change.word = word;
+            return change_word(change);
+        };
+
+        //! @brief insert a new word to the dictionary with a weight, if the word already exists its weight is replaced
+        //! @param word the given word to be inserted
+        //! @param weight the weight of the word
+        //! @return return true if succes, false otherwise
+        bool insert_word(const std::string& word, uint32_t weight)
+        {
+            ZDChange change;
+            change.word = word;
+            change.weighted = true;
+            change.weight = weight;
+            return change_word(change);
+        };
+
+        //! @brief remove a word from the dictionary
+        //! @param word the word to be removed
+        //! @return true if succes , false otherwise
+        bool remove_word(const std::string& word)
+        {
+            ZDChange change;
+            change.insert = false;
+            change.word = word;
+            return change_word(change);
+        };
+
+        //! @brief read the dictionary, changes wait meanwhile
+        //! @param reader called with the dictionary
+        //! @return the value returned by the reader
+        template<class Reader>
+        auto read(Reader reader) const -> decltype(reader(std::declval<const ZDDictionary&>()))
+        {
+            std::shared_lock<std::shared_mutex> lock(m_dictionaryMutex);
+            return reader(static_cast<const ZDDictionary&>(m_dictionary));
+        };
+
+        //! @brief wait for all the changes to be durable
+        //! @return true if succes, false otherwise
+        bool sync()
+        {
+            return m_log.sync();
+        };
+
+        //! @brief fold the logs into a new snapshot now, and wait for it
+        //! @return true if succes, false otherwise
+        bool compact()
+        {
+            std::lock_guard<std::mutex> compacting(m_compactingMutex);
+            return fold();
+        };
+
+    private:
+
+        //! @brief apply a change to a dictionary
+        static bool apply(ZDDictionary& dictionary, const ZDChange& change)
+        {
+            if (!change.insert)
+            {
+                return dictionary.remove_word(change.word);
+            }
+            return change.weighted ? dictionary.insert_word(change.word, change.weight) : dictionary.insert_word(change.word);
+        };
+
+        //! @brief log a change and apply it. When waiting for durability, the change is applied once its record is
+        //! durable, in the order of the log, so a change which can not be logged is never seen; otherwise it is
+        //! applied at once and logged after, the log following the order of the changes.
+        bool change_word(const ZDChange& change)
+        {
+            if (!ZDWriteAheadLog::accepts(change))
+            {
+                return false;
+            }
+
+            bool result = false;
+            if (m_options.wait_durable)
+            {
+                uint64_t sequence = 0;
+                uint64_t turn = 0;
+                {
+                    std::lock_guard<std::mutex> lock(m_turnMutex);
+                    sequence = m_log.append(change);
+                    turn = ++m_turns;
+                }
+                const bool durable = m_log.wait(sequence);
+
+                //the changes logged before are applied first, whether they were durable or not
+                std::unique_lock<std::mutex> lock(m_turnMutex);
+                m_turnReady.wait(lock, [&]() { return m_applied + 1 == turn; });
+                if (durable)
+                {
+                    std::unique_lock<std::shared_mutex> dictionaryLock(m_dictionaryMutex);
+                    result = apply(m_dictionary, change);
+                }
+                m_applied = turn;
+                m_turnReady.notify_all();
+            }
+            else
+            {
+                std::unique_lock<std::shared_mutex> lock(m_dictionaryMutex);
+                result = apply(m_dictionary, change);
+                if (result)
+                {
+                    m_log.append(change);
+                }
+            }
+
+            if (m_log.size() > m_options.compaction_size)
+            {
+                m_compactionReady.notify_one();
+            }
+            return result;
+        };
+
+        //! @brief fold the logs when they grow too large, until closed
+        void compaction_loop()
+        {
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_compactionMutex);
+                    m_compactionReady.wait(lock, [&]() { return m_stop || m_log.size() > m_options.compaction_size; });
+                    if (m_stop)
+                    {
+                        return;
+                    }
+                }
+
+                std::lock_guard<std::mutex> compacting(m_compactingMutex);
+                if (m_log.size() > m_options.compaction_size)
+                {
+                    fold();
+                }
+            }
+        };
+
+        //! @brief start a new log, then build the snapshot of the previous ones apart from the dictionary in use
+        bool fold()
+        {
+            //the log cuts the records itself, so the changes go on while the old log is synced and the new one created
+            uint64_t generation = 0;
+            {
+                std::shared_lock<std::shared_mutex> lock(m_dictionaryMutex);
+                generation = m_generation + 1;
+            }
+            if (!m_log.rotate(log_path(generation)))
+            {
+                return false;
+            }
+            {
+                std::unique_lock<std::shared_mutex> lock(m_dictionaryMutex);
+                m_generation = generation;
+            }
+
+            ZDDictionary folded;
+            if (!folded.load(snapshot_path(m_snapshot)))
+            {
+                return false;
+            }
+            for (uint64_t log = m_snapshot; log < generation; ++log)
+            {
+                uint64_t end = 0;
+                ZDWriteAheadLog::replay(log_path(log), [&folded](const ZDChange& change) { apply(folded, change); }, end);
+            }
+
+            if (!write_snapshot(folded, generation))
+            {
+                return false;
+            }
+            m_snapshot = generation;
+            remove_before(generation);
+            return true;
+        };
+
+        //! @brief write a snapshot durably : to a temporary file, synced, then renamed
+        bool write_snapshot(const ZDDictionary& dictionary, uint64_t generation) const
+        {
+            const std::string path = snapshot_path(generation);
+            const std::string temporary = path + ".tmp";
+            if (!dictionary.save(temporary) || !sync_path(temporary, O_RDONLY))
+            {
+                return false;
+            }
+            return std::rename(temporary.c_str(), path.c_str()) == 0 && sync_path(m_directory, O_RDONLY | O_DIRECTORY);
+        };
+
+        //! @brief flush a file or a directory to the disk
+        static bool sync_path(const std::string& path, int flags)
+        {
+            const int file = ::open(path.c_str(), flags | O_CLOEXEC);
+            if (file < 0)
+            {
+                return false;
+            }
+            const bool result = ::fsync(file) == 0;
+            ::close(file);
+            return result;
+        };
+
+        //! @brief find the generations of the snapshots and of the logs of the directory
+        void list_files(std::vector<uint64_t>& snapshots, std::vector<uint64_t>& logs) const
+        {
+            DIR* directory = ::opendir(m_directory.c_str());
+            if (directory == 0)
+            {
+                return;
+            }
+            while (const dirent* entry = ::readdir(directory))
+            {
+                uint64_t generation = 0;
+                if (parse_name(entry->d_name, "snapshot.", generation))
+                {
+                    snapshots.push_back(generation);
+                }
+                else if (parse_name(entry->d_name, "log.", generation))
+                {
+                    logs.push_back(generation);
+                }
+            }
+            ::closedir(directory);
+            std::sort(logs.begin(), logs.end());
+        };
+
+        //! @brief read the generation of a file name "<prefix><generation>"
+        static bool parse_name(const std::string& name, const std::string& prefix, uint64_t& generation)
+        {
+            if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+            {
+                return false;
+            }
+            generation = 0;
+            for (std::size_t i = prefix.size(); i < name.size(); ++i)
+            {
+                if (name[i] < '0' || name[i] > '9')
+                {
+                    return false;
+                }
+                generation = generation * 10 + static_cast<uint64_t>(name[i] - '0');
+            }
+            return true;
+        };
+
+        //! @brief remove the snapshots and the logs older than a generation
+        void remove_before(uint64_t generation) const
+        {
+            std::vector<uint64_t> snapshots;
+            std::vector<uint64_t> logs;
+            list_files(snapshots, logs);
+            for (auto snapshot : snapshots)
+            {
+                if (snapshot < generation)
+                {
+                    std::remove(snapshot_path(snapshot).c_str());
+                }
+            }
+            for (auto log : logs)
+            {
+                if (log < generation)
+                {
+                    std::remove(log_path(log).c_str());
+                }
+            }
+        };
+
+        //! @brief the path of a snapshot
+        std::string snapshot_path(uint64_t generation) const
+        {
+            return m_directory + "/snapshot." + std::to_string(generation);
+        };
+
+        //! @brief the path of a log
+        std::string log_path(uint64_t generation) const
+        {
+            return m_directory + "/log." + std::to_string(generation);
+        };
+
+        //! @brief the directory of the files
+        std::string m_directory;
+
+        //! @brief the settings
+        ZDDurableOptions m_options;
+
+        //! @brief the dictionary, and its lock : shared by readers, exclusive for changes
+        ZDDictionary m_dictionary;
+        mutable std::shared_mutex m_dictionaryMutex;
+
+        //! @brief the log of the changes
+        ZDWriteAheadLog m_log;
+
+        //! @brief when waiting for durability : the number of changes logged and applied, the changes being applied
+        //! in the order of the log
+        std::mutex m_turnMutex;
+        std::condition_variable m_turnReady;
+        uint64_t m_turns = 0;
+        uint64_t m_applied = 0;
+
+        //! @brief the generation of the current log, and of the snapshot
+        uint64_t m_generation = 0;
+        uint64_t m_snapshot = 0;
+
+        //! @brief the compaction thread, woken up when the log grows too large
+        std::thread m_compactor;
+        std::mutex m_compactionMutex;
+        std::condition_variable m_compactionReady;
+        bool m_stop = false;
+
+        //! @brief one compaction at a time
+        std::mutex m_compactingMutex;
+    };
+}
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Serialization/ZDBinaryIO.h"
+#include "Update/ZDDelta.h"
+
+namespace Dico
+{
+    //! @brief this class is an append-only log of dictionary changes, written before the changes are considered
+    //! done. Records are buffered and written by a thread of its own, which makes them durable with one fsync per
+    //! batch : while a fsync runs, the next records gather, so many writers share the cost of a fsync (group commit).
+    //! The file starts with a header, then each record is : uint32 size, uint32 CRC of the payload, the payload
+    //! (uint8 kind, uint32 weight, the word). A record cut by a crash, or corrupted, ends the log at replay.
+    //! Linux only (POSIX file descriptors).
+    class ZDWriteAheadLog
+    {
+    public:
+        //! @brief defaut constructor, no file
+        ZDWriteAheadLog() = default;
+
+        //! @brief distructor, write the buffered records and close the file
+        ~ZDWriteAheadLog()
+        {
+            close();
+        };
+
+        ZDWriteAheadLog(const ZDWriteAheadLog&) = delete;
+        ZDWriteAheadLog& operator=(const ZDWriteAheadLog&) = delete;
+
+        //! @brief read the changes of a log file
+        //! @param path the path of the log file
+        //! @param callback called with each change, in order
+        //! @param end the size of the valid part of the file, the rest being a torn or corrupted record
+        //! @return true if succes, false if the file can not be read or has a bad header
+        static bool replay(const std::string& path, const std::function<void(const ZDChange&)>& callback, uint64_t& end)
+        {
+            end = 0;
+            std::ifstream file(path, std::ios::binary);
+            uint32_t version = 0;
+            if (!file.is_open() || !read_header(file, magic, version, file_version))
+            {
+                return false;
+            }
+            end = header_size;
+
+            std::string payload;
+            ZDChange change;
+            while (true)
+            {
+                uint32_t size = 0;
+                uint32_t crc = 0;
+                if (!read_pod(file, size) || !read_pod(file, crc) || size < payload_header || size > payload_header + max_word)
+                {
+                    break;
+                }
+                payload.resize(size);
+                file.read(&payload[0], size);
+                if (!file || crc32(payload.data(), payload.size()) != crc || !decode(payload, change))
+                {
+                    break;
+                }
+
+                callback(change);
+                end += sizeof(size) + sizeof(crc) + size;
+            }
+            return true;
+        };
+
+        //! @brief open a log file to append records, creating it if needed; a torn record at its end is removed
+        //! @param path the path of the log file
+        //! @return true if succes, false otherwise
+        bool open(const std::string& path)
+        {
+            close();
+
+            //a file shorter than the header is a log created by a crash before its header was written, started again
+            uint64_t end = 0;
+            struct stat status;
+            const bool exists = ::stat(path.c_str(), &status) == 0 && static_cast<uint64_t>(status.st_size) >= header_size;
+            if (exists && !replay(path, [](const ZDChange&) {}, end))
+            {
+                return false;
+            }
+
+            m_file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+            if (m_file < 0)
+            {
+                return false;
+            }
+
+            if (!exists)
+            {
+                std::string header;
+                append_header(header);
+                end = header.size();
+                if (::ftruncate(m_file, 0) != 0 || !write_all(m_file, header) || ::fdatasync(m_file) != 0)
+                {
+                    close();
+                    return false;
+                }
+            }
+            else if (::ftruncate(m_file, static_cast<off_t>(end)) != 0)
+            {
+                close();
+                return false;
+            }
+
+            ::lseek(m_file, static_cast<off_t>(end), SEEK_SET);
+            m_size = end;
+            m_failed = false;
+            m_stop = false;
+            m_thread = std::thread([this]() { loop(); });
+            return true;
+        };
+
+        //! @brief write the buffered records, wait for them to be durable, and close the file
+        void close()
+        {
+            if (m_thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_pendingReady.notify_all();
+                m_thread.join();
+            }
+            if (m_file >= 0)
+            {
+                ::close(m_file);
+                m_file = -1;
+            }
+        };
+
+        //! @brief add a change to the log, it becomes durable a little later (see wait)
+        //! @param change the given change, its word at most max_word bytes (see accepts)
+        //! @return the sequence number of the record
+        uint64_t append(const ZDChange& change)
+        {
+            assert(accepts(change));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            encode(change, m_pending);
+            const uint64_t sequence = ++m_appended;
+            m_pendingReady.notify_one();
+            return sequence;
+        };
+
+        //! @brief wait for a record to be durable
+        //! @param sequence the sequence number of the record
+        //! @return true if succes, false if the log can not be written anymore
+        bool wait(uint64_t sequence)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_durableReady.wait(lock, [&]() { return m_durable >= sequence || m_failed; });
+            return m_durable >= sequence;
+        };
+
+        //! @brief wait for all the records appended to be durable
+        //! @return true if succes, false if the log can not be written anymore
+        bool sync()
+        {
+            uint64_t sequence = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                sequence = m_appended;
+            }
+            return wait(sequence);
+        };
+
+        //! @brief go on in a new file : the records appended before the call end the old one, left complete for
+        //! compaction, and the following ones go to the new one. The appends are not blocked meanwhile, the writing
+        //! thread making the switch once the old records are durable.
+        //! @param path the path of the new log file
+        //! @return true if succes, false otherwise
+        bool rotate(const std::string& path)
+        {
+            if (!m_thread.joinable())
+            {
+                return false;
+            }
+
+            const int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            std::string header;
+            append_header(header);
+            if (file < 0 || !write_all(file, header) || ::fdatasync(file) != 0)
+            {
+                if (file >= 0)
+                {
+                    ::close(file);
+                }
+                return false;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_rotated.swap(m_pending);
+            m_rotatedSequence = m_appended;
+            m_next = file;
+            m_pendingReady.notify_one();
+            m_durableReady.wait(lock, [&]() { return m_next < 0 || m_failed; });
+            if (m_next >= 0)
+            {
+                ::close(m_next);
+                m_next = -1;
+            }
+            return !m_failed;
+        };
+
+        //! @brief the largest word of a record
+        static constexpr uint32_t max_word = 1 << 16;
+
+        //! @brief check that a change fits in a record : a longer word would be replayed cut
+        //! @param change the given change
+        //! @return true if the change can be appended
+        static bool accepts(const ZDChange& change)
+        {
+            return change.word.size() <= max_word;
+        };
+
+        //! @brief get the size of the log file, durable records only
+        //! @return
+        uint64_t size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_size;
+        };
+
+    private:
+
+        //! @brief the file type and version of the log
+        static constexpr char magic[5] = "ZDWL";
+        static constexpr uint32_t file_version = 1;
+        static constexpr std::size_t header_size = 8;
+
+        //! @brief the kinds of records
+        static constexpr uint8_t kind_insert = 1;
+        static constexpr uint8_t kind_insert_weighted = 2;
+        static constexpr uint8_t kind_remove = 3;
+
+        //! @brief the size of the payload before the word
+        static constexpr uint32_t payload_header = 5;
+
+        //! @brief write the pending records and make them durable, and switch to the next file of a rotation,
+        //! until closed
+        void loop()
+        {
+            std::string batch;
+            while (true)
+            {
+                uint64_t sequence = 0;
+                int next = -1;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_pendingReady.wait(lock, [&]() { return m_stop || !m_pending.empty() || m_next >= 0; });
+                    batch.clear();
+                    if (m_next >= 0)
+                    {
+                        //the records appended before the rotation end the old file
+                        batch.swap(m_rotated);
+                        sequence = m_rotatedSequence;
+                        next = m_next;
+                    }
+                    else if (m_pending.empty())
+                    {
+                        return;
+                    }
+                    else
+                    {
+                        batch.swap(m_pending);
+                        sequence = m_appended;
+                    }
+                }
+
+                const bool written = write_all(m_file, batch) && ::fdatasync(m_file) == 0;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (written && next >= 0)
+                    {
+                        ::close(m_file);
+                        m_file = next;
+                        m_next = -1;
+                        m_durable = sequence;
+                        m_size = header_size;
+                    }
+                    else if (written)
+                    {
+                        m_durable = sequence;
+                        m_size += batch.size();
+                    }
+                    else
+                    {
+                        m_failed = true;
+                    }
+                }
+                m_durableReady.notify_all();
+                if (!written)
+                {
+                    return;
+                }
+            }
+        };
+
+        //! @brief write the header of a log file to a buffer
+        static void append_header(std::string& buffer)
+        {
+            std::ostringstream header;
+            write_header(header, magic, file_version);
+            buffer += header.str();
+        };
+
+        //! @brief append a record to a buffer
+        static void encode(const ZDChange& change, std::string& buffer)
+        {
+            const uint8_t kind = !change.insert ? kind_remove : (change.weighted ? kind_insert_weighted : kind_insert);
+            const uint32_t size = payload_header + static_cast<uint32_t>(std::min<std::size_t>(change.word.size(), max_word));
+
+            std::string payload;
+            payload.reserve(size);
+            payload.push_back(static_cast<char>(kind));
+            payload.append(reinterpret_cast<const char*>(&change.weight), sizeof(change.weight));
+            payload.append(change.word, 0, size - payload_header);
+
+            const uint32_t crc = crc32(payload.data(), payload.size());
+            buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            buffer.append(reinterpret_cast<const char*>(&crc), sizeof(crc));
+            buffer += payload;
+        };
+
+        //! @brief read the change of a record payload
+        static bool decode(const std::string& payload, ZDChange& change)
+        {
+            const uint8_t kind = static_cast<uint8_t>(payload[0]);
+            if (kind < kind_insert || kind > kind_remove)
+            {
+                return false;
+            }
+            change.insert = kind != kind_remove;
+            change.weighted = kind == kind_insert_weighted;
+            std::memcpy(&change.weight, payload.data() + 1, sizeof(change.weight));
+            change.word.assign(payload, payload_header, std::string::npos);
+            return true;
+        };
+
+        //! @brief write a whole buffer to a file
+        static bool write_all(int file, const std::string& buffer)
+        {
+            std::size_t written = 0;
+            while (written < buffer.size())
+            {
+                const ssize_t size = ::write(file, buffer.data() + written, buffer.size() - written);
+                if (size < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                written += static_cast<std::size_t>(size);
+            }
+            return true;
+        };
+
+        //! @brief the log file, only used by the writing thread while it runs
+        int m_file = -1;
+
+        //! @brief the size of the log file, durable records only
+        uint64_t m_size = 0;
+
+        //! @brief the records not yet written
+        std::string m_pending;
+
+        //! @brief during a rotation : the next file, the records to write to the old one, and the sequence number of
+        //! the last of them
+        int m_next = -1;
+        std::string m_rotated;
+        uint64_t m_rotatedSequence = 0;
+
+        //! @brief the sequence number of the last record appended, and of the last durable one
+        uint64_t m_appended = 0;
+        uint64_t m_durable = 0;
+
+        //! @brief true once a write failed, the log is then stopped
+        bool m_failed = false;
+
+        //! @brief true to stop the writing thread
+        bool m_stop = false;
+
+        //! @brief protect the members above
+        mutable std::mutex m_mutex;
+
+        //! @brief signal new records to the writing thread, and durable records to the waiting writers
+        std::condition_variable m_pendingReady;
+        std::condition_variable m_durableReady;
+
+        //! @brief the writing thread
+        std::thread m_thread;
+    };
+}
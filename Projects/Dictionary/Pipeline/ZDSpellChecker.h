@@ -0,0 +1,556 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <istream>
+#include <algorithm>
+#include <unordered_map>
+#include <deque>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include "ZDDictionary.h"
+
+namespace Dico
+{
+    //! @brief a misspelled word found in a text
+    struct ZDSpellRecord
+    {
+        uint64_t offset = 0;                        //!< offset of the word in the text, in bytes
+        uint32_t length = 0;                        //!< length of the word, in bytes
+        std::vector<std::string> suggestions;       //!< the closest words of the dictionary, by decreasing weight
+    };
+
+    //! @brief the settings of a spell check
+    struct ZDSpellOptions
+    {
+        int max_error = 2;                          //!< the maximum number of errors of a suggestion
+        std::size_t max_suggestions = 5;            //!< the maximum number of suggestions of a word
+        std::size_t chunk_size = 1 << 20;           //!< the number of bytes read at once
+        unsigned int threads = 1;                   //!< the number of chunks checked in parallel
+    };
+
+    //! @brief a word of a text, made of letters. Words joined by hyphens or apostrophes form a group
+    //! ("peut-être", "aujourd'hui") which is checked as a whole before its words are checked alone.
+    struct ZDToken
+    {
+        uint64_t offset = 0;                        //!< offset of the word in the text, in bytes
+        uint32_t length = 0;                        //!< length of the word, in bytes
+        uint32_t group = 0;                         //!< index of the group of the word in the chunk
+        bool elided = false;                        //!< true if the word is followed by an apostrophe ("l'", "qu'")
+        std::string word;                           //!< the normalized word : lower case, typographic apostrophes replaced
+    };
+
+    //! @brief this class splits UTF-8 text into French words. Letters are the ASCII letters and the code points
+    //! of the latin, greek and cyrillic blocks; words are split on any other char, and groups of words on
+    //! anything but a hyphen or an apostrophe between two words.
+    class ZDTokenizer
+    {
+    public:
+        //! @brief split a chunk of text into words
+        //! @param text the chunk of text, it must not end inside a group of words
+        //! @param size the size of the chunk, in bytes
+        //! @param offset the offset of the chunk in the whole text
+        //! @param tokens the words found, appended
+        //! @param groups the normalized groups of words found, appended; a group of a single word is empty
+        static void split(const char* text, std::size_t size, uint64_t offset, std::vector<ZDToken>& tokens, std::vector<std::string>& groups)
+        {
+            std::size_t i = 0;
+            while (i < size)
+            {
+                std::size_t length = 0;
+                const uint32_t code = decode(text + i, size - i, length);
+                if (!is_letter(code))
+                {
+                    i += length;
+                    continue;
+                }
+
+                //a group of words joined by hyphens and apostrophes
+                const std::size_t firstToken = tokens.size();
+                const uint32_t group = static_cast<uint32_t>(groups.size());
+                std::string joined;
+                while (true)
+                {
+                    ZDToken token;
+                    token.offset = offset + i;
+                    token.group = group;
+                    while (i < size)
+                    {
+                        const uint32_t letter = decode(text + i, size - i, length);
+                        if (!is_letter(letter))
+                        {
+                            break;
+                        }
+                        append_lower(text + i, length, token.word);
+                        i += length;
+                    }
+                    token.length = static_cast<uint32_t>(offset + i - token.offset);
+                    joined += token.word;
+
+                    //a joining char followed by a letter continues the group
+                    std::size_t joinLength = 0;
+                    const uint32_t join = (i < size) ? decode(text + i, size - i, joinLength) : 0;
+                    std::size_t nextLength = 0;
+                    const bool joinedNext = (is_hyphen(join) || is_apostrophe(join)) && i + joinLength < size
+                        && is_letter(decode(text + i + joinLength, size - i - joinLength, nextLength));
+
+                    token.elided = joinedNext && is_apostrophe(join);
+                    tokens.push_back(std::move(token));
+                    if (!joinedNext)
+                    {
+                        break;
+                    }
+
+                    joined.push_back(is_apostrophe(join) ? '\'' : '-');
+                    i += joinLength;
+                }
+
+                groups.push_back((tokens.size() - firstToken > 1) ? joined : std::string());
+            }
+        };
+
+        //! @brief find where a chunk of text can be cut without splitting a group of words : after its last
+        //! ASCII white space, or else after its last char which is neither a letter nor a joining char
+        //! @param text the chunk of text
+        //! @param size the size of the chunk, in bytes
+        //! @return the size of the part to be checked, 0 if the chunk is a single group of words
+        static std::size_t cut(const char* text, std::size_t size)
+        {
+            for (std::size_t i = size; i > 0; --i)
+            {
+                const char c = text[i - 1];
+                if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+                {
+                    return i;
+                }
+            }
+
+            //no white space : the last punctuation, a malformed byte being no boundary since the chunk may end
+            //inside a code point
+            std::size_t result = 0;
+            std::size_t i = 0;
+            while (i < size)
+            {
+                std::size_t length = 0;
+                const uint32_t code = decode(text + i, size - i, length);
+                i += length;
+                if (code != 0xFFFD && !is_letter(code) && !is_hyphen(code) && !is_apostrophe(code))
+                {
+                    result = i;
+                }
+            }
+            return result;
+        };
+
+        //! @brief decode the UTF-8 code point at a position, a malformed sequence is one invalid byte
+        //! @param text the given position
+        //! @param size the number of bytes left
+        //! @param length the number of bytes of the code point
+        //! @return the code point, 0xFFFD if malformed
+        static inline uint32_t decode(const char* text, std::size_t size, std::size_t& length)
+        {
+            const unsigned char lead = static_cast<unsigned char>(text[0]);
+            length = 1;
+            if (lead < 0x80)
+            {
+                return lead;
+            }
+
+            std::size_t count = 0;
+            uint32_t code = 0;
+            if ((lead & 0xE0) == 0xC0) { count = 1; code = lead & 0x1F; }
+            else if ((lead & 0xF0) == 0xE0) { count = 2; code = lead & 0x0F; }
+            else if ((lead & 0xF8) == 0xF0) { count = 3; code = lead & 0x07; }
+            else { return 0xFFFD; }
+
+            if (count >= size)
+            {
+                return 0xFFFD;
+            }
+            for (std::size_t b = 1; b <= count; ++b)
+            {
+                const unsigned char next = static_cast<unsigned char>(text[b]);
+                if ((next & 0xC0) != 0x80)
+                {
+                    return 0xFFFD;
+                }
+                code = (code << 6) | (next & 0x3F);
+            }
+            length = count + 1;
+            return code;
+        };
+
+        //! @brief true if a code point is a letter
+        static inline bool is_letter(uint32_t code)
+        {
+            if (code < 0x80)
+            {
+                return (code >= 'a' && code <= 'z') || (code >= 'A' && code <= 'Z');
+            }
+            //latin-1 letters, latin extended, IPA, greek, cyrillic, but not the signs × and ÷
+            return (code >= 0xC0 && code <= 0x52F && code != 0xD7 && code != 0xF7) || code == 0xAA || code == 0xB5 || code == 0xBA
+                || (code >= 0x1E00 && code <= 0x1EFF);
+        };
+
+        //! @brief true if a code point is an apostrophe : ' or ’
+        static inline bool is_apostrophe(uint32_t code)
+        {
+            return code == '\'' || code == 0x2019 || code == 0x02BC;
+        };
+
+        //! @brief true if a code point is a hyphen
+        static inline bool is_hyphen(uint32_t code)
+        {
+            return code == '-' || code == 0x2010 || code == 0x2011;
+        };
+
+    private:
+        //! @brief append a letter to a word, in lower case for the ASCII and latin-1 letters
+        static inline void append_lower(const char* letter, std::size_t length, std::string& word)
+        {
+            const unsigned char lead = static_cast<unsigned char>(letter[0]);
+            if (length == 1)
+            {
+                word.push_back(static_cast<char>(::tolower(lead)));
+            }
+            else if (length == 2 && lead == 0xC3 && static_cast<unsigned char>(letter[1]) >= 0x80 && static_cast<unsigned char>(letter[1]) <= 0x9E
+                && static_cast<unsigned char>(letter[1]) != 0x97)
+            {
+                //U+00C0..U+00DE : the lower case letter is 0x20 further
+                word.push_back(letter[0]);
+                word.push_back(static_cast<char>(static_cast<unsigned char>(letter[1]) + 0x20));
+            }
+            else
+            {
+                word.append(letter, length);
+            }
+        };
+    };
+
+    //! @brief this class spell checks a text against a dictionary, reading it chunk by chunk so the memory used
+    //! does not depend on the size of the text. Each chunk is split into words (see ZDTokenizer), the distinct
+    //! words of the chunk are looked up in one sorted batch, and the fuzzy search for suggestions only runs for
+    //! the words not found. With several threads, chunks are checked in parallel and the records are still
+    //! produced in the order of the text.
+    //! The dictionary must not be modified during a check.
+    class ZDSpellChecker
+    {
+    public:
+        //! @brief the function called with each misspelled word, in the order of the text
+        typedef std::function<void(const ZDSpellRecord&)> Sink;
+
+        //! @brief build a spell checker
+        //! @param dictionary the given dictionary
+        //! @param options the settings of the checks
+        ZDSpellChecker(const ZDDictionary& dictionary, const ZDSpellOptions& options = ZDSpellOptions())
+            : m_dictionary(dictionary)
+            , m_options(options)
+        {
+            m_options.chunk_size = std::max<std::size_t>(m_options.chunk_size, 1);
+            m_options.threads = std::max(m_options.threads, 1u);
+        };
+
+        //! @brief check a text read from a stream
+        //! @param in the given stream
+        //! @param sink called with each misspelled word, in the order of the text
+        //! @return the number of misspelled words
+        uint64_t check(std::istream& in, const Sink& sink) const
+        {
+            return (m_options.threads > 1) ? check_parallel(in, sink) : check_serial(in, sink);
+        };
+
+        //! @brief check a text held in memory
+        //! @param text the given text
+        //! @return the misspelled words, in the order of the text
+        std::vector<ZDSpellRecord> check(const std::string& text) const
+        {
+            std::vector<ZDSpellRecord> result;
+            check_chunk(text.data(), text.size(), 0, result);
+            return result;
+        };
+
+        //! @brief check a chunk of text
+        //! @param text the chunk of text, it must not end inside a group of words
+        //! @param size the size of the chunk, in bytes
+        //! @param offset the offset of the chunk in the whole text
+        //! @param records the misspelled words, appended in the order of the text
+        void check_chunk(const char* text, std::size_t size, uint64_t offset, std::vector<ZDSpellRecord>& records) const
+        {
+            std::vector<ZDToken> tokens;
+            std::vector<std::string> groups;
+            ZDTokenizer::split(text, size, offset, tokens, groups);
+
+            //first batch : the groups and the single words
+            std::unordered_map<std::string, bool> known;
+            std::vector<std::string> keys;
+            for (const auto& group : groups)
+            {
+                if (!group.empty())
+                {
+                    keys.push_back(group);
+                }
+            }
+            for (const auto& token : tokens)
+            {
+                if (groups[token.group].empty())
+                {
+                    keys.push_back(token.word);
+                }
+            }
+            lookup(keys, known);
+
+            //second batch : the words of the groups not found
+            keys.clear();
+            for (const auto& token : tokens)
+            {
+                const std::string& group = groups[token.group];
+                if (!group.empty() && !known[group] && !(token.elided && is_elision(token.word)))
+                {
+                    keys.push_back(token.word);
+                }
+            }
+            lookup(keys, known);
+
+            //suggestions, once per distinct word not found
+            std::unordered_map<std::string, std::vector<std::string>> suggestions;
+            for (const auto& token : tokens)
+            {
+                const std::string& group = groups[token.group];
+                const bool checked = group.empty() || (!known[group] && !(token.elided && is_elision(token.word)));
+                if (!checked || known[token.word])
+                {
+                    continue;
+                }
+
+                auto found = suggestions.find(token.word);
+                if (found == suggestions.end())
+                {
+                    std::vector<std::string> words;
+                    for (const auto& suggestion : m_dictionary.suggest(token.word, m_options.max_error, m_options.max_suggestions))
+                    {
+                        words.push_back(std::get<std::string>(suggestion));
+                    }
+                    found = suggestions.emplace(token.word, std::move(words)).first;
+                }
+
+                ZDSpellRecord record;
+                record.offset = token.offset;
+                record.length = token.length;
+                record.suggestions = found->second;
+                records.push_back(std::move(record));
+            }
+        };
+
+    private:
+
+        //! @brief look up a batch of words, sorted so that neighbouring lookups walk the same branches of the tree
+        void lookup(std::vector<std::string>& keys, std::unordered_map<std::string, bool>& known) const
+        {
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            for (const auto& key : keys)
+            {
+                if (known.find(key) == known.end())
+                {
+                    known.emplace(key, m_dictionary.find_word(key));
+                }
+            }
+        };
+
+        //! @brief true if a word before an apostrophe is a French elision ("l'", "d'", "qu'"...)
+        static inline bool is_elision(const std::string& word)
+        {
+            static const char* elisions[] = { "c", "d", "j", "l", "m", "n", "s", "t", "qu", "jusqu", "lorsqu", "puisqu", "quoiqu", "presqu" };
+            for (auto elision : elisions)
+            {
+                if (word == elision)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        //! @brief read the next chunk of a stream, cut after its last white space or punctuation; the rest is
+        //! kept in the carry. A chunk holding a single group of words is extended up to the next boundary.
+        //! @return false at the end of the stream
+        bool read_chunk(std::istream& in, std::string& carry, std::string& chunk) const
+        {
+            chunk.swap(carry);
+            carry.clear();
+            while (in)
+            {
+                const std::size_t kept = chunk.size();
+                chunk.resize(kept + m_options.chunk_size);
+                in.read(&chunk[kept], static_cast<std::streamsize>(m_options.chunk_size));
+                chunk.resize(kept + static_cast<std::size_t>(in.gcount()));
+
+                //not the end of the stream : keep the last group of words for the next chunk
+                if (in)
+                {
+                    const std::size_t size = ZDTokenizer::cut(chunk.data(), chunk.size());
+                    if (size != 0)
+                    {
+                        carry.assign(chunk, size, std::string::npos);
+                        chunk.resize(size);
+                        break;
+                    }
+                }
+            }
+            return !chunk.empty();
+        };
+
+        //! @brief check a stream chunk by chunk, in the calling thread
+        uint64_t check_serial(std::istream& in, const Sink& sink) const
+        {
+            uint64_t count = 0;
+            uint64_t offset = 0;
+            std::string carry;
+            std::string chunk;
+            std::vector<ZDSpellRecord> records;
+            while (read_chunk(in, carry, chunk))
+            {
+                records.clear();
+                check_chunk(chunk.data(), chunk.size(), offset, records);
+                for (const auto& record : records)
+                {
+                    sink(record);
+                }
+                count += records.size();
+                offset += chunk.size();
+            }
+            return count;
+        };
+
+        //! @brief check a stream with a pool of threads : the calling thread reads the chunks and gives them to
+        //! the workers, at most two chunks per worker being in flight, then produces the records of the oldest
+        //! chunk as soon as it is checked. An exception thrown by a worker is rethrown in the calling thread.
+        uint64_t check_parallel(std::istream& in, const Sink& sink) const
+        {
+            struct Job
+            {
+                std::string chunk;
+                uint64_t offset;
+                std::promise<std::vector<ZDSpellRecord>> records;
+            };
+
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::deque<Job*> jobs;
+            bool done = false;
+
+            //the jobs in flight, declared before the workers so that they outlive them
+            std::deque<std::pair<std::unique_ptr<Job>, std::future<std::vector<ZDSpellRecord>>>> pending;
+            std::vector<std::thread> workers;
+
+            //stops and joins the workers however the function ends : if the sink throws, the jobs not started
+            //are dropped
+            struct Stopper
+            {
+                std::function<void()> stop;
+                ~Stopper() { stop(); }
+            } stopper{ [&]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done = true;
+                    jobs.clear();
+                }
+                ready.notify_all();
+                for (auto& worker : workers)
+                {
+                    if (worker.joinable())
+                    {
+                        worker.join();
+                    }
+                }
+            } };
+
+            for (unsigned int t = 0; t < m_options.threads; ++t)
+            {
+                workers.emplace_back([&]()
+                {
+                    while (true)
+                    {
+                        Job* job = 0;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            ready.wait(lock, [&]() { return done || !jobs.empty(); });
+                            if (jobs.empty())
+                            {
+                                return;
+                            }
+                            job = jobs.front();
+                            jobs.pop_front();
+                        }
+
+                        //a failure is given to the calling thread, which rethrows it when it gets the records
+                        try
+                        {
+                            std::vector<ZDSpellRecord> records;
+                            check_chunk(job->chunk.data(), job->chunk.size(), job->offset, records);
+                            job->records.set_value(std::move(records));
+                        }
+                        catch (...)
+                        {
+                            job->records.set_exception(std::current_exception());
+                        }
+                    }
+                });
+            }
+
+            uint64_t count = 0;
+            auto emit = [&]()
+            {
+                const std::vector<ZDSpellRecord> records = pending.front().second.get();
+                for (const auto& record : records)
+                {
+                    sink(record);
+                }
+                count += records.size();
+                pending.pop_front();
+            };
+
+            const std::size_t maxPending = 2 * m_options.threads;
+            uint64_t offset = 0;
+            std::string carry;
+            std::string chunk;
+            while (read_chunk(in, carry, chunk))
+            {
+                std::unique_ptr<Job> job(new Job{ std::move(chunk), offset, std::promise<std::vector<ZDSpellRecord>>() });
+                chunk = std::string();
+                offset += job->chunk.size();
+
+                auto future = job->records.get_future();
+                pending.emplace_back(std::move(job), std::move(future));
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    jobs.push_back(pending.back().first.get());
+                }
+                ready.notify_one();
+
+                if (pending.size() >= maxPending)
+                {
+                    emit();
+                }
+            }
+
+            while (!pending.empty())
+            {
+                emit();
+            }
+            return count;
+        };
+
+        //! @brief the dictionary checked against
+        const ZDDictionary& m_dictionary;
+
+        //! @brief the settings of the checks
+        ZDSpellOptions m_options;
+    };
+}
@@ -0,0 +1,1038 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+#include <limits>
+#include "Distance/ZDEditDistance.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZD_ART_SSE2 1
+#endif
+
+namespace Dico
+{
+    //! @brief this class is an adaptive radix tree (ART) of words : an inner node has one of four layouts chosen by
+    //! its number of children, and changes layout as children are added or removed.
+    //! Node4 and Node16 keep sorted arrays of key bytes next to the children (Node16 is searched with one SSE2
+    //! compare when available), Node48 maps each byte to one of 48 children, Node256 is indexed by the byte.
+    //! Unbranched runs of bytes are compressed in the prefix of the inner node below them; only the first
+    //! max_prefix bytes are stored, the rest is read from a leaf of the subtree when needed. A leaf holds a whole
+    //! word, and a word ending where an inner node branches is held by that node.
+    //! Words are converted to lower case, like in ZDDictionary.
+    class ZDAdaptiveRadixTree
+    {
+    public:
+        //! @brief the number of nodes of each kind, and the memory they use
+        struct Statistics
+        {
+            std::size_t leaves = 0;
+            std::size_t node4 = 0;
+            std::size_t node16 = 0;
+            std::size_t node48 = 0;
+            std::size_t node256 = 0;
+            std::size_t bytes = 0;
+        };
+
+        //! @brief defaut constructor, empty tree
+        ZDAdaptiveRadixTree() = default;
+
+        //! @brief distructor, free the nodes
+        ~ZDAdaptiveRadixTree()
+        {
+            clear();
+        };
+
+        ZDAdaptiveRadixTree(const ZDAdaptiveRadixTree&) = delete;
+        ZDAdaptiveRadixTree& operator=(const ZDAdaptiveRadixTree&) = delete;
+
+        //! @brief build the tree from a list of words (typicaly Lexico::getWords())
+        //! @param words the given words
+        void build(const std::vector<std::string>& words)
+        {
+            clear();
+            for (const auto& word : words)
+            {
+                insert_word(word);
+            }
+        };
+
+        //! @brief remove all the words
+        void clear()
+        {
+            destroy(m_root);
+            m_root = nullptr;
+            m_words = 0;
+        };
+
+        //! @brief insert a new word
+        //! @param word the given word to be inserted
+        //! @return true if the word is new, false if it was already there
+        bool insert_word(const std::string& word)
+        {
+            const std::string key = to_lower_case_word(word);
+            if (key.empty() || !insert(m_root, key, 0))
+            {
+                return false;
+            }
+            ++m_words;
+            return true;
+        };
+
+        //! @brief remove a word
+        //! @param word the word to be removed
+        //! @return true if succes, false if the word is not there
+        bool remove_word(const std::string& word)
+        {
+            const std::string key = to_lower_case_word(word);
+            if (key.empty() || !remove(m_root, key, 0))
+            {
+                return false;
+            }
+            --m_words;
+            return true;
+        };
+
+        //! @brief find if a word exist in the tree
+        //! @param word the word to be found
+        //! @return true if the word is found, false otherwise
+        bool find_word(const std::string& word) const
+        {
+            const std::string key = to_lower_case_word(word);
+            const Node* node = m_root;
+            std::size_t depth = 0;
+            while (node != nullptr)
+            {
+                if (node->type == leaf_type)
+                {
+                    return static_cast<const Leaf*>(node)->key == key;
+                }
+
+                //the bytes of the prefix which are not stored are checked on the leaf
+                const Inner* inner = static_cast<const Inner*>(node);
+                if (key.size() - depth < inner->prefix_length
+                    || std::memcmp(inner->prefix, key.data() + depth, std::min<std::size_t>(inner->prefix_length, max_prefix)) != 0)
+                {
+                    return false;
+                }
+                depth += inner->prefix_length;
+                if (depth == key.size())
+                {
+                    return inner->leaf != nullptr && inner->leaf->key == key;
+                }
+                Node* const* child = find_child(inner, static_cast<uint8_t>(key[depth]));
+                node = (child != nullptr) ? *child : nullptr;
+                ++depth;
+            }
+            return false;
+        };
+
+        //! @brief find the words starting with a given prefix, the walk stopping once enough words are found
+        //! @param prefix the given prefix
+        //! @param max_count the maximum number of words, the first ones in alphabetical order
+        //! @return the words, sorted
+        std::vector<std::string> find_prefix(const std::string& prefix, std::size_t max_count = std::numeric_limits<std::size_t>::max()) const
+        {
+            std::vector<std::string> result;
+            const std::string key = to_lower_case_word(prefix);
+            const Node* node = m_root;
+            std::size_t depth = 0;
+            while (node != nullptr && depth < key.size())
+            {
+                if (node->type == leaf_type)
+                {
+                    const Leaf* found = static_cast<const Leaf*>(node);
+                    if (found->key.compare(0, key.size(), key) == 0 && max_count != 0)
+                    {
+                        result.push_back(found->key);
+                    }
+                    return result;
+                }
+
+                //the prefix may end inside the prefix of the node
+                const Inner* inner = static_cast<const Inner*>(node);
+                const std::size_t length = std::min<std::size_t>(inner->prefix_length, key.size() - depth);
+                if (std::memcmp(prefix_bytes(inner, depth), key.data() + depth, length) != 0)
+                {
+                    return result;
+                }
+                depth += inner->prefix_length;
+                if (depth >= key.size())
+                {
+                    break;
+                }
+                Node* const* child = find_child(inner, static_cast<uint8_t>(key[depth]));
+                node = (child != nullptr) ? *child : nullptr;
+                ++depth;
+            }
+
+            collect(node, result, max_count);
+            return result;
+        };
+
+        //! @brief find the words close to a given word : the tree is walked depth first with one bit-vector DP
+        //! row per byte (see ZDMyersPattern), and a subtree is left as soon as no prefix of the word is close
+        //! enough to the path leading to it. Words longer than 64 chars are compared one by one.
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            const std::string key = to_lower_case_word(word);
+            if (max_error < 0)
+            {
+                return result;
+            }
+
+            if (key.size() > ZDMyersPattern::max_size)
+            {
+                std::vector<std::string> all;
+                collect(m_root, all, std::numeric_limits<std::size_t>::max());
+                for (auto& candidate : all)
+                {
+                    const int errors = levenshtein_distance(key, candidate, max_error);
+                    if (errors <= max_error)
+                    {
+                        result.emplace_back(std::move(candidate), errors);
+                    }
+                }
+            }
+            else if (m_root != nullptr)
+            {
+                const ZDMyersPattern pattern(key);
+                fuzzy(m_root, 0, pattern, pattern.first_row(), max_error, result);
+            }
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            return result;
+        };
+
+        //! @brief find the closest words to a given word : the number of errors grows from 0 until enough words
+        //! are found, so the walk stays as narrow as the words allow
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @param max_count the maximum number of words
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error, std::size_t max_count) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            for (int errors = 0; errors <= max_error && result.size() < max_count; ++errors)
+            {
+                result = find_words(word, errors);
+            }
+            if (result.size() > max_count)
+            {
+                result.resize(max_count);
+            }
+            return result;
+        };
+
+        //! @brief get the number of words
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_words;
+        };
+
+        //! @brief count the nodes of each kind
+        //! @return
+        Statistics statistics() const
+        {
+            Statistics result;
+            count(m_root, result);
+            return result;
+        };
+
+    private:
+
+        //! @brief the kinds of nodes
+        static constexpr uint8_t leaf_type = 0;
+        static constexpr uint8_t node4_type = 1;
+        static constexpr uint8_t node16_type = 2;
+        static constexpr uint8_t node48_type = 3;
+        static constexpr uint8_t node256_type = 4;
+
+        //! @brief the number of bytes of a prefix stored in the node
+        static constexpr std::size_t max_prefix = 10;
+
+        //! @brief the empty slot of a Node48 index
+        static constexpr uint8_t empty_slot = 0xFF;
+
+        struct Node
+        {
+            explicit Node(uint8_t nodeType) : type(nodeType) {};
+            uint8_t type;
+        };
+
+        //! @brief a whole word
+        struct Leaf : Node
+        {
+            explicit Leaf(const std::string& word) : Node(leaf_type), key(word) {};
+            std::string key;
+        };
+
+        //! @brief the part common to the inner nodes
+        struct Inner : Node
+        {
+            explicit Inner(uint8_t nodeType) : Node(nodeType) {};
+            uint16_t count = 0;                 //!< the number of children
+            uint32_t prefix_length = 0;         //!< the number of bytes skipped before branching
+            char prefix[max_prefix] = {};       //!< the first bytes skipped
+            Leaf* leaf = nullptr;               //!< the word ending before branching, if any
+        };
+
+        struct Node4 : Inner
+        {
+            Node4() : Inner(node4_type) {};
+            uint8_t keys[4] = {};
+            Node* children[4] = {};
+        };
+
+        struct Node16 : Inner
+        {
+            Node16() : Inner(node16_type) {};
+            uint8_t keys[16] = {};
+            Node* children[16] = {};
+        };
+
+        struct Node48 : Inner
+        {
+            Node48() : Inner(node48_type)
+            {
+                std::memset(index, empty_slot, sizeof(index));
+            };
+            uint8_t index[256];
+            Node* children[48] = {};
+        };
+
+        struct Node256 : Inner
+        {
+            Node256() : Inner(node256_type) {};
+            Node* children[256] = {};
+        };
+
+        //! @brief free a subtree
+        static void destroy(Node* node)
+        {
+            if (node == nullptr)
+            {
+                return;
+            }
+            if (node->type == leaf_type)
+            {
+                delete static_cast<Leaf*>(node);
+                return;
+            }
+            Inner* inner = static_cast<Inner*>(node);
+            delete inner->leaf;
+            for_each_child(inner, [](uint8_t, Node* child)
+            {
+                destroy(child);
+            });
+            delete_inner(inner);
+        };
+
+        //! @brief free an inner node only
+        static void delete_inner(Inner* inner)
+        {
+            switch (inner->type)
+            {
+            case node4_type: delete static_cast<Node4*>(inner); break;
+            case node16_type: delete static_cast<Node16*>(inner); break;
+            case node48_type: delete static_cast<Node48*>(inner); break;
+            default: delete static_cast<Node256*>(inner); break;
+            }
+        };
+
+        //! @brief find the child of a node for a byte
+        //! @return the slot of the child, nullptr if none
+        static Node* const* find_child(const Inner* inner, uint8_t byte)
+        {
+            switch (inner->type)
+            {
+            case node4_type:
+            {
+                const Node4* node = static_cast<const Node4*>(inner);
+                for (uint16_t i = 0; i < node->count; ++i)
+                {
+                    if (node->keys[i] == byte)
+                    {
+                        return &node->children[i];
+                    }
+                }
+                return nullptr;
+            }
+            case node16_type:
+            {
+                const Node16* node = static_cast<const Node16*>(inner);
+#if defined(ZD_ART_SSE2)
+                const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(node->keys));
+                const __m128i equal = _mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(byte)));
+                const uint64_t mask = static_cast<uint64_t>(_mm_movemask_epi8(equal)) & ((uint64_t(1) << node->count) - 1);
+                if (mask != 0)
+                {
+                    return &node->children[popcount64((mask & (~mask + 1)) - 1)];
+                }
+#else
+                for (uint16_t i = 0; i < node->count; ++i)
+                {
+                    if (node->keys[i] == byte)
+                    {
+                        return &node->children[i];
+                    }
+                }
+#endif
+                return nullptr;
+            }
+            case node48_type:
+            {
+                const Node48* node = static_cast<const Node48*>(inner);
+                return (node->index[byte] != empty_slot) ? &node->children[node->index[byte]] : nullptr;
+            }
+            default:
+            {
+                const Node256* node = static_cast<const Node256*>(inner);
+                return (node->children[byte] != nullptr) ? &node->children[byte] : nullptr;
+            }
+            }
+        };
+
+        //! @brief call a function with each child of a node, by increasing byte
+        template<class Visitor>
+        static void for_each_child(const Inner* inner, Visitor visitor)
+        {
+            switch (inner->type)
+            {
+            case node4_type:
+            {
+                const Node4* node = static_cast<const Node4*>(inner);
+                for (uint16_t i = 0; i < node->count; ++i)
+                {
+                    visitor(node->keys[i], node->children[i]);
+                }
+                break;
+            }
+            case node16_type:
+            {
+                const Node16* node = static_cast<const Node16*>(inner);
+                for (uint16_t i = 0; i < node->count; ++i)
+                {
+                    visitor(node->keys[i], node->children[i]);
+                }
+                break;
+            }
+            case node48_type:
+            {
+                const Node48* node = static_cast<const Node48*>(inner);
+                for (int byte = 0; byte < 256; ++byte)
+                {
+                    if (node->index[byte] != empty_slot)
+                    {
+                        visitor(static_cast<uint8_t>(byte), node->children[node->index[byte]]);
+                    }
+                }
+                break;
+            }
+            default:
+            {
+                const Node256* node = static_cast<const Node256*>(inner);
+                for (int byte = 0; byte < 256; ++byte)
+                {
+                    if (node->children[byte] != nullptr)
+                    {
+                        visitor(static_cast<uint8_t>(byte), node->children[byte]);
+                    }
+                }
+                break;
+            }
+            }
+        };
+
+        //! @brief copy the header of an inner node to a node of another kind
+        static void copy_header(const Inner* from, Inner* to)
+        {
+            to->prefix_length = from->prefix_length;
+            std::memcpy(to->prefix, from->prefix, max_prefix);
+            to->leaf = from->leaf;
+        };
+
+        //! @brief insert a child in a sorted array of keys
+        template<class Small>
+        static void insert_sorted(Small* node, uint8_t byte, Node* child)
+        {
+            uint16_t position = 0;
+            while (position < node->count && node->keys[position] < byte)
+            {
+                ++position;
+            }
+            std::memmove(node->keys + position + 1, node->keys + position, node->count - position);
+            std::memmove(node->children + position + 1, node->children + position, (node->count - position) * sizeof(Node*));
+            node->keys[position] = byte;
+            node->children[position] = child;
+            ++node->count;
+        };
+
+        //! @brief add a child to a node, which is replaced by a larger kind when full
+        //! @param ref the slot of the node
+        static void add_child(Node*& ref, uint8_t byte, Node* child)
+        {
+            Inner* inner = static_cast<Inner*>(ref);
+            switch (inner->type)
+            {
+            case node4_type:
+            {
+                Node4* node = static_cast<Node4*>(inner);
+                if (node->count < 4)
+                {
+                    insert_sorted(node, byte, child);
+                    return;
+                }
+                Node16* grown = new Node16();
+                copy_header(node, grown);
+                grown->count = node->count;
+                std::memcpy(grown->keys, node->keys, node->count);
+                std::memcpy(grown->children, node->children, node->count * sizeof(Node*));
+                delete node;
+                insert_sorted(grown, byte, child);
+                ref = grown;
+                return;
+            }
+            case node16_type:
+            {
+                Node16* node = static_cast<Node16*>(inner);
+                if (node->count < 16)
+                {
+                    insert_sorted(node, byte, child);
+                    return;
+                }
+                Node48* grown = new Node48();
+                copy_header(node, grown);
+                for (uint16_t i = 0; i < node->count; ++i)
+                {
+                    grown->index[node->keys[i]] = static_cast<uint8_t>(i);
+                    grown->children[i] = node->children[i];
+                }
+                grown->count = node->count;
+                delete node;
+                ref = grown;
+                add_child(ref, byte, child);
+                return;
+            }
+            case node48_type:
+            {
+                Node48* node = static_cast<Node48*>(inner);
+                if (node->count < 48)
+                {
+                    //a removed child may have left a hole
+                    uint8_t slot = 0;
+                    while (node->children[slot] != nullptr)
+                    {
+                        ++slot;
+                    }
+                    node->index[byte] = slot;
+                    node->children[slot] = child;
+                    ++node->count;
+                    return;
+                }
+                Node256* grown = new Node256();
+                copy_header(node, grown);
+                for (int key = 0; key < 256; ++key)
+                {
+                    if (node->index[key] != empty_slot)
+                    {
+                        grown->children[key] = node->children[node->index[key]];
+                    }
+                }
+                grown->count = node->count;
+                delete node;
+                grown->children[byte] = child;
+                ++grown->count;
+                ref = grown;
+                return;
+            }
+            default:
+            {
+                Node256* node = static_cast<Node256*>(inner);
+                node->children[byte] = child;
+                ++node->count;
+                return;
+            }
+            }
+        };
+
+        //! @brief remove a child from a node, which is replaced by a smaller kind when it gets sparse, by its leaf
+        //! or its only child when it does not branch anymore, or by nothing when empty
+        //! @param ref the slot of the node
+        static void remove_child(Node*& ref, uint8_t byte)
+        {
+            Inner* inner = static_cast<Inner*>(ref);
+            switch (inner->type)
+            {
+            case node4_type:
+            case node16_type:
+            {
+                uint8_t* keys = (inner->type == node4_type) ? static_cast<Node4*>(inner)->keys : static_cast<Node16*>(inner)->keys;
+                Node** children = (inner->type == node4_type) ? static_cast<Node4*>(inner)->children : static_cast<Node16*>(inner)->children;
+                uint16_t position = 0;
+                while (keys[position] != byte)
+                {
+                    ++position;
+                }
+                std::memmove(keys + position, keys + position + 1, inner->count - position - 1);
+                std::memmove(children + position, children + position + 1, (inner->count - position - 1) * sizeof(Node*));
+                --inner->count;
+                break;
+            }
+            case node48_type:
+            {
+                Node48* node = static_cast<Node48*>(inner);
+                node->children[node->index[byte]] = nullptr;
+                node->index[byte] = empty_slot;
+                --node->count;
+                break;
+            }
+            default:
+                static_cast<Node256*>(inner)->children[byte] = nullptr;
+                --inner->count;
+                break;
+            }
+            shrink(ref);
+        };
+
+        //! @brief replace a node by a smaller kind or by its content when possible
+        //! @param ref the slot of the node
+        static void shrink(Node*& ref)
+        {
+            Inner* inner = static_cast<Inner*>(ref);
+            if (inner->count == 0)
+            {
+                //the leaf keeps the whole word, the prefix is not needed anymore
+                ref = inner->leaf;
+                delete_inner(inner);
+                return;
+            }
+            if (inner->count == 1 && inner->leaf == nullptr)
+            {
+                collapse(ref);
+                return;
+            }
+
+            //the thresholds are below the capacity of the smaller kind, so a node does not go back and forth
+            switch (inner->type)
+            {
+            case node16_type:
+                if (inner->count <= 3)
+                {
+                    Node16* node = static_cast<Node16*>(inner);
+                    Node4* shrunk = new Node4();
+                    copy_header(node, shrunk);
+                    shrunk->count = node->count;
+                    std::memcpy(shrunk->keys, node->keys, node->count);
+                    std::memcpy(shrunk->children, node->children, node->count * sizeof(Node*));
+                    delete node;
+                    ref = shrunk;
+                }
+                break;
+            case node48_type:
+                if (inner->count <= 12)
+                {
+                    Node48* node = static_cast<Node48*>(inner);
+                    Node16* shrunk = new Node16();
+                    copy_header(node, shrunk);
+                    for_each_child(node, [shrunk](uint8_t byte, Node* child)
+                    {
+                        shrunk->keys[shrunk->count] = byte;
+                        shrunk->children[shrunk->count] = child;
+                        ++shrunk->count;
+                    });
+                    delete node;
+                    ref = shrunk;
+                }
+                break;
+            case node256_type:
+                if (inner->count <= 37)
+                {
+                    Node256* node = static_cast<Node256*>(inner);
+                    Node48* shrunk = new Node48();
+                    copy_header(node, shrunk);
+                    for_each_child(node, [shrunk](uint8_t byte, Node* child)
+                    {
+                        shrunk->index[byte] = static_cast<uint8_t>(shrunk->count);
+                        shrunk->children[shrunk->count] = child;
+                        ++shrunk->count;
+                    });
+                    delete node;
+                    ref = shrunk;
+                }
+                break;
+            default:
+                break;
+            }
+        };
+
+        //! @brief replace a node without word and with one child by its child, the prefix of the node and the byte
+        //! of the child being put before the prefix of the child
+        //! @param ref the slot of the node
+        static void collapse(Node*& ref)
+        {
+            Inner* inner = static_cast<Inner*>(ref);
+            uint8_t byte = 0;
+            Node* child = nullptr;
+            for_each_child(inner, [&](uint8_t key, Node* node)
+            {
+                byte = key;
+                child = node;
+            });
+
+            if (child->type != leaf_type)
+            {
+                Inner* below = static_cast<Inner*>(child);
+                char prefix[max_prefix];
+                std::size_t length = std::min<std::size_t>(inner->prefix_length, max_prefix);
+                std::memcpy(prefix, inner->prefix, length);
+                if (length < max_prefix)
+                {
+                    prefix[length++] = static_cast<char>(byte);
+                }
+                const std::size_t kept = std::min(max_prefix - length, static_cast<std::size_t>(below->prefix_length));
+                std::memcpy(prefix + length, below->prefix, kept);
+                std::memcpy(below->prefix, prefix, length + kept);
+                below->prefix_length += inner->prefix_length + 1;
+            }
+            ref = child;
+            delete_inner(inner);
+        };
+
+        //! @brief get the shortest word of a subtree
+        static const Leaf* minimum(const Node* node)
+        {
+            while (node->type != leaf_type)
+            {
+                const Inner* inner = static_cast<const Inner*>(node);
+                if (inner->leaf != nullptr)
+                {
+                    return inner->leaf;
+                }
+                node = first_child(inner);
+            }
+            return static_cast<const Leaf*>(node);
+        };
+
+        //! @brief get the child of the lowest byte of a node
+        static const Node* first_child(const Inner* inner)
+        {
+            switch (inner->type)
+            {
+            case node4_type: return static_cast<const Node4*>(inner)->children[0];
+            case node16_type: return static_cast<const Node16*>(inner)->children[0];
+            case node48_type:
+            {
+                const Node48* node = static_cast<const Node48*>(inner);
+                int byte = 0;
+                while (node->index[byte] == empty_slot)
+                {
+                    ++byte;
+                }
+                return node->children[node->index[byte]];
+            }
+            default:
+            {
+                const Node256* node = static_cast<const Node256*>(inner);
+                int byte = 0;
+                while (node->children[byte] == nullptr)
+                {
+                    ++byte;
+                }
+                return node->children[byte];
+            }
+            }
+        };
+
+        //! @brief get the whole prefix of a node, from the node itself or from a word of its subtree
+        //! @param depth the number of bytes before the prefix
+        static const char* prefix_bytes(const Inner* inner, std::size_t depth)
+        {
+            return (inner->prefix_length <= max_prefix) ? inner->prefix : minimum(inner)->key.data() + depth;
+        };
+
+        //! @brief insert a word in a subtree
+        //! @param ref the slot of the subtree
+        //! @param depth the number of bytes of the word before the subtree
+        //! @return true if the word is new
+        static bool insert(Node*& ref, const std::string& key, std::size_t depth)
+        {
+            if (ref == nullptr)
+            {
+                ref = new Leaf(key);
+                return true;
+            }
+
+            if (ref->type == leaf_type)
+            {
+                //a leaf becomes a node branching where both words differ
+                Leaf* existing = static_cast<Leaf*>(ref);
+                if (existing->key == key)
+                {
+                    return false;
+                }
+                std::size_t common = 0;
+                while (depth + common < key.size() && depth + common < existing->key.size() && key[depth + common] == existing->key[depth + common])
+                {
+                    ++common;
+                }
+                Node* node = new Node4();
+                set_prefix(static_cast<Inner*>(node), key.data() + depth, common);
+                attach(node, existing, depth + common);
+                attach(node, new Leaf(key), depth + common);
+                ref = node;
+                return true;
+            }
+
+            Inner* inner = static_cast<Inner*>(ref);
+            if (inner->prefix_length != 0)
+            {
+                //the prefix is split where the word leaves it
+                const char* prefix = prefix_bytes(inner, depth);
+                std::size_t common = 0;
+                while (common < inner->prefix_length && depth + common < key.size() && prefix[common] == key[depth + common])
+                {
+                    ++common;
+                }
+                if (common < inner->prefix_length)
+                {
+                    Node* node = new Node4();
+                    set_prefix(static_cast<Inner*>(node), key.data() + depth, common);
+                    const uint8_t byte = static_cast<uint8_t>(prefix[common]);
+                    const std::size_t rest = inner->prefix_length - common - 1;
+                    char moved[max_prefix];
+                    std::memcpy(moved, prefix + common + 1, std::min(rest, max_prefix));
+                    set_prefix(inner, moved, rest);
+                    add_child(node, byte, inner);
+                    attach(node, new Leaf(key), depth + common);
+                    ref = node;
+                    return true;
+                }
+                depth += inner->prefix_length;
+            }
+
+            if (depth == key.size())
+            {
+                if (inner->leaf != nullptr)
+                {
+                    return false;
+                }
+                inner->leaf = new Leaf(key);
+                return true;
+            }
+
+            Node* const* child = find_child(inner, static_cast<uint8_t>(key[depth]));
+            if (child != nullptr)
+            {
+                return insert(*const_cast<Node**>(child), key, depth + 1);
+            }
+            add_child(ref, static_cast<uint8_t>(key[depth]), new Leaf(key));
+            return true;
+        };
+
+        //! @brief hang a leaf below a new node, as its word or as a child
+        //! @param depth the number of bytes before the branching of the node
+        static void attach(Node*& node, Leaf* word, std::size_t depth)
+        {
+            if (word->key.size() == depth)
+            {
+                static_cast<Inner*>(node)->leaf = word;
+            }
+            else
+            {
+                add_child(node, static_cast<uint8_t>(word->key[depth]), word);
+            }
+        };
+
+        //! @brief set the prefix of a node
+        static void set_prefix(Inner* inner, const char* prefix, std::size_t length)
+        {
+            inner->prefix_length = static_cast<uint32_t>(length);
+            std::memcpy(inner->prefix, prefix, std::min(length, max_prefix));
+        };
+
+        //! @brief remove a word from a subtree
+        //! @param ref the slot of the subtree
+        //! @param depth the number of bytes of the word before the subtree
+        //! @return true if the word was there
+        static bool remove(Node*& ref, const std::string& key, std::size_t depth)
+        {
+            if (ref == nullptr)
+            {
+                return false;
+            }
+
+            if (ref->type == leaf_type)
+            {
+                if (static_cast<Leaf*>(ref)->key != key)
+                {
+                    return false;
+                }
+                delete static_cast<Leaf*>(ref);
+                ref = nullptr;
+                return true;
+            }
+
+            Inner* inner = static_cast<Inner*>(ref);
+            if (key.size() - depth < inner->prefix_length
+                || std::memcmp(inner->prefix, key.data() + depth, std::min<std::size_t>(inner->prefix_length, max_prefix)) != 0)
+            {
+                return false;
+            }
+            depth += inner->prefix_length;
+
+            if (depth == key.size())
+            {
+                if (inner->leaf == nullptr || inner->leaf->key != key)
+                {
+                    return false;
+                }
+                delete inner->leaf;
+                inner->leaf = nullptr;
+                shrink(ref);
+                return true;
+            }
+
+            const uint8_t byte = static_cast<uint8_t>(key[depth]);
+            Node* const* child = find_child(inner, byte);
+            if (child == nullptr || !remove(*const_cast<Node**>(child), key, depth + 1))
+            {
+                return false;
+            }
+            if (*child == nullptr)
+            {
+                remove_child(ref, byte);
+            }
+            return true;
+        };
+
+        //! @brief add the words of a subtree, in alphabetical order, until there are max_count words
+        static void collect(const Node* node, std::vector<std::string>& result, std::size_t max_count)
+        {
+            if (node == nullptr || result.size() >= max_count)
+            {
+                return;
+            }
+            if (node->type == leaf_type)
+            {
+                result.push_back(static_cast<const Leaf*>(node)->key);
+                return;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            if (inner->leaf != nullptr)
+            {
+                result.push_back(inner->leaf->key);
+            }
+            for_each_child(inner, [&result, max_count](uint8_t, const Node* child)
+            {
+                collect(child, result, max_count);
+            });
+        };
+
+        //! @brief advance a DP row along some bytes, stopping as soon as no extension can be close enough
+        //! @return true if the row is still close enough at the end
+        static bool advance(const ZDMyersPattern& pattern, ZDMyersRow& row, const char* bytes, std::size_t size, int max_error)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                row = pattern.advance(row, bytes[i]);
+                if (pattern.minimum(row, max_error) > max_error)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        //! @brief walk a subtree, advancing the DP row along each byte of its paths
+        //! @param depth the number of bytes before the subtree
+        static void fuzzy(const Node* node, std::size_t depth, const ZDMyersPattern& pattern, ZDMyersRow row, int max_error,
+            std::vector<std::pair<std::string, int>>& result)
+        {
+            if (node->type == leaf_type)
+            {
+                const std::string& key = static_cast<const Leaf*>(node)->key;
+                if (advance(pattern, row, key.data() + depth, key.size() - depth, max_error) && row.score <= max_error)
+                {
+                    result.emplace_back(key, row.score);
+                }
+                return;
+            }
+
+            const Inner* inner = static_cast<const Inner*>(node);
+            if (!advance(pattern, row, prefix_bytes(inner, depth), inner->prefix_length, max_error))
+            {
+                return;
+            }
+            depth += inner->prefix_length;
+            if (inner->leaf != nullptr && row.score <= max_error)
+            {
+                result.emplace_back(inner->leaf->key, row.score);
+            }
+            for_each_child(inner, [&](uint8_t byte, const Node* child)
+            {
+                ZDMyersRow next = pattern.advance(row, static_cast<char>(byte));
+                if (pattern.minimum(next, max_error) <= max_error)
+                {
+                    fuzzy(child, depth + 1, pattern, next, max_error, result);
+                }
+            });
+        };
+
+        //! @brief count the nodes of a subtree
+        static void count(const Node* node, Statistics& statistics)
+        {
+            if (node == nullptr)
+            {
+                return;
+            }
+            if (node->type == leaf_type)
+            {
+                const Leaf* found = static_cast<const Leaf*>(node);
+                ++statistics.leaves;
+                statistics.bytes += sizeof(Leaf) + (found->key.capacity() > 15 ? found->key.capacity() + 1 : 0);
+                return;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            switch (inner->type)
+            {
+            case node4_type: ++statistics.node4; statistics.bytes += sizeof(Node4); break;
+            case node16_type: ++statistics.node16; statistics.bytes += sizeof(Node16); break;
+            case node48_type: ++statistics.node48; statistics.bytes += sizeof(Node48); break;
+            default: ++statistics.node256; statistics.bytes += sizeof(Node256); break;
+            }
+            count(inner->leaf, statistics);
+            for_each_child(inner, [&statistics](uint8_t, const Node* child)
+            {
+                count(child, statistics);
+            });
+        };
+
+        //! @brief convert from upper case string to lower case string, string sould we ansi
+        static inline std::string to_lower_case_word(const std::string& upperCase)
+        {
+            std::string lowerCase(upperCase);
+            std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
+            return lowerCase;
+        };
+
+        //! @brief the root, nullptr when empty
+        Node* m_root = nullptr;
+
+        //! @brief the number of words
+        std::size_t m_words = 0;
+    };
+}
@@ -0,0 +1,563 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+#include <limits>
+#include "Distance/ZDEditDistance.h"
+
+namespace Dico
+{
+    //! @brief this class is a path-compressed trie (radix tree) of words : a run of chars without branch is one
+    //! edge, whose label is a slice of one contiguous label buffer and is matched with memcmp, instead of one
+    //! node per char. Splitting an edge on insert keeps both halves in place in the buffer; merging two edges on
+    //! remove reuses the buffer when the labels are contiguous, and the buffer is compacted once half of it is
+    //! unused. Nodes are stored in one array and linked by index, the children of a node sorted by first char.
+    //! Words are converted to lower case, like in ZDDictionary.
+    class ZDRadixTree
+    {
+    public:
+        //! @brief defaut constructor, empty tree
+        ZDRadixTree()
+        {
+            clear();
+        };
+
+        //! @brief build the tree from a list of words (typicaly Lexico::getWords())
+        //! @param words the given words
+        void build(const std::vector<std::string>& words)
+        {
+            clear();
+            for (const auto& word : words)
+            {
+                insert_word(word);
+            }
+        };
+
+        //! @brief remove all the words
+        void clear()
+        {
+            m_nodes.clear();
+            m_free.clear();
+            m_labels.clear();
+            m_unused = 0;
+            m_words = 0;
+            m_nodes.push_back(Node());
+        };
+
+        //! @brief insert a new word
+        //! @param word the given word to be inserted
+        //! @return true if the word is new, false if it was already there
+        bool insert_word(const std::string& word)
+        {
+            const std::string key = to_lower_case_word(word);
+            if (key.empty())
+            {
+                return false;
+            }
+            uint32_t node = root;
+            std::size_t position = 0;
+
+            while (position < key.size())
+            {
+                uint32_t previous = none;
+                uint32_t child = find_child(node, key[position], previous);
+                if (child == none)
+                {
+                    //a new leaf holding the rest of the word
+                    const uint32_t leaf = new_node(append_label(key.data() + position, key.size() - position), static_cast<uint32_t>(key.size() - position));
+                    link_child(node, leaf, previous);
+                    node = leaf;
+                    position = key.size();
+                    break;
+                }
+
+                const std::size_t common = common_length(m_nodes[child], key, position);
+                if (common < m_nodes[child].length)
+                {
+                    split(child, static_cast<uint32_t>(common));
+                }
+                node = child;
+                position += common;
+            }
+
+            if (m_nodes[node].terminal)
+            {
+                return false;
+            }
+            m_nodes[node].terminal = true;
+            ++m_words;
+            return true;
+        };
+
+        //! @brief remove a word
+        //! @param word the word to be removed
+        //! @return true if succes, false if the word is not there
+        bool remove_word(const std::string& word)
+        {
+            const std::string key = to_lower_case_word(word);
+
+            //the path from the root, to merge the edges left without branch
+            std::vector<uint32_t> path(1, root);
+            std::size_t position = 0;
+            while (position < key.size())
+            {
+                uint32_t previous = none;
+                const uint32_t child = find_child(path.back(), key[position], previous);
+                if (child == none || common_length(m_nodes[child], key, position) != m_nodes[child].length)
+                {
+                    return false;
+                }
+                position += m_nodes[child].length;
+                path.push_back(child);
+            }
+
+            const uint32_t node = path.back();
+            if (!m_nodes[node].terminal)
+            {
+                return false;
+            }
+            m_nodes[node].terminal = false;
+            --m_words;
+
+            if (m_nodes[node].first_child == none)
+            {
+                //a leaf : unlink it, then its parent may be left with one child
+                const uint32_t parent = path[path.size() - 2];
+                unlink_child(parent, node);
+                free_node(node);
+                if (parent != root && !m_nodes[parent].terminal && m_nodes[parent].first_child != none
+                    && m_nodes[m_nodes[parent].first_child].next_sibling == none)
+                {
+                    merge(parent);
+                }
+            }
+            else if (m_nodes[m_nodes[node].first_child].next_sibling == none)
+            {
+                merge(node);
+            }
+
+            if (m_unused > 4096 && m_unused * 2 > m_labels.size())
+            {
+                compact_labels();
+            }
+            return true;
+        };
+
+        //! @brief find if a word exist in the tree
+        //! @param word the word to be found
+        //! @return true if the word is found, false otherwise
+        bool find_word(const std::string& word) const
+        {
+            const std::string key = to_lower_case_word(word);
+            std::size_t position = 0;
+            const uint32_t node = find_node(key, position);
+            return node != none && position == key.size() && m_nodes[node].terminal;
+        };
+
+        //! @brief find the words starting with a given prefix, the walk stopping once enough words are found
+        //! @param prefix the given prefix
+        //! @param max_count the maximum number of words, the first ones in alphabetical order
+        //! @return the words, sorted
+        std::vector<std::string> find_prefix(const std::string& prefix, std::size_t max_count = std::numeric_limits<std::size_t>::max()) const
+        {
+            std::vector<std::string> result;
+            const std::string key = to_lower_case_word(prefix);
+
+            //the prefix may end inside an edge
+            std::size_t position = 0;
+            uint32_t node = root;
+            std::string path;
+            while (position < key.size())
+            {
+                uint32_t previous = none;
+                const uint32_t child = find_child(node, key[position], previous);
+                if (child == none)
+                {
+                    return result;
+                }
+                const std::size_t common = common_length(m_nodes[child], key, position);
+                if (common < m_nodes[child].length && position + common < key.size())
+                {
+                    return result;
+                }
+                path.append(label(child), m_nodes[child].length);
+                position += m_nodes[child].length;
+                node = child;
+            }
+
+            collect(node, path, result, max_count);
+            return result;
+        };
+
+        //! @brief find the words close to a given word : the tree is walked depth first with one bit-vector DP
+        //! row per char of the edges (see ZDMyersPattern), and an edge is left as soon as no prefix of the word is
+        //! close enough to the path leading to it. Words longer than 64 chars are compared one by one.
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            const std::string key = to_lower_case_word(word);
+            if (max_error < 0)
+            {
+                return result;
+            }
+
+            if (key.size() > ZDMyersPattern::max_size)
+            {
+                std::vector<std::string> all;
+                collect(root, std::string(), all, std::numeric_limits<std::size_t>::max());
+                for (auto& candidate : all)
+                {
+                    const int errors = levenshtein_distance(key, candidate, max_error);
+                    if (errors <= max_error)
+                    {
+                        result.emplace_back(std::move(candidate), errors);
+                    }
+                }
+            }
+            else
+            {
+                const ZDMyersPattern pattern(key);
+                std::string path;
+                fuzzy(root, pattern, pattern.first_row(), max_error, path, result);
+            }
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            return result;
+        };
+
+        //! @brief find the closest words to a given word : the number of errors grows from 0 until enough words
+        //! are found, so the walk stays as narrow as the words allow
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @param max_count the maximum number of words
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error, std::size_t max_count) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+            for (int errors = 0; errors <= max_error && result.size() < max_count; ++errors)
+            {
+                result = find_words(word, errors);
+            }
+            if (result.size() > max_count)
+            {
+                result.resize(max_count);
+            }
+            return result;
+        };
+
+        //! @brief get the number of words
+        //! @return
+        std::size_t word_count() const
+        {
+            return m_words;
+        };
+
+        //! @brief get the number of nodes in use, the root included
+        //! @return
+        std::size_t node_count() const
+        {
+            return m_nodes.size() - m_free.size();
+        };
+
+        //! @brief get the number of bytes of the label buffer, unused ones included
+        //! @return
+        std::size_t label_size() const
+        {
+            return m_labels.size();
+        };
+
+    private:
+
+        //! @brief the index standing for no node
+        static constexpr uint32_t none = 0xFFFFFFFFu;
+
+        //! @brief the index of the root, whose label is empty
+        static constexpr uint32_t root = 0;
+
+        //! @brief a node, and the edge leading to it
+        struct Node
+        {
+            uint32_t label = 0;             //!< offset of the label of the edge in the label buffer
+            uint32_t length = 0;            //!< length of the label
+            uint32_t first_child = none;    //!< children are sorted by the first char of their label
+            uint32_t next_sibling = none;
+            char first = 0;                 //!< first char of the label, to choose a child without reading the buffer
+            bool terminal = false;          //!< true if a word ends on this node
+        };
+
+        //! @brief get the label of a node
+        const char* label(uint32_t node) const
+        {
+            return m_labels.data() + m_nodes[node].label;
+        };
+
+        //! @brief find the child of a node whose label starts with a given char
+        //! @param previous the child before it, or before where it would be inserted; none if first
+        uint32_t find_child(uint32_t node, char c, uint32_t& previous) const
+        {
+            previous = none;
+            for (uint32_t child = m_nodes[node].first_child; child != none; child = m_nodes[child].next_sibling)
+            {
+                const unsigned char first = static_cast<unsigned char>(m_nodes[child].first);
+                if (first == static_cast<unsigned char>(c))
+                {
+                    return child;
+                }
+                if (first > static_cast<unsigned char>(c))
+                {
+                    break;
+                }
+                previous = child;
+            }
+            return none;
+        };
+
+        //! @brief find the node where a key ends, walking whole edges only
+        //! @param position the number of chars of the key matched
+        //! @return the last node reached, none if the key leaves the tree inside an edge
+        uint32_t find_node(const std::string& key, std::size_t& position) const
+        {
+            uint32_t node = root;
+            position = 0;
+            while (position < key.size())
+            {
+                uint32_t previous = none;
+                const uint32_t child = find_child(node, key[position], previous);
+                const uint32_t length = (child != none) ? m_nodes[child].length : 0;
+                if (child == none || key.size() - position < length || std::memcmp(label(child), key.data() + position, length) != 0)
+                {
+                    return none;
+                }
+                position += length;
+                node = child;
+            }
+            return node;
+        };
+
+        //! @brief get the number of chars shared by the label of a node and a key from a position
+        std::size_t common_length(const Node& node, const std::string& key, std::size_t position) const
+        {
+            const std::size_t length = std::min<std::size_t>(node.length, key.size() - position);
+            const char* edge = m_labels.data() + node.label;
+            //most edges match whole : check them at once
+            if (length == node.length && std::memcmp(edge, key.data() + position, length) == 0)
+            {
+                return length;
+            }
+            std::size_t common = 0;
+            while (common < length && edge[common] == key[position + common])
+            {
+                ++common;
+            }
+            return common;
+        };
+
+        //! @brief split the edge of a node after some chars : the node keeps the beginning of the label, a new
+        //! child takes the rest with the children and the word of the node
+        void split(uint32_t node, uint32_t length)
+        {
+            const uint32_t rest = new_node(m_nodes[node].label + length, m_nodes[node].length - length);
+            Node& child = m_nodes[rest];
+            Node& parent = m_nodes[node];
+            child.first_child = parent.first_child;
+            child.terminal = parent.terminal;
+            parent.first_child = rest;
+            parent.terminal = false;
+            parent.length = length;
+        };
+
+        //! @brief merge a node without word with its only child
+        void merge(uint32_t node)
+        {
+            const uint32_t child = m_nodes[node].first_child;
+            Node& parent = m_nodes[node];
+            const Node& merged = m_nodes[child];
+            if (parent.label + parent.length == merged.label)
+            {
+                //the labels follow each other in the buffer
+                parent.length += merged.length;
+            }
+            else
+            {
+                std::string joined(m_labels, parent.label, parent.length);
+                joined.append(m_labels, merged.label, merged.length);
+                m_unused += joined.size();
+                parent.label = append_label(joined.data(), joined.size());
+                parent.length += merged.length;
+            }
+            parent.first_child = merged.first_child;
+            parent.terminal = merged.terminal;
+            //the label of the child is now part of the label of the node
+            m_nodes[child].length = 0;
+            free_node(child);
+        };
+
+        //! @brief add a label to the buffer
+        //! @return its offset
+        uint32_t append_label(const char* text, std::size_t size)
+        {
+            const uint32_t offset = static_cast<uint32_t>(m_labels.size());
+            m_labels.append(text, size);
+            return offset;
+        };
+
+        //! @brief get a new node, reusing a freed one if any
+        uint32_t new_node(uint32_t labelOffset, uint32_t length)
+        {
+            uint32_t node = 0;
+            if (!m_free.empty())
+            {
+                node = m_free.back();
+                m_free.pop_back();
+                m_nodes[node] = Node();
+            }
+            else
+            {
+                node = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.push_back(Node());
+            }
+            m_nodes[node].label = labelOffset;
+            m_nodes[node].length = length;
+            m_nodes[node].first = m_labels[labelOffset];
+            return node;
+        };
+
+        //! @brief release a node, its label becomes unused
+        void free_node(uint32_t node)
+        {
+            m_unused += m_nodes[node].length;
+            m_nodes[node].length = 0;
+            m_free.push_back(node);
+        };
+
+        //! @brief insert a child after a given sibling, or first
+        void link_child(uint32_t node, uint32_t child, uint32_t previous)
+        {
+            if (previous == none)
+            {
+                m_nodes[child].next_sibling = m_nodes[node].first_child;
+                m_nodes[node].first_child = child;
+            }
+            else
+            {
+                m_nodes[child].next_sibling = m_nodes[previous].next_sibling;
+                m_nodes[previous].next_sibling = child;
+            }
+        };
+
+        //! @brief remove a child from the children of a node
+        void unlink_child(uint32_t node, uint32_t child)
+        {
+            uint32_t* link = &m_nodes[node].first_child;
+            while (*link != child)
+            {
+                link = &m_nodes[*link].next_sibling;
+            }
+            *link = m_nodes[child].next_sibling;
+        };
+
+        //! @brief copy the labels in use to a new buffer, in depth first order
+        void compact_labels()
+        {
+            std::string labels;
+            labels.reserve(m_labels.size() - m_unused);
+            std::vector<uint32_t> stack(1, root);
+            while (!stack.empty())
+            {
+                const uint32_t node = stack.back();
+                stack.pop_back();
+                const uint32_t offset = static_cast<uint32_t>(labels.size());
+                labels.append(m_labels, m_nodes[node].label, m_nodes[node].length);
+                m_nodes[node].label = offset;
+                for (uint32_t child = m_nodes[node].first_child; child != none; child = m_nodes[child].next_sibling)
+                {
+                    stack.push_back(child);
+                }
+            }
+            m_labels.swap(labels);
+            m_unused = 0;
+        };
+
+        //! @brief add the words of the subtree of a node, in alphabetical order, until there are max_count words
+        void collect(uint32_t node, std::string path, std::vector<std::string>& result, std::size_t max_count) const
+        {
+            if (m_nodes[node].terminal && result.size() < max_count)
+            {
+                result.push_back(path);
+            }
+            for (uint32_t child = m_nodes[node].first_child; child != none && result.size() < max_count; child = m_nodes[child].next_sibling)
+            {
+                path.append(label(child), m_nodes[child].length);
+                collect(child, path, result, max_count);
+                path.resize(path.size() - m_nodes[child].length);
+            }
+        };
+
+        //! @brief walk the subtrees of a node, advancing the DP row along each char of the edges
+        void fuzzy(uint32_t node, const ZDMyersPattern& pattern, const ZDMyersRow& parentRow, int max_error, std::string& path,
+            std::vector<std::pair<std::string, int>>& result) const
+        {
+            for (uint32_t child = m_nodes[node].first_child; child != none; child = m_nodes[child].next_sibling)
+            {
+                const char* edge = label(child);
+                const uint32_t length = m_nodes[child].length;
+                ZDMyersRow row = parentRow;
+                uint32_t i = 0;
+                for (; i < length; ++i)
+                {
+                    row = pattern.advance(row, edge[i]);
+                    if (pattern.minimum(row, max_error) > max_error)
+                    {
+                        break;
+                    }
+                }
+                if (i < length)
+                {
+                    continue;
+                }
+
+                path.append(edge, length);
+                if (m_nodes[child].terminal && row.score <= max_error)
+                {
+                    result.emplace_back(path, row.score);
+                }
+                fuzzy(child, pattern, row, max_error, path, result);
+                path.resize(path.size() - length);
+            }
+        };
+
+        //! @brief convert from upper case string to lower case string, string sould we ansi
+        static inline std::string to_lower_case_word(const std::string& upperCase)
+        {
+            std::string lowerCase(upperCase);
+            std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
+            return lowerCase;
+        };
+
+        //! @brief the nodes, the root first
+        std::vector<Node> m_nodes;
+
+        //! @brief the indices of the freed nodes, reused first
+        std::vector<uint32_t> m_free;
+
+        //! @brief the labels of all the edges
+        std::string m_labels;
+
+        //! @brief the number of bytes of the label buffer no longer used by an edge
+        std::size_t m_unused = 0;
+
+        //! @brief the number of words
+        std::size_t m_words = 0;
+    };
+}
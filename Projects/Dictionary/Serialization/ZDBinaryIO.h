@@ -0,0 +1,179 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace Dico
+{
+    //! @brief the largest part of a vector or a string read at once, in bytes (see read_vector)
+    constexpr std::size_t read_chunk = std::size_t(1) << 20;
+
+    //! @brief write a plain value to a binary stream, in the byte order of the machine
+    //! @param out the given stream
+    //! @param value the value to be written
+    template<class T>
+    inline void write_pod(std::ostream& out, const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "write_pod needs a trivially copyable type");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    //! @brief read a plain value from a binary stream
+    //! @param in the given stream
+    //! @param value the value read
+    //! @return true if succes, false otherwise
+    template<class T>
+    inline bool read_pod(std::istream& in, T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "read_pod needs a trivially copyable type");
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return static_cast<bool>(in);
+    }
+
+    //! @brief write a vector of plain values to a binary stream, preceded by its size
+    //! @param out the given stream
+    //! @param values the values to be written
+    template<class T>
+    inline void write_vector(std::ostream& out, const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "write_vector needs a trivially copyable type");
+        write_pod(out, static_cast<uint64_t>(values.size()));
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    //! @brief read a vector of plain values written by write_vector
+    //! @param in the given stream
+    //! @param values the values read
+    //! @return true if succes, false otherwise
+    template<class T>
+    inline bool read_vector(std::istream& in, std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "read_vector needs a trivially copyable type");
+        uint64_t size = 0;
+        if (!read_pod(in, size))
+        {
+            return false;
+        }
+        //the size comes from the file : the values are read by chunks, so a corrupt size fails at the end of the
+        //stream instead of allocating it at once
+        values.clear();
+        while (values.size() < size)
+        {
+            const std::size_t done = values.size();
+            const std::size_t chunk = static_cast<std::size_t>(std::min<uint64_t>(size - done, read_chunk / sizeof(T) + 1));
+            values.resize(done + chunk);
+            if (!in.read(reinterpret_cast<char*>(values.data() + done), static_cast<std::streamsize>(chunk * sizeof(T))))
+            {
+                return false;
+            }
+        }
+        return static_cast<bool>(in);
+    }
+
+    //! @brief write a string to a binary stream, preceded by its size
+    //! @param out the given stream
+    //! @param value the string to be written
+    inline void write_string(std::ostream& out, const std::string& value)
+    {
+        write_pod(out, static_cast<uint64_t>(value.size()));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    //! @brief read a string written by write_string
+    //! @param in the given stream
+    //! @param value the string read
+    //! @return true if succes, false otherwise
+    inline bool read_string(std::istream& in, std::string& value)
+    {
+        uint64_t size = 0;
+        if (!read_pod(in, size))
+        {
+            return false;
+        }
+        //read by chunks, as read_vector
+        value.clear();
+        while (value.size() < size)
+        {
+            const std::size_t done = value.size();
+            const std::size_t chunk = static_cast<std::size_t>(std::min<uint64_t>(size - done, read_chunk));
+            value.resize(done + chunk);
+            if (!in.read(&value[done], static_cast<std::streamsize>(chunk)))
+            {
+                return false;
+            }
+        }
+        return static_cast<bool>(in);
+    }
+
+    //! @brief write the header of a binary file : a four chars magic and a version
+    //! @param out the given stream
+    //! @param magic the four chars identifying the file type
+    //! @param version the version of the file format
+    inline void write_header(std::ostream& out, const char (&magic)[5], uint32_t version)
+    {
+        out.write(magic, 4);
+        write_pod(out, version);
+    }
+
+    //! @brief read and check the header of a binary file, accepting any version up to a given one
+    //! @param in the given stream
+    //! @param magic the four chars identifying the expected file type
+    //! @param version the version read
+    //! @param max_version the latest version of the file format
+    //! @return true if the header matches, false otherwise
+    inline bool read_header(std::istream& in, const char (&magic)[5], uint32_t& version, uint32_t max_version)
+    {
+        char read[4] = { 0 };
+        in.read(read, 4);
+        return in && std::string(read, 4) == std::string(magic, 4) && read_pod(in, version) && version >= 1 && version <= max_version;
+    }
+
+    //! @brief read and check the header of a binary file
+    //! @param in the given stream
+    //! @param magic the four chars identifying the expected file type
+    //! @param version the expected version of the file format
+    //! @return true if the header matches, false otherwise
+    inline bool read_header(std::istream& in, const char (&magic)[5], uint32_t version)
+    {
+        uint32_t readVersion = 0;
+        return read_header(in, magic, readVersion, version) && readVersion == version;
+    }
+
+    //! @brief compute the CRC-32 (IEEE) of a buffer, used to detect torn or corrupted records
+    //! @param data the given buffer
+    //! @param size the size of the buffer
+    //! @param crc the CRC of the previous bytes, to compute it in several parts
+    //! @return
+    inline uint32_t crc32(const void* data, std::size_t size, uint32_t crc = 0)
+    {
+        static const struct Table
+        {
+            uint32_t values[256];
+            Table()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t value = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                    }
+                    values[i] = value;
+                }
+            }
+        } table;
+
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            crc = table.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+}
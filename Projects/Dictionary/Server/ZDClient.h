@@ -0,0 +1,235 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Server/ZDProtocol.h"
+
+namespace Dico
+{
+    //! @brief this class is a client of the dictionary server (see ZDServer). The simple calls send one request
+    //! and wait for its answer; send and receive let several requests be sent before reading the answers,
+    //! which come back in the same order.
+    //! Linux only.
+    class ZDClient
+    {
+    public:
+        //! @brief defaut constructor, not connected
+        ZDClient() = default;
+
+        //! @brief distructor, close the connection
+        ~ZDClient()
+        {
+            close();
+        };
+
+        ZDClient(const ZDClient&) = delete;
+        ZDClient& operator=(const ZDClient&) = delete;
+
+        //! @brief connect to a server
+        //! @param path the path of the socket of the server
+        //! @return true if succes, false otherwise
+        bool connect(const std::string& path)
+        {
+            close();
+
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path))
+            {
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+            m_socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (m_socket < 0 || ::connect(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+            {
+                close();
+                return false;
+            }
+            return true;
+        };
+
+        //! @brief close the connection
+        void close()
+        {
+            if (m_socket >= 0)
+            {
+                ::close(m_socket);
+                m_socket = -1;
+            }
+            m_output.clear();
+            m_input.clear();
+            m_read = 0;
+        };
+
+        //! @brief true if connected
+        //! @return
+        bool is_connected() const
+        {
+            return m_socket >= 0;
+        };
+
+        //! @brief queue a request, it is sent by flush or receive. The server stops reading a client whose answers
+        //! are not read, so the number of requests in flight should stay bounded (a few thousands at most).
+        //! @param request the given request
+        void send(const ZDRequest& request)
+        {
+            ZDProtocol::write_request(request, m_output);
+        };
+
+        //! @brief send the queued requests
+        //! @return true if succes, false otherwise
+        bool flush()
+        {
+            std::size_t sent = 0;
+            while (sent < m_output.size())
+            {
+                const ssize_t size = ::send(m_socket, m_output.data() + sent, m_output.size() - sent, MSG_NOSIGNAL);
+                if (size < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                sent += static_cast<std::size_t>(size);
+            }
+            m_output.clear();
+            return true;
+        };
+
+        //! @brief wait for the answer of the oldest request not yet answered, the queued requests are sent first
+        //! @param response the answer
+        //! @return true if succes, false otherwise
+        bool receive(ZDResponse& response)
+        {
+            if (!flush())
+            {
+                return false;
+            }
+
+            while (true)
+            {
+                std::size_t used = 0;
+                if (!ZDProtocol::read_response(m_input.data() + m_read, m_input.size() - m_read, response, used))
+                {
+                    return false;
+                }
+                if (used != 0)
+                {
+                    m_read += used;
+                    if (m_read == m_input.size())
+                    {
+                        m_input.clear();
+                        m_read = 0;
+                    }
+                    return true;
+                }
+
+                char buffer[1 << 16];
+                const ssize_t size = ::recv(m_socket, buffer, sizeof(buffer), 0);
+                if (size == 0 || (size < 0 && errno != EINTR))
+                {
+                    return false;
+                }
+                if (size > 0)
+                {
+                    m_input.erase(0, m_read);
+                    m_read = 0;
+                    m_input.append(buffer, static_cast<std::size_t>(size));
+                }
+            }
+        };
+
+        //! @brief find if a word exist in the dictionary of the server
+        //! @param word the word to be found
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the server answered, false otherwise
+        //! - bool                  : true if the word is found, false othserwise
+        //! - uint32_t              : if founded, the weight of the word
+        std::tuple<bool, bool, uint32_t> find_word(const std::string& word)
+        {
+            ZDRequest request;
+            request.id = ++m_id;
+            request.operation = ZDOperation::Lookup;
+            request.key = word;
+
+            ZDResponse response;
+            send(request);
+            if (!receive(response))
+            {
+                return std::tuple<bool, bool, uint32_t>(false, false, 0);
+            }
+            const bool found = response.status == ZDStatus::Found && !response.results.empty();
+            return std::tuple<bool, bool, uint32_t>(true, found, found ? response.results.front().weight : 0);
+        };
+
+        //! @brief find the words of highest weight starting with a given prefix (see ZDDictionary::complete)
+        //! @param prefix the given prefix
+        //! @param count the maximum number of words
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the server answered, false otherwise
+        //! - std::vector<ZDResult> : the words, by decreasing weight
+        std::tuple<bool, std::vector<ZDResult>> complete(const std::string& prefix, uint16_t count)
+        {
+            ZDRequest request;
+            request.id = ++m_id;
+            request.operation = ZDOperation::Complete;
+            request.count = count;
+            request.key = prefix;
+            return call(request);
+        };
+
+        //! @brief find the words of highest weight close to a given word (see ZDDictionary::suggest)
+        //! @param word the given word
+        //! @param max_error the maximum number of errors, lowered by the server to ZDProtocol::max_suggest_error
+        //! @param count the maximum number of words
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the server answered, false otherwise
+        //! - std::vector<ZDResult> : the words, by decreasing weight
+        std::tuple<bool, std::vector<ZDResult>> suggest(const std::string& word, uint8_t max_error, uint16_t count)
+        {
+            ZDRequest request;
+            request.id = ++m_id;
+            request.operation = ZDOperation::Suggest;
+            request.max_error = max_error;
+            request.count = count;
+            request.key = word;
+            return call(request);
+        };
+
+    private:
+        //! @brief send a request and wait for its answer
+        std::tuple<bool, std::vector<ZDResult>> call(const ZDRequest& request)
+        {
+            ZDResponse response;
+            send(request);
+            if (!receive(response) || response.id != request.id || response.status == ZDStatus::BadRequest)
+            {
+                return std::tuple<bool, std::vector<ZDResult>>(false, std::vector<ZDResult>());
+            }
+            return std::tuple<bool, std::vector<ZDResult>>(true, std::move(response.results));
+        };
+
+        //! @brief the connected socket
+        int m_socket = -1;
+
+        //! @brief the requests not yet sent
+        std::string m_output;
+
+        //! @brief the bytes received, from m_read not yet a whole answer
+        std::string m_input;
+        std::size_t m_read = 0;
+
+        //! @brief the id of the last request sent by the simple calls
+        uint32_t m_id = 0;
+    };
+}
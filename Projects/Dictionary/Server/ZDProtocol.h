@@ -0,0 +1,225 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace Dico
+{
+    //! @brief the requests of the dictionary server
+    enum class ZDOperation : uint8_t
+    {
+        Lookup = 1,         //!< is the word in the dictionary, and its weight
+        Complete = 2,       //!< the words of highest weight starting with a prefix (ZDDictionary::complete)
+        Suggest = 3,        //!< the words of highest weight close to a word (ZDDictionary::suggest)
+    };
+
+    //! @brief the status of an answer of the dictionary server
+    enum class ZDStatus : uint8_t
+    {
+        Found = 0,          //!< the request has results
+        NotFound = 1,       //!< the request has no result
+        BadRequest = 2,     //!< the request is malformed
+    };
+
+    //! @brief a request to the dictionary server
+    struct ZDRequest
+    {
+        uint32_t id = 0;                            //!< chosen by the client, copied in the answer
+        ZDOperation operation = ZDOperation::Lookup;
+        uint8_t max_error = 0;                      //!< the maximum number of errors, for Suggest
+        uint16_t count = 0;                         //!< the maximum number of results, for Complete and Suggest
+        std::string key;                            //!< the word or the prefix
+    };
+
+    //! @brief a word answered by the dictionary server
+    struct ZDResult
+    {
+        std::string word;
+        uint8_t errors = 0;                         //!< the number of errors, for Suggest
+        uint32_t weight = 0;
+    };
+
+    //! @brief an answer of the dictionary server
+    struct ZDResponse
+    {
+        uint32_t id = 0;                            //!< the id of the request
+        ZDStatus status = ZDStatus::NotFound;
+        std::vector<ZDResult> results;
+    };
+
+    //! @brief this class reads and writes the frames of the dictionary server protocol. Both sides run on the
+    //! same host, so values are in the byte order of the machine. Every frame starts with its size, not
+    //! counting the size itself, so several frames can be sent without waiting for the answers (pipelining)
+    //! and are split again on reception.
+    //! - request  : uint32 size, uint32 id, uint8 operation, uint8 max error, uint16 count, the key
+    //! - response : uint32 size, uint32 id, uint8 status, uint8 unused, uint16 result count, then for each
+    //!              result uint8 word size, uint8 errors, uint32 weight, the word
+    class ZDProtocol
+    {
+    public:
+        //! @brief the largest response frame accepted : max_count results of max_word chars fit in it
+        static constexpr uint32_t max_frame = 1 << 20;
+
+        //! @brief the largest key and word
+        static constexpr std::size_t max_word = 255;
+
+        //! @brief the largest number of results of a request
+        static constexpr uint16_t max_count = 1000;
+
+        //! @brief the largest number of errors of a suggestion, a larger one is lowered to it : the search grows
+        //! quickly with the errors, and it runs on the thread serving every client
+        static constexpr uint8_t max_suggest_error = 3;
+
+        //! @brief append a request frame to a buffer
+        //! @param request the given request, its key is truncated to max_word chars
+        //! @param buffer the given buffer
+        static void write_request(const ZDRequest& request, std::string& buffer)
+        {
+            const std::size_t keySize = std::min(request.key.size(), max_word);
+            put(buffer, static_cast<uint32_t>(8 + keySize));
+            put(buffer, request.id);
+            put(buffer, static_cast<uint8_t>(request.operation));
+            put(buffer, request.max_error);
+            put(buffer, request.count);
+            buffer.append(request.key, 0, keySize);
+        };
+
+        //! @brief read a request frame from the start of a buffer
+        //! @param data the given buffer
+        //! @param size the number of bytes in the buffer
+        //! @param request the request read
+        //! @param used the size of the frame, 0 if the buffer does not hold a whole frame yet
+        //! @return false if the frame is malformed, the connection should be closed
+        static bool read_request(const char* data, std::size_t size, ZDRequest& request, std::size_t& used)
+        {
+            used = 0;
+            uint32_t frame = 0;
+            if (size < sizeof(frame))
+            {
+                return true;
+            }
+            get(data, frame);
+            if (frame < 8 || frame > 8 + max_word)
+            {
+                return false;
+            }
+            if (size < sizeof(frame) + frame)
+            {
+                return true;
+            }
+
+            const char* cursor = data + sizeof(frame);
+            uint8_t operation = 0;
+            cursor = get(cursor, request.id);
+            cursor = get(cursor, operation);
+            cursor = get(cursor, request.max_error);
+            cursor = get(cursor, request.count);
+            request.operation = static_cast<ZDOperation>(operation);
+            request.key.assign(cursor, frame - 8);
+            used = sizeof(frame) + frame;
+            return true;
+        };
+
+        //! @brief append a response frame to a buffer
+        //! @param response the given response, its words are truncated to max_word chars
+        //! @param buffer the given buffer
+        static void write_response(const ZDResponse& response, std::string& buffer)
+        {
+            const std::size_t start = buffer.size();
+            put(buffer, static_cast<uint32_t>(0));
+            put(buffer, response.id);
+            put(buffer, static_cast<uint8_t>(response.status));
+            put(buffer, static_cast<uint8_t>(0));
+            put(buffer, static_cast<uint16_t>(response.results.size()));
+            for (const auto& result : response.results)
+            {
+                const std::size_t wordSize = std::min(result.word.size(), max_word);
+                put(buffer, static_cast<uint8_t>(wordSize));
+                put(buffer, result.errors);
+                put(buffer, result.weight);
+                buffer.append(result.word, 0, wordSize);
+            }
+
+            //the size of the frame, known now
+            const uint32_t frame = static_cast<uint32_t>(buffer.size() - start - sizeof(uint32_t));
+            std::memcpy(&buffer[start], &frame, sizeof(frame));
+        };
+
+        //! @brief read a response frame from the start of a buffer
+        //! @param data the given buffer
+        //! @param size the number of bytes in the buffer
+        //! @param response the response read
+        //! @param used the size of the frame, 0 if the buffer does not hold a whole frame yet
+        //! @return false if the frame is malformed
+        static bool read_response(const char* data, std::size_t size, ZDResponse& response, std::size_t& used)
+        {
+            used = 0;
+            uint32_t frame = 0;
+            if (size < sizeof(frame))
+            {
+                return true;
+            }
+            get(data, frame);
+            if (frame < 8 || frame > max_frame)
+            {
+                return false;
+            }
+            if (size < sizeof(frame) + frame)
+            {
+                return true;
+            }
+
+            const char* cursor = data + sizeof(frame);
+            const char* end = cursor + frame;
+            uint8_t status = 0;
+            uint8_t unused = 0;
+            uint16_t count = 0;
+            cursor = get(cursor, response.id);
+            cursor = get(cursor, status);
+            cursor = get(cursor, unused);
+            cursor = get(cursor, count);
+            response.status = static_cast<ZDStatus>(status);
+            response.results.resize(count);
+            for (auto& result : response.results)
+            {
+                uint8_t wordSize = 0;
+                if (end - cursor < 6)
+                {
+                    return false;
+                }
+                cursor = get(cursor, wordSize);
+                cursor = get(cursor, result.errors);
+                cursor = get(cursor, result.weight);
+                if (end - cursor < wordSize)
+                {
+                    return false;
+                }
+                result.word.assign(cursor, wordSize);
+                cursor += wordSize;
+            }
+
+            used = sizeof(frame) + frame;
+            return cursor == end;
+        };
+
+    private:
+        //! @brief append a plain value to a buffer
+        template<class T>
+        static inline void put(std::string& buffer, const T& value)
+        {
+            buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        };
+
+        //! @brief read a plain value from a buffer
+        //! @return the position after the value
+        template<class T>
+        static inline const char* get(const char* data, T& value)
+        {
+            std::memcpy(&value, data, sizeof(T));
+            return data + sizeof(T);
+        };
+    };
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "ZDDictionary.h"
+#include "Server/ZDProtocol.h"
+#include "Trace/ZDTrace.h"
+
+namespace Dico
+{
+    //! @brief this class serves a dictionary over a Unix domain socket, so the processes of a host share one
+    //! dictionary instead of each building its own tree. One thread runs an epoll event loop over non-blocking
+    //! sockets : every whole request received is answered at once, in the order of reception, so clients can
+    //! send many requests without waiting for the answers (see ZDProtocol).
+    //! Linux only.
+    class ZDServer
+    {
+    public:
+        //! @brief build a server for a given dictionary, which must not be modified while the server runs
+        //! @param dictionary the given dictionary
+        explicit ZDServer(const ZDDictionary& dictionary)
+            : m_dictionary(dictionary)
+        {
+        };
+
+        //! @brief distructor, close the sockets
+        ~ZDServer()
+        {
+            close_all();
+        };
+
+        ZDServer(const ZDServer&) = delete;
+        ZDServer& operator=(const ZDServer&) = delete;
+
+        //! @brief create the socket and start listening; a file left at the path by a previous server is removed
+        //! @param path the path of the socket
+        //! @return true if succes, false otherwise
+        bool listen(const std::string& path)
+        {
+            close_all();
+
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path))
+            {
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            ::unlink(path.c_str());
+
+            m_listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+            m_wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_listener < 0 || m_epoll < 0 || m_wakeup < 0
+                || ::bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+                || ::listen(m_listener, SOMAXCONN) != 0
+                || !watch(m_listener, EPOLLIN, EPOLL_CTL_ADD)
+                || !watch(m_wakeup, EPOLLIN, EPOLL_CTL_ADD))
+            {
+                close_all();
+                return false;
+            }
+
+            m_path = path;
+            return true;
+        };
+
+        //! @brief run the event loop until stop is called
+        //! @return true if stopped, false on error
+        bool run()
+        {
+            if (m_epoll < 0)
+            {
+                return false;
+            }
+
+            epoll_event events[max_events];
+            while (true)
+            {
+                const int count = ::epoll_wait(m_epoll, events, max_events, -1);
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+
+                for (int e = 0; e < count; ++e)
+                {
+                    const int fd = events[e].data.fd;
+                    if (fd == m_wakeup)
+                    {
+                        uint64_t value = 0;
+                        ssize_t ignored = ::read(m_wakeup, &value, sizeof(value));
+                        (void)ignored;
+                        return true;
+                    }
+                    if (fd == m_listener)
+                    {
+                        accept_all();
+                        continue;
+                    }
+
+                    auto found = m_connections.find(fd);
+                    if (found == m_connections.end())
+                    {
+                        continue;
+                    }
+                    if (!serve(found->second, events[e].events))
+                    {
+                        disconnect(fd);
+                    }
+                }
+            }
+        };
+
+        //! @brief make run return; can be called from another thread or from a signal handler
+        void stop()
+        {
+            const uint64_t value = 1;
+            ssize_t ignored = ::write(m_wakeup, &value, sizeof(value));
+            (void)ignored;
+        };
+
+        //! @brief capture the requests received into a trace, to replay them later (see DictionaryReplay)
+        //! @param trace the given trace, opened, which must outlive the server; null to stop the capture
+        void set_trace(ZDTraceWriter* trace)
+        {
+            m_trace = trace;
+        };
+
+        //! @brief get the number of connected clients
+        //! @return
+        std::size_t connection_count() const
+        {
+            return m_connections.size();
+        };
+
+        //! @brief answer a request
+        //! @param request the given request
+        //! @param response the answer
+        void answer(const ZDRequest& request, ZDResponse& response) const
+        {
+            response.id = request.id;
+            response.status = ZDStatus::NotFound;
+            response.results.clear();
+            const std::size_t count = std::min(request.count, ZDProtocol::max_count);
+
+            switch (request.operation)
+            {
+            case ZDOperation::Lookup:
+            {
+                auto weight = m_dictionary.word_weight(request.key);
+                if (std::get<bool>(weight))
+                {
+                    response.results.push_back(ZDResult{ request.key, 0, std::get<uint32_t>(weight) });
+                }
+                break;
+            }
+            case ZDOperation::Complete:
+                for (auto& word : m_dictionary.complete(request.key, count))
+                {
+                    response.results.push_back(ZDResult{ std::move(word.first), 0, word.second });
+                }
+                break;
+            case ZDOperation::Suggest:
+                for (auto& word : m_dictionary.suggest(request.key, std::min(request.max_error, ZDProtocol::max_suggest_error), count))
+                {
+                    response.results.push_back(ZDResult{ std::move(std::get<std::string>(word)), static_cast<uint8_t>(std::get<int>(word)), std::get<uint32_t>(word) });
+                }
+                break;
+            default:
+                response.status = ZDStatus::BadRequest;
+                return;
+            }
+
+            if (!response.results.empty())
+            {
+                response.status = ZDStatus::Found;
+            }
+        };
+
+    private:
+
+        //! @brief a connected client
+        struct Connection
+        {
+            int fd = -1;
+            std::string input;              //!< bytes received, not yet a whole request
+            std::string output;             //!< answers not yet sent
+            std::size_t sent = 0;           //!< bytes of the output already sent
+            bool reading = true;            //!< false while too many answers wait to be sent
+            bool writing = false;           //!< true while answers wait for the socket to accept them
+        };
+
+        //! @brief the number of events handled per wait
+        static constexpr int max_events = 64;
+
+        //! @brief the size of the reads
+        static constexpr std::size_t read_size = 1 << 16;
+
+        //! @brief stop reading a client while more answer bytes than this wait to be sent
+        static constexpr std::size_t max_output = 1 << 20;
+
+        //! @brief add or change the events watched on a socket
+        bool watch(int fd, uint32_t events, int operation)
+        {
+            epoll_event event = {};
+            event.events = events;
+            event.data.fd = fd;
+            return ::epoll_ctl(m_epoll, operation, fd, &event) == 0;
+        };
+
+        //! @brief accept the waiting clients
+        void accept_all()
+        {
+            while (true)
+            {
+                const int fd = ::accept4(m_listener, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    return;
+                }
+                if (!watch(fd, EPOLLIN, EPOLL_CTL_ADD))
+                {
+                    ::close(fd);
+                    continue;
+                }
+                m_connections[fd].fd = fd;
+            }
+        };
+
+        //! @brief handle the events of a client : read and answer its requests, send the answers
+        //! @return false if the connection must be closed
+        bool serve(Connection& connection, uint32_t events)
+        {
+            if (events & (EPOLLERR | EPOLLHUP))
+            {
+                return false;
+            }
+
+            if ((events & EPOLLIN) && connection.reading)
+            {
+                //read until the socket is empty, the event loop being level triggered nothing is lost if we stop early
+                char buffer[read_size];
+                while (connection.output.size() - connection.sent < max_output)
+                {
+                    const ssize_t size = ::read(connection.fd, buffer, sizeof(buffer));
+                    if (size == 0)
+                    {
+                        return false;
+                    }
+                    if (size < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        {
+                            return false;
+                        }
+                        break;
+                    }
+
+                    connection.input.append(buffer, static_cast<std::size_t>(size));
+                    if (!answer_all(connection))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            if (!flush(connection))
+            {
+                return false;
+            }
+
+            //watch the writes only while answers wait, stop reading while too many wait
+            const bool waiting = connection.sent < connection.output.size();
+            const bool reading = connection.output.size() - connection.sent < max_output;
+            if (reading != connection.reading || waiting != connection.writing)
+            {
+                connection.reading = reading;
+                connection.writing = waiting;
+                return watch(connection.fd, (reading ? static_cast<uint32_t>(EPOLLIN) : 0u) | (waiting ? static_cast<uint32_t>(EPOLLOUT) : 0u), EPOLL_CTL_MOD);
+            }
+            return true;
+        };
+
+        //! @brief answer the whole requests received from a client
+        //! @return false if a request is malformed
+        bool answer_all(Connection& connection)
+        {
+            std::size_t offset = 0;
+            while (true)
+            {
+                std::size_t used = 0;
+                if (!ZDProtocol::read_request(connection.input.data() + offset, connection.input.size() - offset, m_request, used))
+                {
+                    return false;
+                }
+                if (used == 0)
+                {
+                    break;
+                }
+                offset += used;
+
+                if (m_trace != nullptr)
+                {
+                    m_trace->record(m_request);
+                }
+                answer(m_request, m_response);
+                ZDProtocol::write_response(m_response, connection.output);
+            }
+            connection.input.erase(0, offset);
+            return true;
+        };
+
+        //! @brief send the answers waiting for a client, as much as the socket accepts
+        //! @return false if the connection is broken
+        bool flush(Connection& connection)
+        {
+            while (connection.sent < connection.output.size())
+            {
+                const ssize_t size = ::send(connection.fd, connection.output.data() + connection.sent, connection.output.size() - connection.sent, MSG_NOSIGNAL);
+                if (size < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return errno == EAGAIN || errno == EWOULDBLOCK;
+                }
+                connection.sent += static_cast<std::size_t>(size);
+            }
+
+            connection.output.clear();
+            connection.sent = 0;
+            return true;
+        };
+
+        //! @brief close the connection of a client
+        void disconnect(int fd)
+        {
+            ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, 0);
+            ::close(fd);
+            m_connections.erase(fd);
+        };
+
+        //! @brief close all the sockets and remove the socket file
+        void close_all()
+        {
+            for (auto& connection : m_connections)
+            {
+                ::close(connection.first);
+            }
+            m_connections.clear();
+
+            for (int* fd : { &m_listener, &m_epoll, &m_wakeup })
+            {
+                if (*fd >= 0)
+                {
+                    ::close(*fd);
+                    *fd = -1;
+                }
+            }
+
+            if (!m_path.empty())
+            {
+                ::unlink(m_path.c_str());
+                m_path.clear();
+            }
+        };
+
+        //! @brief the dictionary served
+        const ZDDictionary& m_dictionary;
+
+        //! @brief the path of the socket
+        std::string m_path;
+
+        //! @brief the listening socket, the event loop and the event waking it up to stop
+        int m_listener = -1;
+        int m_epoll = -1;
+        int m_wakeup = -1;
+
+        //! @brief the connected clients, by socket
+        std::unordered_map<int, Connection> m_connections;
+
+        //! @brief the trace capturing the requests, null if none
+        ZDTraceWriter* m_trace = nullptr;
+
+        //! @brief the request and answer being handled, kept to reuse their memory
+        ZDRequest m_request;
+        ZDResponse m_response;
+    };
+}
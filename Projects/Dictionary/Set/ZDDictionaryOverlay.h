@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include "ZDDictionary.h"
+
+namespace Dico
+{
+    //! @brief this class is a read-only view of a base dictionary with additions and a block list, answering as
+    //! ZDDictionary::merge then ZDDictionary::subtract would, without building the combined dictionary : a word
+    //! is found if it is in the base or in the additions, and not in the block list. The weight of an added word
+    //! replaces its weight in the base. The dictionaries are referenced, not copied, and must outlive the view.
+    class ZDDictionaryOverlay
+    {
+    public:
+        //! @brief build a view of a base dictionary with changes
+        //! @param base the base dictionary, typicaly the lexico
+        //! @param additions the words added to the base, null if none
+        //! @param removals the words removed from the base and from the additions, null if none
+        ZDDictionaryOverlay(const ZDDictionary& base, const ZDDictionary* additions, const ZDDictionary* removals)
+            : m_base(base)
+            , m_additions(additions)
+            , m_removals(removals)
+        {
+        };
+
+        //! @brief find if a word exist in the view
+        //! @param word the word to be found
+        //! @return true if the word is found, false otherwise
+        bool find_word(const std::string& word) const
+        {
+            return !removed(word) && (m_base.find_word(word) || (m_additions != 0 && m_additions->find_word(word)));
+        };
+
+        //! @brief get the weight of a word
+        //! @param word the given word
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the word is found, false othserwise
+        //! - uint32_t              : if founded, the weight of the word
+        std::tuple<bool, uint32_t> word_weight(const std::string& word) const
+        {
+            if (removed(word))
+            {
+                return std::tuple<bool, uint32_t>(false, 0);
+            }
+            if (m_additions != 0)
+            {
+                auto added = m_additions->word_weight(word);
+                if (std::get<bool>(added))
+                {
+                    return added;
+                }
+            }
+            return m_base.word_weight(word);
+        };
+
+        //! @brief find the words of the view close to a given word
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(const std::string& word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result = m_base.find_words(word, max_error);
+            if (m_additions != 0)
+            {
+                const auto added = m_additions->find_words(word, max_error);
+                result.insert(result.end(), added.begin(), added.end());
+            }
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            result.erase(std::remove_if(result.begin(), result.end(), [this](const std::pair<std::string, int>& found)
+            {
+                return removed(found.first);
+            }), result.end());
+            return result;
+        };
+
+        //! @brief find the words of highest weight starting with a given prefix (see ZDDictionary::complete). Each
+        //! dictionary is asked for enough more words to make up for the ones the view hides : the blocked words,
+        //! and for the base the added words too, whose weight is replaced.
+        //! @param prefix the given prefix, empty for the whole view
+        //! @param count the maximum number of words
+        //! @return the words with their weight, by decreasing weight then alphabetically
+        std::vector<std::pair<std::string, uint32_t>> complete(const std::string& prefix, std::size_t count) const
+        {
+            const std::size_t blocked = (m_removals != 0) ? m_removals->count_prefix(prefix) : 0;
+            const std::size_t shadowed = (m_additions != 0) ? m_additions->count_prefix(prefix) : 0;
+
+            std::vector<std::pair<std::string, uint32_t>> result;
+            if (m_additions != 0)
+            {
+                result = m_additions->complete(prefix, count + blocked);
+            }
+            for (auto& word : m_base.complete(prefix, count + blocked + shadowed))
+            {
+                if (m_additions == 0 || !m_additions->find_word(word.first))
+                {
+                    result.push_back(std::move(word));
+                }
+            }
+
+            result.erase(std::remove_if(result.begin(), result.end(), [this](const std::pair<std::string, uint32_t>& found)
+            {
+                return removed(found.first);
+            }), result.end());
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, uint32_t>& a, const std::pair<std::string, uint32_t>& b)
+            {
+                return a.second > b.second || (a.second == b.second && a.first < b.first);
+            });
+            if (result.size() > count)
+            {
+                result.resize(count);
+            }
+            return result;
+        };
+
+    private:
+        //! @brief true if a word is in the block list
+        bool removed(const std::string& word) const
+        {
+            return m_removals != 0 && m_removals->find_word(word);
+        };
+
+        //! @brief the dictionaries of the view
+        const ZDDictionary& m_base;
+        const ZDDictionary* m_additions;
+        const ZDDictionary* m_removals;
+    };
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Dico
+{
+    //! @brief this class counts values, typicaly latencies in nanoseconds, in log-linear buckets (HDR histogram) :
+    //! each power of two is split in sub_buckets buckets of the same width, so the percentiles are read with a
+    //! relative error below 1 / sub_buckets whatever the range of the values, in a fixed memory. Histograms of
+    //! several threads are added with merge.
+    class ZDHistogram
+    {
+    public:
+        //! @brief the number of buckets per power of two, as a power of two
+        static constexpr int sub_bucket_bits = 7;
+        static constexpr uint64_t sub_buckets = uint64_t(1) << sub_bucket_bits;
+
+        //! @brief defaut constructor, no value
+        ZDHistogram()
+            : m_counts((64 - sub_bucket_bits + 1) * sub_buckets, 0)
+        {
+        };
+
+        //! @brief count a value
+        //! @param value the given value
+        void record(uint64_t value)
+        {
+            ++m_counts[index(value)];
+            ++m_total;
+            m_min = std::min(m_min, value);
+            m_max = std::max(m_max, value);
+            m_sum += static_cast<double>(value);
+        };
+
+        //! @brief add the values of another histogram
+        //! @param other the given histogram
+        void merge(const ZDHistogram& other)
+        {
+            for (std::size_t i = 0; i < m_counts.size(); ++i)
+            {
+                m_counts[i] += other.m_counts[i];
+            }
+            m_total += other.m_total;
+            m_min = std::min(m_min, other.m_min);
+            m_max = std::max(m_max, other.m_max);
+            m_sum += other.m_sum;
+        };
+
+        //! @brief get the value below which a given part of the values are
+        //! @param part the given part, in [0, 1] (0.99 for the 99th percentile)
+        //! @return the highest value of the bucket reaching that part, 0 if there is no value
+        uint64_t percentile(double part) const
+        {
+            if (m_total == 0)
+            {
+                return 0;
+            }
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::min(1.0, std::max(0.0, part)) * static_cast<double>(m_total) + 0.5));
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < m_counts.size(); ++i)
+            {
+                seen += m_counts[i];
+                if (seen >= rank)
+                {
+                    return std::min(std::max(highest(i), m_min), m_max);
+                }
+            }
+            return m_max;
+        };
+
+        //! @brief get the number of values
+        //! @return
+        uint64_t count() const
+        {
+            return m_total;
+        };
+
+        //! @brief get the lowest value, 0 if there is no value
+        //! @return
+        uint64_t min() const
+        {
+            return (m_total == 0) ? 0 : m_min;
+        };
+
+        //! @brief get the highest value
+        //! @return
+        uint64_t max() const
+        {
+            return m_max;
+        };
+
+        //! @brief get the mean of the values, 0 if there is no value
+        //! @return
+        double mean() const
+        {
+            return (m_total == 0) ? 0.0 : m_sum / static_cast<double>(m_total);
+        };
+
+    private:
+        //! @brief get the bucket of a value : the values below sub_buckets have a bucket each, then each power of
+        //! two has sub_buckets buckets
+        static inline std::size_t index(uint64_t value)
+        {
+            if (value < sub_buckets)
+            {
+                return static_cast<std::size_t>(value);
+            }
+            const int magnitude = 63 - leading_zeros(value);
+            const int shift = magnitude - sub_bucket_bits;
+            return static_cast<std::size_t>((shift + 1) * sub_buckets + ((value >> shift) - sub_buckets));
+        };
+
+        //! @brief get the highest value of a bucket
+        static inline uint64_t highest(std::size_t index)
+        {
+            if (index < sub_buckets)
+            {
+                return index;
+            }
+            const int shift = static_cast<int>(index / sub_buckets) - 1;
+            const uint64_t low = (sub_buckets + index % sub_buckets) << shift;
+            return low + ((uint64_t(1) << shift) - 1);
+        };
+
+        //! @brief count the leading zero bits of a value not null
+        static inline int leading_zeros(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long bit = 0;
+            _BitScanReverse64(&bit, value);
+            return 63 - static_cast<int>(bit);
+#else
+            return __builtin_clzll(value);
+#endif
+        };
+
+        //! @brief the number of values of each bucket
+        std::vector<uint64_t> m_counts;
+
+        //! @brief the number, the extremes and the sum of the values
+        uint64_t m_total = 0;
+        uint64_t m_min = std::numeric_limits<uint64_t>::max();
+        uint64_t m_max = 0;
+        double m_sum = 0.0;
+    };
+}
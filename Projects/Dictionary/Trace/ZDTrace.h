@@ -0,0 +1,259 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include "Server/ZDProtocol.h"
+#include "Serialization/ZDBinaryIO.h"
+
+namespace Dico
+{
+    //! @brief a query of a trace
+    struct ZDTraceRecord
+    {
+        uint64_t time = 0;                          //!< nanoseconds since the start of the capture
+        ZDOperation operation = ZDOperation::Lookup;
+        uint8_t max_error = 0;                      //!< the maximum number of errors, for Suggest
+        uint16_t count = 0;                         //!< the maximum number of results, for Complete and Suggest
+        std::string key;                            //!< the word or the prefix
+    };
+
+    //! @brief this class captures a stream of queries into a compact binary trace, to replay real traffic later
+    //! (see DictionaryReplay). After the header, each query is written as the varint time since the previous
+    //! query in nanoseconds, the operation, the max error, the varint count, the varint key size and the key.
+    //! Queries are buffered and may be recorded from several threads.
+    class ZDTraceWriter
+    {
+    public:
+        //! @brief defaut constructor, not capturing
+        ZDTraceWriter() = default;
+
+        //! @brief distructor, write the queries left
+        ~ZDTraceWriter()
+        {
+            close();
+        };
+
+        ZDTraceWriter(const ZDTraceWriter&) = delete;
+        ZDTraceWriter& operator=(const ZDTraceWriter&) = delete;
+
+        //! @brief start a capture, the times of the queries are counted from now
+        //! @param outputFile the given path file, replaced
+        //! @return true if succes, false otherwise
+        bool open(const std::string& outputFile)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_file.close();
+            m_file.clear();
+            m_file.open(outputFile, std::ios::binary | std::ios::trunc);
+            if (!m_file.is_open())
+            {
+                return false;
+            }
+            write_header(m_file, file_magic, file_version);
+            m_start = std::chrono::steady_clock::now();
+            m_previous = 0;
+            m_records = 0;
+            m_buffer.clear();
+            return static_cast<bool>(m_file);
+        };
+
+        //! @brief check if a capture is running
+        //! @return
+        bool is_open() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_file.is_open();
+        };
+
+        //! @brief record a query, at the current time
+        //! @param request the query
+        void record(const ZDRequest& request)
+        {
+            record(request.operation, request.key, request.max_error, request.count);
+        };
+
+        //! @brief record a query, at the current time
+        //! @param operation the operation of the query
+        //! @param key the word or the prefix
+        //! @param max_error the maximum number of errors
+        //! @param count the maximum number of results
+        void record(ZDOperation operation, const std::string& key, uint8_t max_error = 0, uint16_t count = 0)
+        {
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_file.is_open())
+            {
+                return;
+            }
+
+            //the clock is read before the lock, so a query may come a bit before the previous one
+            const uint64_t time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count());
+            append_varint(m_buffer, (time > m_previous) ? time - m_previous : 0);
+            m_previous = std::max(time, m_previous);
+            m_buffer.push_back(static_cast<char>(operation));
+            m_buffer.push_back(static_cast<char>(max_error));
+            append_varint(m_buffer, count);
+            append_varint(m_buffer, key.size());
+            m_buffer += key;
+            ++m_records;
+
+            if (m_buffer.size() >= buffer_size)
+            {
+                m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_buffer.clear();
+            }
+        };
+
+        //! @brief get the number of queries recorded
+        //! @return
+        std::size_t record_count() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_records;
+        };
+
+        //! @brief write the queries left and end the capture
+        //! @return true if succes, false otherwise
+        bool close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_file.is_open())
+            {
+                return true;
+            }
+            m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_buffer.clear();
+            m_file.close();
+            return static_cast<bool>(m_file);
+        };
+
+        //! @brief the file type and version of the trace format
+        static constexpr char file_magic[5] = "ZDTR";
+        static constexpr uint32_t file_version = 1;
+
+    private:
+        //! @brief the size of the buffer written at once
+        static constexpr std::size_t buffer_size = 1 << 16;
+
+        //! @brief append a varint to a buffer
+        static void append_varint(std::string& buffer, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            buffer.push_back(static_cast<char>(value));
+        };
+
+        //! @brief the trace written, and the queries not written yet
+        std::ofstream m_file;
+        std::string m_buffer;
+
+        //! @brief the start of the capture, and the time of the last query
+        std::chrono::steady_clock::time_point m_start;
+        uint64_t m_previous = 0;
+
+        //! @brief the number of queries recorded
+        std::size_t m_records = 0;
+
+        //! @brief serialize the queries of several threads
+        mutable std::mutex m_mutex;
+    };
+
+    //! @brief this class reads a trace written by ZDTraceWriter
+    class ZDTraceReader
+    {
+    public:
+        //! @brief open a trace
+        //! @param inputFile the given path file
+        //! @return true if succes, false if the file can not be read or is not a trace
+        bool open(const std::string& inputFile)
+        {
+            m_file.close();
+            m_file.clear();
+            m_file.open(inputFile, std::ios::binary);
+            m_time = 0;
+            return m_file.is_open() && read_header(m_file, ZDTraceWriter::file_magic, ZDTraceWriter::file_version);
+        };
+
+        //! @brief read the next query
+        //! @param record the query read
+        //! @return false at the end of the trace, or if it is truncated
+        bool next(ZDTraceRecord& record)
+        {
+            uint64_t delta = 0;
+            uint64_t count = 0;
+            uint64_t size = 0;
+            char operation = 0;
+            char maxError = 0;
+            if (!read_varint(delta) || !m_file.get(operation) || !m_file.get(maxError) || !read_varint(count) || !read_varint(size)
+                || size > ZDProtocol::max_word)
+            {
+                return false;
+            }
+            record.key.resize(static_cast<std::size_t>(size));
+            if (size != 0 && !m_file.read(&record.key[0], static_cast<std::streamsize>(size)))
+            {
+                return false;
+            }
+            m_time += delta;
+            record.time = m_time;
+            record.operation = static_cast<ZDOperation>(operation);
+            record.max_error = static_cast<uint8_t>(maxError);
+            record.count = static_cast<uint16_t>(count);
+            return true;
+        };
+
+        //! @brief read a whole trace
+        //! @param inputFile the given path file
+        //! @param records the queries of the trace, appended
+        //! @return true if succes, false if the file can not be read or is not a trace
+        static bool read(const std::string& inputFile, std::vector<ZDTraceRecord>& records)
+        {
+            ZDTraceReader reader;
+            if (!reader.open(inputFile))
+            {
+                return false;
+            }
+            ZDTraceRecord record;
+            while (reader.next(record))
+            {
+                records.push_back(record);
+            }
+            return true;
+        };
+
+    private:
+        //! @brief read a varint of the trace
+        bool read_varint(uint64_t& value)
+        {
+            value = 0;
+            char byte = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (!m_file.get(byte))
+                {
+                    return false;
+                }
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        //! @brief the trace read
+        std::ifstream m_file;
+
+        //! @brief the time of the last query read
+        uint64_t m_time = 0;
+    };
+}
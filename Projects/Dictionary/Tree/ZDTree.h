@@ -8,6 +8,11 @@
 #include <queue>
 #include <algorithm>
 #include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include <unordered_map>
+#include <functional>
 
 namespace Dico
 {
@@ -20,6 +25,8 @@ namespace Dico
 		TreeNode();
 		TreeNode(const T&);
 		TreeNode(T&&);
+		/// Construct the data in place from the given arguments.
+		template<class... Args> explicit TreeNode(std::in_place_t, Args&&... args);
 
 		TreeNode<T>* parent;
 		TreeNode<T>* first_child, * last_child;
@@ -41,7 +48,14 @@ namespace Dico
 
 	template<class T>
 	TreeNode<T>::TreeNode(T&& val)
-		: parent(0), first_child(0), last_child(0), prev_sibling(0), next_sibling(0), data(val)
+		: parent(0), first_child(0), last_child(0), prev_sibling(0), next_sibling(0), data(std::move(val))
+	{
+	}
+
+	template<class T>
+	template<class... Args>
+	TreeNode<T>::TreeNode(std::in_place_t, Args&&... args)
+		: parent(0), first_child(0), last_child(0), prev_sibling(0), next_sibling(0), data(std::forward<Args>(args)...)
 	{
 	}
 
@@ -61,6 +75,9 @@ namespace Dico
 
 			ZDTree();                                    
 			~ZDTree();
+			/// Nodes are owned by the ZDTree, copying it would share them.
+			ZDTree(const ZDTree&) = delete;
+			ZDTree& operator=(const ZDTree&) = delete;
 		
 			/// Erase all nodes of the ZDTree.
 			void     clear();
@@ -69,6 +86,16 @@ namespace Dico
 			/// Erase all children of the node pointed to by iterator.
 			void     erase_children(const iterator_base&);
 
+			/// Move all nodes into one contiguous block, in an order keeping the nodes of a path close : breadth
+			/// first for the first levels, then below each node its children next to each other, followed by
+			/// the subtrees of these children in turn. The data are moved, the old nodes released. All
+			/// iterators are invalidated. Nodes inserted later are allocated one by one, as before.
+			void     relayout(unsigned int breadth_first_levels = 3);
+
+			/// Return the allocator of the nodes.
+			Tree_node_allocator& get_allocator() { return m_alloc; }
+			const Tree_node_allocator& get_allocator() const { return m_alloc; }
+
 			/// Return iterator to the beginning of the ZDTree.
 			inline pre_order_iterator   begin() const;
 			/// Return iterator to the end of the ZDTree.
@@ -90,6 +117,18 @@ namespace Dico
 			template<typename iter> iter append_child(iter position, const T& x);
 			template<typename iter> iter append_child(iter position, T&& x);
 
+			/// Insert node as previous sibling of node pointed to by position, its data constructed in place from args.
+			template<typename iter, class... Args> iter emplace(iter position, Args&&... args);
+			/// Insert node as last child of node pointed to by position, its data constructed in place from args.
+			template<typename iter, class... Args> iter emplace_child(iter position, Args&&... args);
+
+			/// Append one child per element of [first, last) to the node pointed to by position, each data being
+			/// constructed from *it (a std::move_iterator moves the elements). Return the first new child, or a
+			/// null iterator if the range is empty.
+			template<typename iter, class InputIterator> iter append_children(iter position, InputIterator first, InputIterator last);
+			/// Same as above for a whole range; the elements of an rvalue range are moved.
+			template<typename iter, class Range> iter append_children(iter position, Range&& range);
+
 
 		  /// Base class for iterators, only pointers stored, no traversal logic.
 		  /// 
@@ -178,6 +217,22 @@ namespace Dico
 	private :
 		Tree_node_allocator m_alloc;
 		void head_initialise();
+		/// Allocate a node and construct its data in place from args, the links being null.
+		template<class... Args> Tree_node* create_node(Args&&... args);
+		/// Link a new node as previous sibling of position.
+		Tree_node* link_before(Tree_node* position, Tree_node* tmp);
+		/// Link a new node as last child of position.
+		Tree_node* link_last_child(Tree_node* position, Tree_node* tmp);
+		/// Destroy a node, and release it unless it belongs to the block of the last relayout, the block being
+		/// released with its last node.
+		void destroy_node(Tree_node* node);
+		/// Release the block of the last relayout.
+		void release_block();
+
+		/// The block of nodes of the last relayout, its size, and the number of its nodes not destroyed yet.
+		Tree_node* m_block = 0;
+		size_t     m_block_size = 0;
+		size_t     m_block_used = 0;
 	};
 
 
@@ -516,6 +571,7 @@ namespace Dico
 	ZDTree<T, Tree_node_allocator>::~ZDTree()
 	{
 		clear();
+		release_block();
 		std::allocator_traits<decltype(m_alloc)>::destroy(m_alloc, head);
 		std::allocator_traits<decltype(m_alloc)>::destroy(m_alloc, feet);
 		std::allocator_traits<decltype(m_alloc)>::deallocate(m_alloc, head, 1);
@@ -554,8 +610,7 @@ namespace Dico
 			cur->next_sibling->prev_sibling = cur->prev_sibling;
 		}
 
-		std::allocator_traits<decltype(m_alloc)>::destroy(m_alloc, cur);
-		std::allocator_traits<decltype(m_alloc)>::deallocate(m_alloc, cur, 1);
+		destroy_node(cur);
 		return ret;
 	}
 
@@ -572,8 +627,7 @@ namespace Dico
 			prev = cur;
 			cur = cur->next_sibling;
 			erase_children(pre_order_iterator(prev));
-			std::allocator_traits<decltype(m_alloc)>::destroy(m_alloc, prev);
-			std::allocator_traits<decltype(m_alloc)>::deallocate(m_alloc, prev, 1);
+			destroy_node(prev);
 		}
 		it.node->first_child = 0;
 		it.node->last_child = 0;
@@ -616,57 +670,27 @@ namespace Dico
 	template <class iter>
 	iter ZDTree<T, Tree_node_allocator>::insert(iter position, const T& x)
 	{
-		if (position.node == 0) {
-			position.node = feet; // Backward compatibility: when calling insert on a null node,
-								// insert before the feet.
-		}
-		assert(position.node != head); // Cannot insert before head.
-
-		Tree_node* tmp = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, tmp, x);
-		tmp->first_child = 0;
-		tmp->last_child = 0;
-
-		tmp->parent = position.node->parent;
-		tmp->next_sibling = position.node;
-		tmp->prev_sibling = position.node->prev_sibling;
-		position.node->prev_sibling = tmp;
-
-		if (tmp->prev_sibling == 0) {
-			if (tmp->parent) // when inserting nodes at the head, there is no parent
-				tmp->parent->first_child = tmp;
-		}
-		else
-			tmp->prev_sibling->next_sibling = tmp;
-		return tmp;
+		return emplace(position, x);
 	}
 
 	template <class T, class Tree_node_allocator>
 	template <class iter>
 	iter ZDTree<T, Tree_node_allocator>::insert(iter position, T&& x)
+	{
+		return emplace(position, std::move(x));
+	}
+
+	template <class T, class Tree_node_allocator>
+	template <typename iter, class... Args>
+	iter ZDTree<T, Tree_node_allocator>::emplace(iter position, Args&&... args)
 	{
 		if (position.node == 0) {
 			position.node = feet; // Backward compatibility: when calling insert on a null node,
 								// insert before the feet.
 		}
-		Tree_node* tmp = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, tmp);
-		std::swap(tmp->data, x); // Move semantics
-		tmp->first_child = 0;
-		tmp->last_child = 0;
-
-		tmp->parent = position.node->parent;
-		tmp->next_sibling = position.node;
-		tmp->prev_sibling = position.node->prev_sibling;
-		position.node->prev_sibling = tmp;
+		assert(position.node != head); // Cannot insert before head.
 
-		if (tmp->prev_sibling == 0) {
-			if (tmp->parent) // when inserting nodes at the head, there is no parent
-				tmp->parent->first_child = tmp;
-		}
-		else
-			tmp->prev_sibling->next_sibling = tmp;
-		return tmp;
+		return link_before(position.node, create_node(std::forward<Args>(args)...));
 	}
 
 
@@ -674,26 +698,7 @@ namespace Dico
 	template <typename iter>
 	iter ZDTree<T, tree_node_allocator>::append_child(iter position)
 	{
-		assert(position.node != head);
-		assert(position.node != feet);
-		assert(position.node);
-
-		Tree_node* tmp = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, tmp, tree_node_<T>());
-		tmp->first_child = 0;
-		tmp->last_child = 0;
-
-		tmp->parent = position.node;
-		if (position.node->last_child != 0) {
-			position.node->last_child->next_sibling = tmp;
-		}
-		else {
-			position.node->first_child = tmp;
-		}
-		tmp->prev_sibling = position.node->last_child;
-		position.node->last_child = tmp;
-		tmp->next_sibling = 0;
-		return tmp;
+		return emplace_child(position);
 	}
 
 	template <class T, class tree_node_allocator>
@@ -704,64 +709,209 @@ namespace Dico
 		// node to an empty ZDTree. From version 1.45 the top element should be added
 		// using 'insert'. See the documentation for further information, and sorry about
 		// the API change.
+		return emplace_child(position, x);
+	}
+
+	template <class T, class tree_node_allocator>
+	template <class iter>
+	iter ZDTree<T, tree_node_allocator>::append_child(iter position, T&& x)
+	{
+		return emplace_child(position, std::move(x));
+	}
+
+	template <class T, class tree_node_allocator>
+	template <typename iter, class... Args>
+	iter ZDTree<T, tree_node_allocator>::emplace_child(iter position, Args&&... args)
+	{
 		assert(position.node != head);
 		assert(position.node != feet);
 		assert(position.node);
 
-		Tree_node* tmp = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, tmp, x);
-		tmp->first_child = 0;
-		tmp->last_child = 0;
-
-		tmp->parent = position.node;
-		if (position.node->last_child != 0) {
-			position.node->last_child->next_sibling = tmp;
-		}
-		else {
-			position.node->first_child = tmp;
-		}
-		tmp->prev_sibling = position.node->last_child;
-		position.node->last_child = tmp;
-		tmp->next_sibling = 0;
-		return tmp;
+		return link_last_child(position.node, create_node(std::forward<Args>(args)...));
 	}
 
 	template <class T, class tree_node_allocator>
-	template <class iter>
-	iter ZDTree<T, tree_node_allocator>::append_child(iter position, T&& x)
+	template <typename iter, class InputIterator>
+	iter ZDTree<T, tree_node_allocator>::append_children(iter position, InputIterator first, InputIterator last)
 	{
 		assert(position.node != head);
 		assert(position.node != feet);
 		assert(position.node);
 
-		Tree_node* tmp = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, tmp); // Here is where the move semantics kick in
-		std::swap(tmp->data, x);
+		Tree_node* ret = 0;
+		for (; first != last; ++first) {
+			Tree_node* tmp = link_last_child(position.node, create_node(*first));
+			if (ret == 0)
+				ret = tmp;
+		}
+		return ret;
+	}
+
+	template <class T, class tree_node_allocator>
+	template <typename iter, class Range>
+	iter ZDTree<T, tree_node_allocator>::append_children(iter position, Range&& range)
+	{
+		using std::begin;
+		using std::end;
+		if constexpr (std::is_lvalue_reference<Range>::value)
+			return append_children(position, begin(range), end(range));
+		else
+			return append_children(position, std::make_move_iterator(begin(range)), std::make_move_iterator(end(range)));
+	}
 
-		tmp->first_child = 0;
-		tmp->last_child = 0;
+	template <class T, class Tree_node_allocator>
+	template <class... Args>
+	typename ZDTree<T, Tree_node_allocator>::Tree_node* ZDTree<T, Tree_node_allocator>::create_node(Args&&... args)
+	{
+		typedef std::allocator_traits<Tree_node_allocator> traits;
+		Tree_node* tmp = traits::allocate(m_alloc, 1);
+		try {
+			traits::construct(m_alloc, tmp, std::in_place, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			traits::deallocate(m_alloc, tmp, 1);
+			throw;
+		}
+		return tmp;
+	}
+
+	template <class T, class Tree_node_allocator>
+	typename ZDTree<T, Tree_node_allocator>::Tree_node* ZDTree<T, Tree_node_allocator>::link_before(Tree_node* position, Tree_node* tmp)
+	{
+		tmp->parent = position->parent;
+		tmp->next_sibling = position;
+		tmp->prev_sibling = position->prev_sibling;
+		position->prev_sibling = tmp;
+
+		if (tmp->prev_sibling == 0) {
+			if (tmp->parent) // when inserting nodes at the head, there is no parent
+				tmp->parent->first_child = tmp;
+		}
+		else
+			tmp->prev_sibling->next_sibling = tmp;
+		return tmp;
+	}
 
-		tmp->parent = position.node;
-		if (position.node->last_child != 0) {
-			position.node->last_child->next_sibling = tmp;
+	template <class T, class Tree_node_allocator>
+	typename ZDTree<T, Tree_node_allocator>::Tree_node* ZDTree<T, Tree_node_allocator>::link_last_child(Tree_node* position, Tree_node* tmp)
+	{
+		tmp->parent = position;
+		if (position->last_child != 0) {
+			position->last_child->next_sibling = tmp;
 		}
 		else {
-			position.node->first_child = tmp;
+			position->first_child = tmp;
 		}
-		tmp->prev_sibling = position.node->last_child;
-		position.node->last_child = tmp;
+		tmp->prev_sibling = position->last_child;
+		position->last_child = tmp;
 		tmp->next_sibling = 0;
 		return tmp;
 	}
 
 
+	template <class T, class Tree_node_allocator>
+	void ZDTree<T, Tree_node_allocator>::destroy_node(Tree_node* node)
+	{
+		std::allocator_traits<decltype(m_alloc)>::destroy(m_alloc, node);
+		const std::less<Tree_node*> before;
+		if (m_block == 0 || before(node, m_block) || !before(node, m_block + m_block_size))
+			std::allocator_traits<decltype(m_alloc)>::deallocate(m_alloc, node, 1);
+		else if (--m_block_used == 0)
+			release_block();
+	}
+
+	template <class T, class Tree_node_allocator>
+	void ZDTree<T, Tree_node_allocator>::release_block()
+	{
+		if (m_block != 0)
+			std::allocator_traits<decltype(m_alloc)>::deallocate(m_alloc, m_block, m_block_size);
+		m_block = 0;
+		m_block_size = 0;
+		m_block_used = 0;
+	}
+
+	template <class T, class Tree_node_allocator>
+	void ZDTree<T, Tree_node_allocator>::relayout(unsigned int breadth_first_levels)
+	{
+		// The new order of the nodes : the first levels breadth first...
+		std::vector<Tree_node*> order;
+		for (Tree_node* root = head->next_sibling; root != feet; root = root->next_sibling)
+			order.push_back(root);
+
+		size_t level_begin = 0;
+		for (unsigned int level = 1; level < breadth_first_levels; ++level) {
+			const size_t level_end = order.size();
+			for (size_t i = level_begin; i < level_end; ++i)
+				for (Tree_node* child = order[i]->first_child; child != 0; child = child->next_sibling)
+					order.push_back(child);
+			level_begin = level_end;
+		}
+
+		// ...then below each node of the last of them, the children of a node next to each other, followed by
+		// the subtree of each child.
+		const size_t level_end = order.size();
+		std::vector<std::pair<size_t, size_t>> stack;
+		for (size_t i = level_begin; i < level_end; ++i) {
+			stack.push_back(std::make_pair(i, i + 1));
+			while (!stack.empty()) {
+				std::pair<size_t, size_t>& range = stack.back();
+				if (range.first == range.second) {
+					stack.pop_back();
+					continue;
+				}
+				Tree_node* node = order[range.first++];
+				const size_t children = order.size();
+				for (Tree_node* child = node->first_child; child != 0; child = child->next_sibling)
+					order.push_back(child);
+				if (order.size() != children)
+					stack.push_back(std::make_pair(children, order.size()));
+			}
+		}
+
+		if (order.empty()) {
+			release_block();
+			return;
+		}
+
+		// Move the data into the block, then link the new nodes like the old ones.
+		typedef std::allocator_traits<Tree_node_allocator> traits;
+		Tree_node* block = traits::allocate(m_alloc, order.size());
+		std::unordered_map<Tree_node*, Tree_node*> moved;
+		moved.reserve(order.size() + 2);
+		moved[0] = 0;
+		moved[head] = head;
+		moved[feet] = feet;
+		for (size_t i = 0; i < order.size(); ++i) {
+			traits::construct(m_alloc, block + i, std::in_place, std::move(order[i]->data));
+			moved[order[i]] = block + i;
+		}
+		for (size_t i = 0; i < order.size(); ++i) {
+			const Tree_node* old = order[i];
+			Tree_node* node = block + i;
+			node->parent = moved[old->parent];
+			node->first_child = moved[old->first_child];
+			node->last_child = moved[old->last_child];
+			node->prev_sibling = moved[old->prev_sibling];
+			node->next_sibling = moved[old->next_sibling];
+		}
+		head->next_sibling = block;
+		feet->prev_sibling = moved[feet->prev_sibling];
+
+		// Release the old nodes, the old block going with the last of its nodes.
+		for (Tree_node* old : order)
+			destroy_node(old);
+		m_block = block;
+		m_block_size = order.size();
+		m_block_used = order.size();
+	}
+
 	template <class T, class Tree_node_allocator>
 	void ZDTree<T, Tree_node_allocator>::head_initialise()
 	{
-		head = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		feet = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1, 0);
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, head, TreeNode<T>());
-		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, feet, TreeNode<T>());
+		head = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1);
+		feet = std::allocator_traits<decltype(m_alloc)>::allocate(m_alloc, 1);
+		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, head);
+		std::allocator_traits<decltype(m_alloc)>::construct(m_alloc, feet);
 
 		head->parent = 0;
 		head->first_child = 0;
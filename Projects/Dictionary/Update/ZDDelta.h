@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <fstream>
+#include "ZDDictionary.h"
+
+namespace Dico
+{
+    //! @brief a change of a dictionary : one word inserted or removed
+    struct ZDChange
+    {
+        bool insert = true;                 //!< true to insert the word, false to remove it
+        bool weighted = false;              //!< true if the weight is given, otherwise an inserted word keeps its weight
+        uint32_t weight = 0;
+        std::string word;
+    };
+
+    //! @brief this class is a list of changes of a dictionary, read from a delta file : one change per line,
+    //! "+word" to insert a word (optionally followed by a tab and its weight, as in the lexico) and "-word" to
+    //! remove it. Empty lines and lines starting with '#' are ignored.
+    //! Applying a delta only touches the changed words, and applying it twice gives the same dictionary, so a
+    //! delta file can grow and be applied again after each change.
+    class ZDDelta
+    {
+    public:
+        //! @brief defaut constructor, no change
+        ZDDelta() = default;
+
+        //! @brief read the changes from a stream, added to the current ones
+        //! @param in the given stream
+        //! @return true if succes, false if a line is malformed (the previous lines are kept)
+        bool read(std::istream& in)
+        {
+            std::string line;
+            while (std::getline(in, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+                if (line.empty() || line[0] == '#')
+                {
+                    continue;
+                }
+                if ((line[0] != '+' && line[0] != '-') || line.size() == 1)
+                {
+                    return false;
+                }
+
+                ZDChange change;
+                change.insert = line[0] == '+';
+                const std::size_t tab = line.find('\t');
+                if (tab != std::string::npos)
+                {
+                    change.weighted = true;
+                    change.weight = static_cast<uint32_t>(std::strtoul(line.c_str() + tab + 1, nullptr, 10));
+                    line.erase(tab);
+                }
+                change.word = line.substr(1);
+                m_changes.push_back(std::move(change));
+            }
+            return true;
+        };
+
+        //! @brief read the changes from a given path file, added to the current ones
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool read(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile);
+            return file.is_open() && read(file);
+        };
+
+        //! @brief apply the changes to a dictionary, in order
+        //! @param dictionary the given dictionary
+        //! @return the number of changes applied, the others being words without a root or removed words not found
+        std::size_t apply(ZDDictionary& dictionary) const
+        {
+            std::size_t result = 0;
+            for (const auto& change : m_changes)
+            {
+                bool applied = false;
+                if (!change.insert)
+                {
+                    applied = dictionary.remove_word(change.word);
+                }
+                else if (change.weighted)
+                {
+                    applied = dictionary.insert_word(change.word, change.weight);
+                }
+                else
+                {
+                    applied = dictionary.insert_word(change.word);
+                }
+                result += applied ? 1 : 0;
+            }
+            return result;
+        };
+
+        //! @brief add a change
+        //! @param change the given change
+        void add(const ZDChange& change)
+        {
+            m_changes.push_back(change);
+        };
+
+        //! @brief get the changes, in order
+        //! @return
+        const std::vector<ZDChange>& changes() const
+        {
+            return m_changes;
+        };
+
+        //! @brief true if there is no change
+        //! @return
+        bool empty() const
+        {
+            return m_changes.empty();
+        };
+
+        //! @brief remove all the changes
+        void clear()
+        {
+            m_changes.clear();
+        };
+
+    private:
+        //! @brief the changes, in order
+        std::vector<ZDChange> m_changes;
+    };
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <functional>
+#include <cstdint>
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace Dico
+{
+    //! @brief this class calls a function each time a file is written, from a thread of its own. The directory of
+    //! the file is watched rather than the file, so a file replaced by a rename (as most editors and deploy tools
+    //! do) is still seen.
+    //! Linux only (inotify).
+    class ZDFileWatcher
+    {
+    public:
+        //! @brief the function called when the file changes, with its path
+        typedef std::function<void(const std::string&)> Callback;
+
+        //! @brief defaut constructor, not watching
+        ZDFileWatcher() = default;
+
+        //! @brief distructor, stop watching
+        ~ZDFileWatcher()
+        {
+            stop();
+        };
+
+        ZDFileWatcher(const ZDFileWatcher&) = delete;
+        ZDFileWatcher& operator=(const ZDFileWatcher&) = delete;
+
+        //! @brief start watching a file
+        //! @param path the path of the file, its directory must exist
+        //! @param callback called after each write of the file
+        //! @return true if succes, false otherwise
+        bool start(const std::string& path, const Callback& callback)
+        {
+            stop();
+
+            const std::size_t slash = path.find_last_of('/');
+            const std::string directory = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+            m_name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+            m_path = path;
+            m_callback = callback;
+
+            m_inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            m_wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_inotify < 0 || m_wakeup < 0 || ::inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+            {
+                close_all();
+                return false;
+            }
+
+            m_thread = std::thread([this]() { loop(); });
+            return true;
+        };
+
+        //! @brief stop watching, wait for the callback running if any
+        void stop()
+        {
+            if (m_thread.joinable())
+            {
+                const uint64_t value = 1;
+                ssize_t ignored = ::write(m_wakeup, &value, sizeof(value));
+                (void)ignored;
+                m_thread.join();
+            }
+            close_all();
+        };
+
+        //! @brief true if watching
+        //! @return
+        bool is_watching() const
+        {
+            return m_thread.joinable();
+        };
+
+    private:
+        //! @brief wait for the events of the directory until stopped
+        void loop()
+        {
+            alignas(inotify_event) char buffer[4096];
+            pollfd fds[2] = { { m_inotify, POLLIN, 0 }, { m_wakeup, POLLIN, 0 } };
+            while (true)
+            {
+                if (::poll(fds, 2, -1) < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return;
+                }
+                if (fds[1].revents != 0)
+                {
+                    return;
+                }
+
+                //several events of the file are reported once
+                bool changed = false;
+                ssize_t size = 0;
+                while ((size = ::read(m_inotify, buffer, sizeof(buffer))) > 0)
+                {
+                    for (char* cursor = buffer; cursor < buffer + size;)
+                    {
+                        const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                        if (event->len != 0 && m_name == event->name)
+                        {
+                            changed = true;
+                        }
+                        cursor += sizeof(inotify_event) + event->len;
+                    }
+                }
+
+                if (changed)
+                {
+                    m_callback(m_path);
+                }
+            }
+        };
+
+        //! @brief close the descriptors
+        void close_all()
+        {
+            for (int* fd : { &m_inotify, &m_wakeup })
+            {
+                if (*fd >= 0)
+                {
+                    ::close(*fd);
+                    *fd = -1;
+                }
+            }
+        };
+
+        //! @brief the watched file, and its name in its directory
+        std::string m_path;
+        std::string m_name;
+
+        //! @brief the function called when the file changes
+        Callback m_callback;
+
+        //! @brief the inotify instance and the event waking the thread up to stop
+        int m_inotify = -1;
+        int m_wakeup = -1;
+
+        //! @brief the thread waiting for the events
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include "ZDDictionary.h"
+#include "Update/ZDDelta.h"
+#include "Update/ZDFileWatcher.h"
+
+namespace Dico
+{
+    //! @brief this class is a dictionary updated while it is read. It keeps two copies of the dictionary : readers
+    //! take the current one (see snapshot) and are never blocked, while a delta is applied to the other one, which
+    //! is then made current in one atomic swap. Once the readers of the old copy are gone, the same delta is
+    //! applied to it, so both copies stay equal and each update costs the size of the delta, not of the lexico.
+    //! Updates are serialized. A delta file can be watched : the lines appended to it are applied each time it is
+    //! written, and the whole file again if it is replaced.
+    class ZDLiveDictionary
+    {
+    public:
+        //! @brief the readable copy of the dictionary
+        typedef std::shared_ptr<const ZDDictionary> Snapshot;
+
+        //! @brief build a live dictionary holding the words of a given dictionary
+        //! @param initial the given dictionary, copied twice
+        explicit ZDLiveDictionary(const ZDDictionary& initial)
+            : m_handoff(std::make_shared<Handoff>())
+            , m_copies{ copy(initial), copy(initial) }
+            , m_standby(m_copies[0])
+            , m_current(publish(m_copies[1]))
+        {
+        };
+
+        //! @brief distructor, stop watching
+        ~ZDLiveDictionary()
+        {
+            m_watcher.stop();
+        };
+
+        ZDLiveDictionary(const ZDLiveDictionary&) = delete;
+        ZDLiveDictionary& operator=(const ZDLiveDictionary&) = delete;
+
+        //! @brief get the current copy of the dictionary, for reading. It stays valid and unchanged as long as it is
+        //! held, but it should be released after each query : an update waits for the readers of the old copy.
+        //! A thread holding a snapshot must not update the dictionary (apply, optimize), it would wait for itself.
+        //! @return
+        Snapshot snapshot() const
+        {
+            return std::atomic_load(&m_current);
+        };
+
+        //! @brief apply changes to the dictionary
+        //! @param delta the given changes
+        //! @return the number of changes applied
+        std::size_t apply(const ZDDelta& delta)
+        {
+            std::size_t result = 0;
+            update([&](ZDDictionary& dictionary, bool first)
+            {
+                const std::size_t applied = delta.apply(dictionary);
+                if (first)
+                {
+                    result = applied;
+                }
+            });
+            return result;
+        };
+
+        //! @brief lay out the nodes of the dictionary again for locality (see ZDDictionary::optimize), without
+        //! blocking the readers; meant to be called periodically after many updates
+        void optimize()
+        {
+            update([](ZDDictionary& dictionary, bool)
+            {
+                dictionary.optimize();
+            });
+        };
+
+        //! @brief apply the changes of a delta file
+        //! @param deltaFile the path of the delta file
+        //! @return true if succes, false if the file can not be read or is malformed (nothing is applied)
+        bool apply(const std::string& deltaFile)
+        {
+            ZDDelta delta;
+            if (!delta.read(deltaFile))
+            {
+                return false;
+            }
+            apply(delta);
+            return true;
+        };
+
+        //! @brief apply a delta file now if it exists, then the lines appended to it each time it is written
+        //! @param deltaFile the path of the delta file
+        //! @return true if succes, false if the file can not be watched
+        bool watch(const std::string& deltaFile)
+        {
+            m_watcher.stop();
+            m_watched = WatchedFile();
+            apply_appended(deltaFile);
+            return m_watcher.start(deltaFile, [this](const std::string& path)
+            {
+                apply_appended(path);
+            });
+        };
+
+        //! @brief stop watching the delta file
+        void unwatch()
+        {
+            m_watcher.stop();
+        };
+
+        //! @brief get the number of updates applied, optimizations included
+        //! @return
+        uint64_t version() const
+        {
+            return m_version;
+        };
+
+        //! @brief get the number of malformed lines of the watched delta file, skipped (see watch)
+        //! @return
+        uint64_t rejected_lines() const
+        {
+            return m_rejected;
+        };
+
+    private:
+        //! @brief signals the end of the readers of a copy : each time a copy is made current, the snapshots of it
+        //! share a new count, and the last one released gives the copy back to the updater
+        struct Handoff
+        {
+            std::mutex mutex;
+            std::condition_variable signal;
+            const ZDDictionary* released = nullptr;
+        };
+
+        //! @brief the part of the delta file already applied
+        struct WatchedFile
+        {
+            dev_t device = 0;
+            ino_t inode = 0;
+            std::streamoff offset = 0;
+        };
+
+        //! @brief make a copy readable : the snapshots of it keep it alive, and the last one signals its release
+        std::shared_ptr<const ZDDictionary> publish(const std::shared_ptr<ZDDictionary>& dictionary) const
+        {
+            std::shared_ptr<Handoff> handoff = m_handoff;
+            return std::shared_ptr<const ZDDictionary>(dictionary.get(), [handoff, dictionary](const ZDDictionary* released)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(handoff->mutex);
+                    handoff->released = released;
+                }
+                handoff->signal.notify_all();
+            });
+        };
+
+        //! @brief change the standby copy, make it current, then make the same change to the old copy once nobody
+        //! reads it anymore
+        //! @param change called with the copy to change, and true for the first copy
+        template<class Change>
+        void update(Change change)
+        {
+            std::lock_guard<std::mutex> lock(m_update);
+
+            change(*m_standby, true);
+
+            //publish the updated copy, and take the old one once its last reader is gone
+            std::shared_ptr<ZDDictionary> old = (m_standby == m_copies[0]) ? m_copies[1] : m_copies[0];
+            {
+                std::lock_guard<std::mutex> handoffLock(m_handoff->mutex);
+                m_handoff->released = nullptr;
+            }
+            std::atomic_exchange(&m_current, publish(m_standby)).reset();
+            {
+                std::unique_lock<std::mutex> handoffLock(m_handoff->mutex);
+                m_handoff->signal.wait(handoffLock, [&]() { return m_handoff->released == old.get(); });
+            }
+            m_standby = old;
+
+            change(*m_standby, false);
+            ++m_version;
+        };
+
+        //! @brief apply the lines appended to a watched delta file since the last call, or the whole file if it
+        //! was replaced or truncated; a last line without its end is left for the next call, a malformed line is
+        //! counted (see rejected_lines) and skipped, so that it does not hold back the lines after it
+        void apply_appended(const std::string& deltaFile)
+        {
+            struct stat status;
+            std::ifstream file(deltaFile, std::ios::binary);
+            if (!file.is_open() || ::stat(deltaFile.c_str(), &status) != 0)
+            {
+                return;
+            }
+            if (status.st_dev != m_watched.device || status.st_ino != m_watched.inode || status.st_size < m_watched.offset)
+            {
+                m_watched = WatchedFile();
+                m_watched.device = status.st_dev;
+                m_watched.inode = status.st_ino;
+            }
+
+            file.seekg(m_watched.offset);
+            std::string appended((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            const std::size_t end = appended.find_last_of('\n');
+            if (end == std::string::npos)
+            {
+                return;
+            }
+            appended.resize(end + 1);
+
+            std::istringstream lines(appended);
+            ZDDelta delta;
+            std::string line;
+            while (std::getline(lines, line))
+            {
+                std::istringstream one(line);
+                if (!delta.read(one))
+                {
+                    ++m_rejected;
+                }
+            }
+            if (!delta.empty())
+            {
+                apply(delta);
+            }
+            m_watched.offset += static_cast<std::streamoff>(appended.size());
+        };
+
+        //! @brief copy a dictionary, through its binary format
+        static std::shared_ptr<ZDDictionary> copy(const ZDDictionary& dictionary)
+        {
+            std::stringstream buffer;
+            dictionary.save(buffer);
+            std::shared_ptr<ZDDictionary> result = std::make_shared<ZDDictionary>();
+            result->load(buffer);
+            return result;
+        };
+
+        //! @brief the release of the copies by their readers
+        std::shared_ptr<Handoff> m_handoff;
+
+        //! @brief the two copies, the copy being updated, only used under m_update, and the copy being read
+        std::shared_ptr<ZDDictionary> m_copies[2];
+        std::shared_ptr<ZDDictionary> m_standby;
+        std::shared_ptr<const ZDDictionary> m_current;
+
+        //! @brief serialize the updates
+        std::mutex m_update;
+
+        //! @brief the number of updates applied
+        std::atomic<uint64_t> m_version{ 0 };
+
+        //! @brief the number of malformed lines of the watched delta file
+        std::atomic<uint64_t> m_rejected{ 0 };
+
+        //! @brief the watcher of the delta file, and the part of it applied, only used by the watcher
+        ZDFileWatcher m_watcher;
+        WatchedFile m_watched;
+    };
+}
@@ -4,13 +4,27 @@
 #include <algorithm>
 #include <tuple>
 #include <locale>
-#include "Tree/ZDTree.h"
+#include <string>
+#include <utility>
+#include <fstream>
+#include <queue>
+#include <random>
+#include "ZDDictionaryTree.h"
+#include "Distance/ZDEditDistance.h"
+#include "Distance/ZDCostModel.h"
+#include "Pattern/ZDPattern.h"
+#include "Serialization/ZDBinaryIO.h"
 
 namespace Dico
 {
     //! @brief this class encapsulate the dictionary fonctions
     class ZDDictionary
     {
+        //! @brief writes the binary format of the dictionary from sorted words, without building the tree
+        friend class ZDSnapshotWriter;
+
+        //! @brief flattens the tree of the dictionary into the nodes of a ZDStaticDictionary
+        friend class ZDStaticDictionaryWriter;
 
     public:
         //! @brief default constructor
@@ -18,13 +32,14 @@ namespace Dico
         {
             //add all alphabetic entries as a root
 
-            ZDTree<char>::iterator head;
+            ZDDictionaryTree::iterator head;
             head = m_internalTree.begin();
 
             for (auto charr : FrenchAlphabet)
             {
                 m_internalTree.insert(head, charr);
             }
+            rebuild_jump_table();
         };
 
         //! @brief distructor
@@ -35,189 +50,1189 @@ namespace Dico
 
         //! @brief insert a new word to the dictionary
         //! @param word the given word to be inserted
-        //! @return return true if succes, false otherwise
-        bool insert_word(std::string word)
+        //! @return return true if succes, false otherwise
+        bool insert_word(std::string word)
+        {
+            return std::get<bool>(add_word(word));
+        };
+
+        //! @brief insert a new word to the dictionary with a weight, used to rank completions and suggestions;
+        //! if the word already exists its weight is replaced
+        //! @param word the given word to be inserted
+        //! @param weight the weight of the word (typicaly its frequency)
+        //! @return return true if succes, false otherwise
+        bool insert_word(std::string word, uint32_t weight)
+        {
+            auto added = add_word(word);
+            if (std::get<bool>(added))
+            {
+                std::get<ZDDictionaryTree::iterator>(added)->weight = weight;
+                update_max_weight(std::get<ZDDictionaryTree::iterator>(added));
+            }
+
+            return std::get<bool>(added);
+        };
+
+        //! @brief remove a word from the dictionary
+        //! @param word the word to be removed
+        //! @return true if succes , false otherwise
+        bool remove_word(std::string word)
+        {
+            bool result = false;
+
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            //find the root word
+            auto root = find_root(word);
+            if (std::get<bool>(root))
+            {
+                //find the word
+                auto found = find_word(m_internalTree, std::get<ZDDictionaryTree::iterator>(root), std::get<std::string>(root));
+                if (std::get<bool>(found) && std::get<ZDDictionaryTree::iterator>(found)->terminal)
+                {
+                    //the id of the word is given to the next word inserted
+                    release_id(std::get<ZDDictionaryTree::iterator>(found)->id);
+
+                    //remove the work
+                    result = remove_word(m_internalTree, std::get<ZDDictionaryTree::iterator>(found), std::get<ZDDictionaryTree::iterator>(root));
+                    update_jump_table(std::get<ZDDictionaryTree::iterator>(root).node, std::get<std::string>(root));
+                }
+            }
+
+            return  result;
+        }
+
+        //! @brief find if a word exist in the dictionary , this methode is using safe founding; this is leas that no errors are allowed
+        //! @param word th e word to be found
+        //! @return true if the word is found, false otherwise
+        bool find_word(std::string word) const
+        {
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            const TreeNode<ZDNodeData>* node = find_node(word);
+            return node != 0 && node->data.terminal;
+        }
+
+        //! @brief find if a word existe in the dictionary, this methode allow no safe founding, this is mean errors (addition, deletio, substitution) may be allowed
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors
+        //! @return true if the word is found, false otherwise
+        bool find_word(std::string word, int max_error) const
+        {
+            bool result = false;
+
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            //stop at the first word close enough
+            find_words(m_internalTree, word, max_error, [&result](const std::string&, int)
+            {
+                result = true;
+                return false;
+            });
+
+            return  result;
+        }
+
+        //! @brief find all the words of the dictionary close to a given word
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @return the found words with their number of errors, sorted by number of errors then alphabetically
+        std::vector<std::pair<std::string, int>> find_words(std::string word, int max_error) const
+        {
+            std::vector<std::pair<std::string, int>> result;
+
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            find_words(m_internalTree, word, max_error, [&result](const std::string& found, int errors)
+            {
+                result.emplace_back(found, errors);
+                return true;
+            });
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+
+            return result;
+        }
+
+        //! @brief find if a word exist in the dictionary, errors being counted with a weighted edit distance
+        //! @param word the word to be found
+        //! @param model the costs of the errors (see ZDCostModel)
+        //! @param budget the maximum total cost of the errors
+        //! @return true if a word is found, false otherwise
+        bool find_word(std::string word, const ZDCostModel& model, float budget) const
+        {
+            bool result = false;
+
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            //stop at the first word close enough
+            find_words(m_internalTree, word, model, budget, [&result](const std::string&, float)
+            {
+                result = true;
+                return false;
+            });
+
+            return result;
+        }
+
+        //! @brief find all the words of the dictionary close to a given word, errors being counted with a
+        //! weighted edit distance : with cheap likely typos (see ZDCostModel::french) a tight budget finds
+        //! the intended word while exploring far fewer subtrees than a count of errors would need
+        //! @param word the word to be found
+        //! @param model the costs of the errors (see ZDCostModel)
+        //! @param budget the maximum total cost of the errors
+        //! @return the found words with their cost, sorted by cost then alphabetically
+        std::vector<std::pair<std::string, float>> find_words(std::string word, const ZDCostModel& model, float budget) const
+        {
+            std::vector<std::pair<std::string, float>> result;
+
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            find_words(m_internalTree, word, model, budget, [&result](const std::string& found, float cost)
+            {
+                result.emplace_back(found, cost);
+                return true;
+            });
+
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, float>& a, const std::pair<std::string, float>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+
+            return result;
+        }
+
+        //! @brief find the words of the dictionary matching a wildcard pattern : '?' for any char, '*' for any
+        //! sequence of chars and '[ae]' for a class of chars (see ZDPattern). The literal chars of the pattern are
+        //! converted to lower case, the classes are matched as written against the lower case words. The
+        //! dictionary must not be modified while the matches are read.
+        //! @param pattern the given pattern
+        //! @return the matching words, produced one at a time; none if the pattern is malformed
+        ZDPatternMatches match(const std::string& pattern) const
+        {
+            return ZDPatternMatches(m_internalTree, ZDPattern(ZDPattern::lower_case_literals(pattern)));
+        }
+
+        //! @brief get the number of words of the dictionary
+        //! @return
+        std::size_t word_count() const
+        {
+            std::size_t result = 0;
+            for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet; root = root->next_sibling)
+            {
+                result += root->data.words;
+            }
+            return result;
+        }
+
+        //! @brief get the id of a word : each word gets an id when it is inserted, which it keeps until it is
+        //! removed, whatever is inserted or removed meanwhile, and which is kept by save and load. The id of a
+        //! removed word is given to the next word inserted, so the ids stay dense : they are all lower than
+        //! id_capacity(), which is the highest number of words the dictionary held. A dictionary read from a
+        //! file without ids (see ZDSnapshotWriter, or a file of an older version) numbers its words in
+        //! alphabetical order. The alphabetical position of a word is given by rank and select.
+        //! @param word the given word
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the word is found, false othserwise
+        //! - uint32_t              : if founded, the id of the word
+        std::tuple<bool, uint32_t> word_id(std::string word) const
+        {
+            const TreeNode<ZDNodeData>* node = find_node(to_lower_case_word(word));
+            if (node == 0 || !node->data.terminal)
+            {
+                return std::tuple<bool, uint32_t>(false, 0);
+            }
+            return std::tuple<bool, uint32_t>(true, node->data.id);
+        }
+
+        //! @brief get the word of a given id, the reverse of word_id
+        //! @param id the given id
+        //! @return the word, empty if no word has this id
+        std::string word_from_id(uint32_t id) const
+        {
+            return (id < m_idNodes.size() && m_idNodes[id] != 0) ? word_of(m_idNodes[id]) : std::string();
+        }
+
+        //! @brief get the bound of the word ids : every id is lower than it (see word_id), typicaly the size of
+        //! a column of values per word (see ZDPayloadColumn)
+        //! @return
+        std::size_t id_capacity() const
+        {
+            return m_idNodes.size();
+        }
+
+        //! @brief call a function with each word of the dictionary, in alphabetical order, in one walk of the tree
+        //! @param visitor the function, called with the word (std::string), its id and its weight (uint32_t)
+        template<class Visitor>
+        void for_each_word(Visitor visitor) const
+        {
+            std::string word;
+            for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet; root = root->next_sibling)
+            {
+                visit_words(root, word, visitor);
+            }
+        }
+
+        //! @brief count the words starting with a given prefix, from the word counts of the nodes of its path
+        //! @param prefix the given prefix, empty for the whole dictionary
+        //! @return the number of words
+        std::size_t count_prefix(std::string prefix) const
+        {
+            prefix = to_lower_case_word(prefix);
+            if (prefix.empty())
+            {
+                return word_count();
+            }
+            const TreeNode<ZDNodeData>* node = find_node(prefix);
+            return (node != 0) ? node->data.words : 0;
+        }
+
+        //! @brief get the number of words coming before a given word alphabetically (the order of word_id). The
+        //! word needs not be in the dictionary : this is where it would be inserted. Like the inserted words, the
+        //! leading chars of the word which are not a root are skipped.
+        //! @param word the given word
+        //! @return the number of words before it
+        std::size_t rank(std::string word) const
+        {
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            auto root = find_root(word);
+            if (!std::get<bool>(root))
+            {
+                return 0;
+            }
+
+            std::size_t result = 0;
+            const TreeNode<ZDNodeData>* node = std::get<ZDDictionaryTree::iterator>(root).node;
+            for (auto previous = node->prev_sibling; previous != m_internalTree.head; previous = previous->prev_sibling)
+            {
+                result += previous->data.words;
+            }
+
+            for (auto charr : std::get<std::string>(root))
+            {
+                //the word of the node is a prefix of the word, the previous children hold lower words
+                result += node->data.terminal ? 1 : 0;
+
+                const TreeNode<ZDNodeData>* child = node->first_child;
+                while (child != 0 && static_cast<unsigned char>(child->data.letter) < static_cast<unsigned char>(charr))
+                {
+                    result += child->data.words;
+                    child = child->next_sibling;
+                }
+                if (child == 0 || child->data.letter != charr)
+                {
+                    return result;
+                }
+                node = child;
+            }
+
+            return result;
+        }
+
+        //! @brief get the word of a given rank among the words starting with a given prefix, alphabetically :
+        //! the subtrees holding only lower ranks are skipped from their word counts. With an empty prefix, this
+        //! is the reverse of rank for the words of the dictionary.
+        //! @param index the rank of the word among the words of the prefix
+        //! @param prefix the given prefix, empty for the whole dictionary
+        //! @return the word, empty if the index is not lower than count_prefix(prefix)
+        std::string select(std::size_t index, std::string prefix = std::string()) const
+        {
+            std::string result;
+
+            //convert the input word to lower case
+            prefix = to_lower_case_word(prefix);
+
+            const TreeNode<ZDNodeData>* node = 0;
+            if (prefix.empty())
+            {
+                node = m_internalTree.head->next_sibling;
+                while (node != m_internalTree.feet && index >= node->data.words)
+                {
+                    index -= node->data.words;
+                    node = node->next_sibling;
+                }
+                if (node == m_internalTree.feet)
+                {
+                    return result;
+                }
+            }
+            else
+            {
+                node = find_node(prefix);
+                if (node == 0 || index >= node->data.words)
+                {
+                    return result;
+                }
+                result = word_of(node->parent);
+            }
+
+            while (node != 0)
+            {
+                result.push_back(node->data.letter);
+                if (node->data.terminal)
+                {
+                    if (index == 0)
+                    {
+                        break;
+                    }
+                    --index;
+                }
+
+                //skip the children whose words all come before the index
+                node = node->first_child;
+                while (node != 0 && index >= node->data.words)
+                {
+                    index -= node->data.words;
+                    node = node->next_sibling;
+                }
+            }
+
+            return result;
+        }
+
+        //! @brief draw a word uniformly among the words starting with a given prefix
+        //! @param prefix the given prefix, empty for the whole dictionary
+        //! @param generator the random generator (typicaly std::mt19937)
+        //! @return the word, empty if no word starts with the prefix
+        template<class Generator>
+        std::string sample(const std::string& prefix, Generator& generator) const
+        {
+            const std::size_t count = count_prefix(prefix);
+            if (count == 0)
+            {
+                return std::string();
+            }
+            std::uniform_int_distribution<std::size_t> distribution(0, count - 1);
+            return select(distribution(generator), prefix);
+        }
+
+        //! @brief get the weight of a word
+        //! @param word the given word
+        //! @return a tuple with the following value :
+        //! - bool                  : true if the word is found, false othserwise
+        //! - uint32_t              : if founded, the weight of the word
+        std::tuple<bool, uint32_t> word_weight(std::string word) const
+        {
+            const TreeNode<ZDNodeData>* node = find_node(to_lower_case_word(word));
+            if (node == 0 || !node->data.terminal)
+            {
+                return std::tuple<bool, uint32_t>(false, 0);
+            }
+            return std::tuple<bool, uint32_t>(true, node->data.weight);
+        }
+
+        //! @brief find the words of highest weight starting with a given prefix. The tree is walked best first :
+        //! each subtree is ranked by the highest weight it holds, so only the subtrees able to beat the current
+        //! k-th word are opened, whatever the number of words under the prefix.
+        //! @param prefix the given prefix, empty for the whole dictionary
+        //! @param count the maximum number of words
+        //! @return the words with their weight, by decreasing weight
+        std::vector<std::pair<std::string, uint32_t>> complete(std::string prefix, std::size_t count) const
+        {
+            std::vector<std::pair<std::string, uint32_t>> result;
+
+            //convert the input word to lower case
+            prefix = to_lower_case_word(prefix);
+
+            //an entry is either a subtree ranked by its highest weight, or a word ranked by its weight
+            struct Entry
+            {
+                uint32_t weight;
+                const TreeNode<ZDNodeData>* node;
+                bool word;
+
+                bool operator<(const Entry& other) const
+                {
+                    //on equal weights, words come out before subtrees are opened
+                    return weight < other.weight || (weight == other.weight && !word && other.word);
+                }
+            };
+
+            std::priority_queue<Entry> queue;
+            if (prefix.empty())
+            {
+                for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet; root = root->next_sibling)
+                {
+                    queue.push(Entry{ root->data.max_weight, root, false });
+                }
+            }
+            else if (const TreeNode<ZDNodeData>* node = find_node(prefix))
+            {
+                queue.push(Entry{ node->data.max_weight, node, false });
+            }
+
+            while (!queue.empty() && result.size() < count)
+            {
+                const Entry entry = queue.top();
+                queue.pop();
+
+                if (entry.word)
+                {
+                    result.emplace_back(word_of(entry.node), entry.weight);
+                    continue;
+                }
+
+                if (entry.node->data.terminal)
+                {
+                    queue.push(Entry{ entry.node->data.weight, entry.node, true });
+                }
+                for (auto child = entry.node->first_child; child != 0; child = child->next_sibling)
+                {
+                    if (child->data.words != 0)
+                    {
+                        queue.push(Entry{ child->data.max_weight, child, false });
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        //! @brief find the words of highest weight close to a given word. The tree is walked best first, like
+        //! complete, each subtree carrying the bit-vector DP row of its path like find_words, and the subtrees
+        //! too far from the word are skipped.
+        //! @param word the word to be found
+        //! @param max_error the maximum number of errors (addition, deletion, substitution)
+        //! @param count the maximum number of words
+        //! @return a vector of tuple with the following value, by decreasing weight :
+        //! - std::string           : the found word
+        //! - int                   : its number of errors
+        //! - uint32_t              : its weight
+        std::vector<std::tuple<std::string, int, uint32_t>> suggest(std::string word, int max_error, std::size_t count) const
+        {
+            std::vector<std::tuple<std::string, int, uint32_t>> result;
+
+            //convert the input word to lower case
+            word = to_lower_case_word(word);
+
+            if (max_error < 0)
+            {
+                return result;
+            }
+
+            //too long for the bit-vector row : rank all the close words
+            if (word.size() > ZDMyersPattern::max_size)
+            {
+                find_words(m_internalTree, word, max_error, [&](const std::string& found, int errors)
+                {
+                    result.emplace_back(found, errors, find_node(found)->data.weight);
+                    return true;
+                });
+
+                std::stable_sort(result.begin(), result.end(), [](const std::tuple<std::string, int, uint32_t>& a, const std::tuple<std::string, int, uint32_t>& b)
+                {
+                    return std::get<2>(a) > std::get<2>(b);
+                });
+                if (result.size() > count)
+                {
+                    result.resize(count);
+                }
+                return result;
+            }
+
+            struct Entry
+            {
+                uint32_t weight;
+                const TreeNode<ZDNodeData>* node;
+                ZDMyersRow row;
+                bool word;
+
+                bool operator<(const Entry& other) const
+                {
+                    return weight < other.weight || (weight == other.weight && !word && other.word);
+                }
+            };
+
+            const ZDMyersPattern pattern(word);
+            std::priority_queue<Entry> queue;
+
+            auto push_node = [&](const TreeNode<ZDNodeData>* node, const ZDMyersRow& parentRow)
+            {
+                const ZDMyersRow row = pattern.advance(parentRow, node->data.letter);
+                if (node->data.words != 0 && pattern.minimum(row, max_error) <= max_error)
+                {
+                    queue.push(Entry{ node->data.max_weight, node, row, false });
+                }
+            };
+
+            for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet; root = root->next_sibling)
+            {
+                push_node(root, pattern.first_row());
+            }
+
+            while (!queue.empty() && result.size() < count)
+            {
+                const Entry entry = queue.top();
+                queue.pop();
+
+                if (entry.word)
+                {
+                    result.emplace_back(word_of(entry.node), entry.row.score, entry.weight);
+                    continue;
+                }
+
+                if (entry.node->data.terminal && entry.row.score <= max_error)
+                {
+                    queue.push(Entry{ entry.node->data.weight, entry.node, entry.row, true });
+                }
+                for (auto child = entry.node->first_child; child != 0; child = child->next_sibling)
+                {
+                    push_node(child, entry.row);
+                }
+            }
+
+            return result;
+        }
+
+        //! @brief write the dictionary to a binary stream. The tree is written depth first, each node as its
+        //! char, its flags, and the weight and the id of its word if any, followed by its children, followed
+        //! by a null char closing it.
+        //! @param out the given stream
+        //! @return true if succes, false otherwise
+        bool save(std::ostream& out) const
+        {
+            write_header(out, file_magic, file_version);
+
+            for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet; root = root->next_sibling)
+            {
+                const TreeNode<ZDNodeData>* node = root;
+                write_node(out, node->data);
+
+                while (node != 0)
+                {
+                    if (node->first_child != 0)
+                    {
+                        node = node->first_child;
+                        write_node(out, node->data);
+                        continue;
+                    }
+
+                    //close the node, and its parents up to the first one having a next child
+                    while (node != 0)
+                    {
+                        out.put(0);
+                        if (node == root)
+                        {
+                            node = 0;
+                        }
+                        else if (node->next_sibling != 0)
+                        {
+                            node = node->next_sibling;
+                            write_node(out, node->data);
+                            break;
+                        }
+                        else
+                        {
+                            node = node->parent;
+                        }
+                    }
+                }
+            }
+            out.put(0);
+
+            return static_cast<bool>(out);
+        }
+
+        //! @brief read the dictionary from a binary stream written by save, the current words are replaced
+        //! @param in the given stream
+        //! @return true if succes, false otherwise
+        bool load(std::istream& in)
+        {
+            m_internalTree.clear();
+
+            uint32_t version = 0;
+            bool result = read_header(in, file_magic, version, file_version);
+
+            std::vector<ZDDictionaryTree::iterator> path;
+            while (result)
+            {
+                const int letter = in.get();
+                if (letter == std::char_traits<char>::eof())
+                {
+                    result = false;
+                }
+                else if (letter == 0)
+                {
+                    //end of the roots
+                    if (path.empty())
+                    {
+                        break;
+                    }
+                    //the subtree of the node is complete, count its words in its parent
+                    const ZDNodeData closed = *path.back();
+                    path.pop_back();
+                    if (!path.empty())
+                    {
+                        path.back()->words += closed.words;
+                        path.back()->max_weight = std::max(path.back()->max_weight, closed.max_weight);
+                    }
+                }
+                else
+                {
+                    const int flags = in.get();
+                    ZDNodeData data(static_cast<char>(letter));
+                    data.terminal = (flags & terminal_flag) != 0;
+                    data.words = data.terminal ? 1 : 0;
+                    if (flags & weight_flag)
+                    {
+                        read_pod(in, data.weight);
+                    }
+                    data.id = no_id;
+                    if (flags & id_flag)
+                    {
+                        read_pod(in, data.id);
+                    }
+                    data.max_weight = data.terminal ? data.weight : 0;
+
+                    if (path.empty())
+                    {
+                        path.push_back(m_internalTree.insert(m_internalTree.end(), std::move(data)));
+                    }
+                    else
+                    {
+                        path.push_back(m_internalTree.append_child(path.back(), std::move(data)));
+                    }
+                    result = static_cast<bool>(in);
+                }
+            }
+
+            if (result && m_internalTree.get_allocator().memory()->options().enabled())
+            {
+                m_internalTree.relayout();
+            }
+            //the words of a file without ids are numbered in alphabetical order; an id given twice is corrupt
+            result = result && rebuild_ids(0);
+            if (!result)
+            {
+                clear();
+            }
+            rebuild_jump_table();
+            return result;
+        }
+
+        //! @brief write the dictionary to a given path file
+        //! @param outputFile the given path file
+        //! @return true if succes, false otherwise
+        bool save(const std::string& outputFile) const
+        {
+            std::ofstream file(outputFile, std::ios::binary);
+            return file.is_open() && save(file);
+        }
+
+        //! @brief read the dictionary from a given path file, the current words are replaced
+        //! @param inputFile the given path file
+        //! @return true if succes, false otherwise
+        bool load(const std::string& inputFile)
+        {
+            std::ifstream file(inputFile, std::ios::binary);
+            return file.is_open() && load(file);
+        }
+
+        //! @brief remove all the words of the dictionary
+        void clear()
+        {
+            m_internalTree.clear();
+
+            ZDDictionaryTree::iterator head;
+            head = m_internalTree.begin();
+
+            for (auto charr : FrenchAlphabet)
+            {
+                m_internalTree.insert(head, charr);
+            }
+            m_idNodes.clear();
+            m_freeIds.clear();
+            rebuild_jump_table();
+        }
+
+        //! @brief move the nodes of the dictionary next to each other, so that a lookup reads a few close cache
+        //! lines instead of nodes scattered by a long run of insertions and removals (see ZDTree::relayout).
+        //! Nothing may read the dictionary meanwhile; ZDLiveDictionary::optimize does it without blocking readers.
+        void optimize()
+        {
+            m_internalTree.relayout();
+            rebuild_ids(m_idNodes.size());
+            rebuild_jump_table();
+        }
+
+        //! @brief replace the words of the dictionary by the words of two dictionaries. Both trees are walked
+        //! together, their sorted children being merged like sorted lists, and a subtree found in one dictionary
+        //! only is copied whole, so the cost follows the size of the result rather than the number of words
+        //! inserted one by one.
+        //! @param first the first dictionary, typicaly the base lexico
+        //! @param second the second dictionary, typicaly additions; its weight is kept for a word of both
+        //! @return true if succes, false if this dictionary is one of the given ones
+        bool merge(const ZDDictionary& first, const ZDDictionary& second)
+        {
+            return combine(first, second, SetOperation::merge);
+        }
+
+        //! @brief replace the words of the dictionary by the words found in two dictionaries (see merge); only
+        //! the subtrees found in both dictionaries are walked
+        //! @param first the first dictionary, its weights are kept
+        //! @param second the second dictionary
+        //! @return true if succes, false if this dictionary is one of the given ones
+        bool intersect(const ZDDictionary& first, const ZDDictionary& second)
+        {
+            return combine(first, second, SetOperation::intersect);
+        }
+
+        //! @brief replace the words of the dictionary by the words of a dictionary not found in another one (see
+        //! merge); only the subtrees of the first dictionary are walked
+        //! @param first the first dictionary, typicaly the base lexico; its weights are kept
+        //! @param second the words to leave out, typicaly a block list
+        //! @return true if succes, false if this dictionary is one of the given ones
+        bool subtract(const ZDDictionary& first, const ZDDictionary& second)
+        {
+            return combine(first, second, SetOperation::subtract);
+        }
+
+        //! @brief turn on or off the jump table : an array of the nodes of the first two levels, indexed by their
+        //! chars, so that a lookup reaches the second level in one load instead of scanning the roots and their
+        //! children. It is on by default and costs 2 KB per root.
+        //! @param enabled true to use the jump table, false to scan the first two levels
+        void set_jump_table(bool enabled)
+        {
+            m_jumpEnabled = enabled;
+            rebuild_jump_table();
+        }
+
+        //! @brief set where the nodes of the dictionary live : huge pages, a NUMA node, faulted in and locked in
+        //! memory. The nodes are moved at once into one block placed so (see optimize), and again after each load;
+        //! the nodes inserted later come from the heap until the next optimize.
+        //! @param options the given options, the defaut ones to go back to the heap
+        //! @return true if every option asked for was applied, false if some fell back (see placement)
+        bool set_placement(const ZDPlacementOptions& options)
+        {
+            m_internalTree.get_allocator().memory()->set_options(options);
+            optimize();
+            return placement_applied();
+        }
+
+        //! @brief get what was applied to the block of nodes of the dictionary (see set_placement)
+        //! @return
+        ZDPlacementReport placement() const
+        {
+            return m_internalTree.get_allocator().memory()->report();
+        }
+
+        //! @brief check if the options of the placement were all applied to the block of nodes (see set_placement)
+        //! @return false if some option fell back, or if the dictionary is too small to be placed
+        bool placement_applied() const
+        {
+            const ZDPlacementOptions& options = m_internalTree.get_allocator().memory()->options();
+            const ZDPlacementReport report = m_internalTree.get_allocator().memory()->report();
+            return !options.enabled() || (report.mapped && (options.huge_pages == ZDHugePages::None || report.huge_pages)
+                && (options.numa_node < 0 || report.numa) && (!options.prefault || report.prefaulted) && (!options.lock || report.locked));
+        }
+
+    private:
+
+        //! @brief the set operations between two dictionaries
+        enum class SetOperation
+        {
+            merge,
+            intersect,
+            subtract
+        };
+
+        //! @brief replace the words of the dictionary by the result of a set operation, walking both trees
+        //! together from their roots; the roots of both dictionaries are kept, even without words
+        bool combine(const ZDDictionary& first, const ZDDictionary& second, SetOperation operation)
+        {
+            if (this == &first || this == &second)
+            {
+                return false;
+            }
+            m_internalTree.clear();
+
+            const TreeNode<ZDNodeData>* left = first.m_internalTree.head->next_sibling;
+            const TreeNode<ZDNodeData>* right = second.m_internalTree.head->next_sibling;
+            while (left != first.m_internalTree.feet || right != second.m_internalTree.feet)
+            {
+                const TreeNode<ZDNodeData>* leftRoot = left;
+                const TreeNode<ZDNodeData>* rightRoot = right;
+                order(leftRoot, rightRoot, first.m_internalTree.feet, second.m_internalTree.feet);
+
+                const char letter = (leftRoot != 0) ? leftRoot->data.letter : rightRoot->data.letter;
+                combine_node(m_internalTree.insert(m_internalTree.end(), ZDNodeData(letter)), leftRoot, rightRoot, operation);
+
+                left = (leftRoot != 0) ? left->next_sibling : left;
+                right = (rightRoot != 0) ? right->next_sibling : right;
+            }
+
+            //the words of the first dictionary keep their ids, the other ones get free ids
+            rebuild_ids(first.m_idNodes.size());
+            rebuild_jump_table();
+            return true;
+        }
+
+        //! @brief keep the one of two sibling nodes of lower letter, or both if their letters are equal
+        //! @param left the node of the first list, set to null if its letter is higher
+        //! @param right the node of the second list, set to null if its letter is higher
+        //! @param leftEnd the end of the first list
+        //! @param rightEnd the end of the second list
+        static inline void order(const TreeNode<ZDNodeData>*& left, const TreeNode<ZDNodeData>*& right,
+            const TreeNode<ZDNodeData>* leftEnd, const TreeNode<ZDNodeData>* rightEnd)
+        {
+            if (left == leftEnd)
+            {
+                left = 0;
+            }
+            else if (right == rightEnd)
+            {
+                right = 0;
+            }
+            else if (static_cast<unsigned char>(left->data.letter) < static_cast<unsigned char>(right->data.letter))
+            {
+                right = 0;
+            }
+            else if (static_cast<unsigned char>(right->data.letter) < static_cast<unsigned char>(left->data.letter))
+            {
+                left = 0;
+            }
+        };
+
+        //! @brief fill a node of the result of a set operation from the nodes of the same path in both dictionaries
+        //! @param node the node of the result, holding its letter only
+        //! @param left the node of the first dictionary, null if none
+        //! @param right the node of the second dictionary, null if none
+        //! @param operation the set operation
+        void combine_node(const ZDDictionaryTree::iterator& node, const TreeNode<ZDNodeData>* left, const TreeNode<ZDNodeData>* right, SetOperation operation)
+        {
+            //a subtree of one dictionary only is part of the result whole, or not at all
+            if (right == 0 && operation != SetOperation::intersect)
+            {
+                copy_subtree(node, left, true);
+                return;
+            }
+            if (left == 0)
+            {
+                if (operation == SetOperation::merge)
+                {
+                    copy_subtree(node, right, false);
+                }
+                return;
+            }
+
+            switch (operation)
+            {
+            case SetOperation::merge:
+                node->terminal = left->data.terminal || right->data.terminal;
+                node->weight = right->data.terminal ? right->data.weight : left->data.weight;
+                break;
+            case SetOperation::intersect:
+                node->terminal = left->data.terminal && right->data.terminal;
+                node->weight = node->terminal ? left->data.weight : 0;
+                break;
+            case SetOperation::subtract:
+                node->terminal = left->data.terminal && !right->data.terminal;
+                node->weight = node->terminal ? left->data.weight : 0;
+                break;
+            }
+            node->words = node->terminal ? 1 : 0;
+            node->max_weight = node->terminal ? node->weight : 0;
+            node->id = left->data.terminal ? left->data.id : no_id;
+
+            const TreeNode<ZDNodeData>* leftChild = left->first_child;
+            const TreeNode<ZDNodeData>* rightChild = right->first_child;
+            while (leftChild != 0 || rightChild != 0)
+            {
+                const TreeNode<ZDNodeData>* leftNext = leftChild;
+                const TreeNode<ZDNodeData>* rightNext = rightChild;
+                order(leftNext, rightNext, 0, 0);
+
+                //only the paths which may hold words of the result are followed
+                if (operation == SetOperation::merge || (leftNext != 0 && (rightNext != 0 || operation == SetOperation::subtract)))
+                {
+                    const char letter = (leftNext != 0) ? leftNext->data.letter : rightNext->data.letter;
+                    ZDDictionaryTree::iterator child = m_internalTree.append_child(node, ZDNodeData(letter));
+                    combine_node(child, leftNext, rightNext, operation);
+                    if (child->words == 0)
+                    {
+                        m_internalTree.erase(child);
+                    }
+                    else
+                    {
+                        node->words += child->words;
+                        node->max_weight = std::max(node->max_weight, child->max_weight);
+                    }
+                }
+
+                leftChild = (leftNext != 0) ? leftChild->next_sibling : leftChild;
+                rightChild = (rightNext != 0) ? rightChild->next_sibling : rightChild;
+            }
+        }
+
+        //! @brief copy the subtree of a node of another dictionary below a node holding the same letter
+        //! @param node the node of this dictionary
+        //! @param source the node of the other dictionary
+        //! @param keepIds true to keep the ids of the words, false to give them new ids (see rebuild_ids)
+        void copy_subtree(const ZDDictionaryTree::iterator& node, const TreeNode<ZDNodeData>* source, bool keepIds)
+        {
+            *node = source->data;
+            node->id = keepIds ? node->id : no_id;
+            for (auto child = source->first_child; child != 0; child = child->next_sibling)
+            {
+                copy_subtree(m_internalTree.append_child(node, ZDNodeData(child->data.letter)), child, keepIds);
+            }
+        }
+
+        //! @brief give an id to a new word : the last id freed, or a new one
+        //! @param node the node where the word finish
+        //! @return the id
+        uint32_t acquire_id(const TreeNode<ZDNodeData>* node)
+        {
+            if (m_freeIds.empty())
+            {
+                m_idNodes.push_back(node);
+                return static_cast<uint32_t>(m_idNodes.size() - 1);
+            }
+            const uint32_t id = m_freeIds.back();
+            m_freeIds.pop_back();
+            m_idNodes[id] = node;
+            return id;
+        }
+
+        //! @brief free the id of a word removed
+        //! @param id the given id
+        void release_id(uint32_t id)
+        {
+            m_idNodes[id] = 0;
+            m_freeIds.push_back(id);
+        }
+
+        //! @brief find again the node of each id after the nodes moved (relayout) or were built (load, set
+        //! operations), and give the words having no id (no_id) the free ids, lowest first, then new ones
+        //! @param capacity the lowest bound of the ids
+        //! @return false if an id is given to two words
+        bool rebuild_ids(std::size_t capacity)
+        {
+            m_idNodes.assign(capacity, 0);
+            m_freeIds.clear();
+
+            std::vector<TreeNode<ZDNodeData>*> pending;
+            bool result = true;
+            for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet; root = root->next_sibling)
+            {
+                for_each_node(root, [&](TreeNode<ZDNodeData>* node)
+                {
+                    if (!node->data.terminal)
+                    {
+                        return;
+                    }
+                    if (node->data.id == no_id)
+                    {
+                        pending.push_back(node);
+                        return;
+                    }
+                    if (node->data.id >= m_idNodes.size())
+                    {
+                        m_idNodes.resize(static_cast<std::size_t>(node->data.id) + 1, 0);
+                    }
+                    result = result && m_idNodes[node->data.id] == 0;
+                    m_idNodes[node->data.id] = node;
+                });
+            }
+
+            //the free ids, the lowest one last so it is given first
+            for (std::size_t id = m_idNodes.size(); id-- > 0;)
+            {
+                if (m_idNodes[id] == 0)
+                {
+                    m_freeIds.push_back(static_cast<uint32_t>(id));
+                }
+            }
+            for (auto node : pending)
+            {
+                node->data.id = acquire_id(node);
+            }
+            return result;
+        }
+
+        //! @brief call a function with each node of the subtree of a node, depth first
+        template<class Function>
+        static void for_each_node(TreeNode<ZDNodeData>* node, const Function& function)
+        {
+            function(node);
+            for (auto child = node->first_child; child != 0; child = child->next_sibling)
+            {
+                for_each_node(child, function);
+            }
+        }
+
+        //! @brief call a function with each word of the subtree of a node (see for_each_word)
+        template<class Visitor>
+        static void visit_words(const TreeNode<ZDNodeData>* node, std::string& word, Visitor& visitor)
+        {
+            word.push_back(node->data.letter);
+            if (node->data.terminal)
+            {
+                visitor(static_cast<const std::string&>(word), node->data.id, node->data.weight);
+            }
+            for (auto child = node->first_child; child != 0; child = child->next_sibling)
+            {
+                visit_words(child, word, visitor);
+            }
+            word.pop_back();
+        }
+
+        //! @brief insert a new word to the dictionary
+        //! @param word the given word to be inserted
+        //! @return a tuple with the following value :
+        //! - bool                  : true if succes, false otherwise
+        //! - ZDDictionaryTree::iterator  : if succes, the node where the inserted word finish
+        std::tuple<bool, ZDDictionaryTree::iterator> add_word(std::string word)
         {
-            bool result = false;
+            std::tuple<bool, ZDDictionaryTree::iterator> result(false, nullptr);
 
             //convert the input word to lower case
             word = to_lower_case_word(word);
 
-            int count = 1;
-
-            //find the root word 
-            for (auto charr : word)
+            //find the root word
+            auto root = find_root(word);
+            if (std::get<bool>(root))
             {
-                ZDTree<char>::sibling_iterator sib = m_internalTree.begin();
-
-                while (sib != m_internalTree.end())
-                {
-                    if ((*sib) == charr)
-                    {
-                        //insert the current word
-                        insert_word(m_internalTree, ZDTree<char>::iterator(sib.node), word.erase(0, count));
-                        result = true;
-                        break;
-                    }
-                    ++sib;
-                }
-
-                if (result)
-                {
-                    break;
-                }
-                else
+                //insert the current word, and mark its last char as the end of a word
+                ZDDictionaryTree::iterator last = insert_word(m_internalTree, std::get<ZDDictionaryTree::iterator>(root), std::get<std::string>(root));
+                if (!last->terminal)
                 {
-                    ++count;
+                    last->terminal = true;
+                    last->id = acquire_id(last.node);
+                    add_words(last, 1);
                 }
-
+                update_jump_table(std::get<ZDDictionaryTree::iterator>(root).node, std::get<std::string>(root));
+                result = std::tuple<bool, ZDDictionaryTree::iterator>(true, last);
             }
 
             return result;
         };
 
-        //! @brief remove a word from the dictionary
-        //! @param word the word to be removed
-        //! @return true if succes , false otherwise
-        bool remove_word(std::string word)
+        //! @brief find the node where a word finish, the word being already in lower case
+        //! @param word the given word
+        //! @return the node, null if the word is not a path of the dictionary
+        const TreeNode<ZDNodeData>* find_node(const std::string& word) const
         {
-            bool result = false;
-
-            //convert the input word to lower case
-            word = to_lower_case_word(word);
-
-            int count = 1;
-
-            //find the root word 
-            for (auto charr : word)
+            const TreeNode<ZDNodeData>* node = 0;
+            std::size_t position = 0;
+            if (!m_roots.empty())
             {
-                ZDTree<char>::sibling_iterator sib = m_internalTree.begin();
-                while (sib != m_internalTree.end())
+                //the first two levels are read from the jump table
+                while (position < word.size() && m_rootSlots[static_cast<unsigned char>(word[position])] == no_slot)
                 {
-                    if ((*sib) == charr)
-                    {
-                        //find the word
-                        auto found = find_word(m_internalTree, ZDTree<char>::iterator(sib.node), word.erase(0, count));
-                        if (std::get<bool>(found))
-                        {
-                            //remove the work
-                            result = remove_word(m_internalTree, std::get<ZDTree<char>::iterator>(found), ZDTree<char>::iterator(sib.node));
-                        }
-                    }
-                    ++sib;
+                    ++position;
                 }
-
-                if (result)
+                if (position == word.size())
                 {
-                    break;
+                    return 0;
                 }
-                else
+                const std::size_t slot = m_rootSlots[static_cast<unsigned char>(word[position++])];
+                node = m_roots[slot];
+                if (position < word.size())
                 {
-                    ++count;
+                    node = m_jump[slot * jump_width + static_cast<unsigned char>(word[position++])];
+                    if (node == 0)
+                    {
+                        return 0;
+                    }
                 }
             }
-
-            return  result;
-        }
-
-        //! @brief find if a word exist in the dictionary , this methode is using safe founding; this is leas that no errors are allowed
-        //! @param word th e word to be found
-        //! @return true if the word is found, false otherwise
-        bool find_word(std::string word)
-        {
-            bool result = false;
-
-            //convert the input word to lower case
-            word = to_lower_case_word(word);
-
-            int count = 1;
-
-            //find the root word 
-            for (auto charr : word)
+            else
             {
-                ZDTree<char>::sibling_iterator sib = m_internalTree.begin();
-                while (sib != m_internalTree.end())
+                auto root = find_root(word);
+                if (!std::get<bool>(root))
                 {
-                    if ((*sib) == charr)
-                    {
-                        result = std::get<bool>(find_word(m_internalTree, ZDTree<char>::iterator(sib.node), word.erase(0, count)));
-                        if (result)
-                        {
-                            break;
-                        }
-                    }
-                    ++sib;
+                    return 0;
                 }
+                node = std::get<ZDDictionaryTree::iterator>(root).node;
+                position = word.size() - std::get<std::string>(root).size();
+            }
 
-                if (result)
+            for (; position < word.size(); ++position)
+            {
+                node = node->first_child;
+                while (node != 0 && node->data.letter != word[position])
                 {
-                    break;
+                    node = node->next_sibling;
                 }
-                else
+                if (node == 0)
                 {
-                    ++count;
+                    return 0;
                 }
             }
+            return node;
+        };
 
-            return  result;
-        }
-
-        //! @brief find if a word existe in the dictionary, this methode allow no safe founding, this is mean errors (addition, deletio, substitution) may be allowed
-        //! @param word the word to be found
-        //! @param max_error the maximum number of errors
-        //! @return true if the word is found, false otherwise
-        bool find_word(std::string word, int max_error)
+        //! @brief get the word ending on a given node
+        //! @param node the given node
+        //! @return the chars from the root to the node
+        static inline std::string word_of(const TreeNode<ZDNodeData>* node)
         {
-            bool result = false;
-            int count_error = 0;
-            //convert the input word to lower case
-            word = to_lower_case_word(word);
-
-            int count = 1;
+            std::string result;
+            for (; node != 0; node = node->parent)
+            {
+                result.push_back(node->data.letter);
+            }
+            std::reverse(result.begin(), result.end());
+            return result;
+        };
 
-            //find the root word 
-            for (auto charr : word)
+        //! @brief find the root node of a word, the leading chars of the word which are not a root are skipped
+        //! @param word the given word
+        //! @return a tuple with the following value :
+        //! - bool                  : true if a root is found, false othserwise
+        //! - ZDDictionaryTree::iterator  : if founded, the root node
+        //! - std::string           : the rest of the word, after the root char
+        std::tuple<bool, ZDDictionaryTree::iterator, std::string> find_root(const std::string& word) const
+        {
+            if (!m_roots.empty())
             {
-                ZDTree<char>::sibling_iterator sib = m_internalTree.begin();
-                while (sib != m_internalTree.end() && count_error < max_error)
+                for (std::size_t count = 0; count < word.size(); ++count)
                 {
-                    if ((*sib) == charr)
+                    const uint8_t slot = m_rootSlots[static_cast<unsigned char>(word[count])];
+                    if (slot != no_slot)
                     {
-                        result = std::get<bool>(find_word(m_internalTree, ZDTree<char>::iterator(sib.node), word.erase(0, count), max_error - count_error));
-                        if (result)
-                        {
-                            break;
-                        }
+                        return std::tuple<bool, ZDDictionaryTree::iterator, std::string>(true, ZDDictionaryTree::iterator(m_roots[slot]), word.substr(count + 1));
                     }
-                    ++sib;
                 }
+                return std::tuple<bool, ZDDictionaryTree::iterator, std::string>(false, nullptr, std::string());
+            }
 
-                if (result)
-                {
-                    break;
-                }
-                else
+            for (std::size_t count = 0; count < word.size(); ++count)
+            {
+                ZDDictionaryTree::sibling_iterator sib = m_internalTree.begin();
+                while (sib != m_internalTree.end())
                 {
-                    ++count;
-                    ++count_error;
+                    if ((*sib) == word[count])
+                    {
+                        return std::tuple<bool, ZDDictionaryTree::iterator, std::string>(true, sib, word.substr(count + 1));
+                    }
+                    ++sib;
                 }
             }
 
-            return  result;
+            return std::tuple<bool, ZDDictionaryTree::iterator, std::string>(false, nullptr, std::string());
         }
 
-
-
-    private:
-
         //! @brief insert a new work to a given dictionary starting at a given root
         //! @param tr the given dictionary
         //! @param node the starting root
         //! @param word th e word to be insert
         //! @return the last node where the inserted word finish
-        static inline ZDTree<char>::iterator insert_word(ZDTree<char>& tr, ZDTree<char>::iterator& node, const std::string& word)
+        static inline ZDDictionaryTree::iterator insert_word(ZDDictionaryTree& tr, const ZDDictionaryTree::iterator& node, const std::string& word)
         {
-            ZDTree<char>::iterator currentNode = node;
+            ZDDictionaryTree::iterator currentNode = node;
 
             for (auto charr : word)
             {
@@ -227,12 +1242,12 @@ namespace Dico
                 if (!std::get<bool>(result))
                 {
                     //Add the char to the curent node
-                    currentNode = tr.append_child(currentNode, charr);
+                    currentNode = insert_child(tr, currentNode, charr);
                 }
                 //if found, make the founded child a current node
                 else
                 {
-                    currentNode = std::get<ZDTree<char>::iterator>(result);
+                    currentNode = std::get<ZDDictionaryTree::iterator>(result);
                 }
             }
 
@@ -245,12 +1260,12 @@ namespace Dico
         //! @param word the word to be found
         //! @return a tuple with the following value : 
         //! -   bool                : true if the word is found, false othserwise
-        //! - ZDTree<char>::iterator  : if founded, the node corresponding to the last char of the given word is the dictionary, otherwise null_ptr 
-        static inline  std::tuple<bool, ZDTree<char>::iterator> find_word(ZDTree<char>& tr, ZDTree<char>::iterator& node, const std::string& word)
+        //! - ZDDictionaryTree::iterator  : if founded, the node corresponding to the last char of the given word is the dictionary, otherwise null_ptr 
+        static inline  std::tuple<bool, ZDDictionaryTree::iterator> find_word(ZDDictionaryTree& tr, const ZDDictionaryTree::iterator& node, const std::string& word)
         {
-            std::tuple<bool, ZDTree<char>::iterator> found(false, nullptr);
+            std::tuple<bool, ZDDictionaryTree::iterator> found(true, node);
 
-            ZDTree<char>::iterator currentNode = node;
+            ZDDictionaryTree::iterator currentNode = node;
 
             for (auto charr : word)
             {
@@ -258,12 +1273,12 @@ namespace Dico
                 // if the char is found in the child of the current node
                 if (std::get<bool>(found))
                 {
-                    currentNode = std::get<ZDTree<char>::iterator>(found);
+                    currentNode = std::get<ZDDictionaryTree::iterator>(found);
                 }
                 //if not found, the work dont exist
                 else
                 {
-                    found = std::tuple<bool, ZDTree<char>::iterator>(false, nullptr);
+                    found = std::tuple<bool, ZDDictionaryTree::iterator>(false, nullptr);
                     break;
                 }
             }
@@ -271,101 +1286,373 @@ namespace Dico
             return found;
         }
 
-        //! @brief find a word in a given dictionary, staring at a given root node and allowing a number of errors
+        //! @brief find the words of a given dictionary close to a given word : the dictionary is walked depth first
+        //! with one DP row per node, the row of a child being computed from the row of its parent, and a subtree
+        //! is skipped as soon as no prefix of the word is close enough to the path leading to it.
+        //! Words up to 64 chars use Myers' bit-vector row, longer ones a plain row of distances.
         //! @param tr the given dictionary
-        //! @param node the given root
         //! @param word the word to be found
         //! @param max_error the mawimum allow number of errors (addition, delection susbtitution)
-        //! @return a tuple with the following value : 
-        //! - bool                  : true if the word is found, false othserwise
-        //! - ZDTree<char>::iterator  : if founded, the node corresponding to the last found char of the given word is the dictionary, otherwise null_ptr 
-        static inline  std::tuple<bool, ZDTree<char>::iterator, int> find_word(ZDTree<char>& tr, ZDTree<char>::iterator& node, std::string& word, int max_error)
+        //! @param visitor called with each found word and its number of errors, the walk stops if it returns false
+        template<class Visitor>
+        static inline void find_words(const ZDDictionaryTree& tr, const std::string& word, int max_error, Visitor visitor)
         {
-            std::tuple<bool, ZDTree<char>::iterator> found_child(false, nullptr);
-            std::tuple<bool, ZDTree<char>::iterator, int> las_found(false, nullptr, -1);
+            if (max_error < 0)
+            {
+                return;
+            }
+
+            if (word.size() <= ZDMyersPattern::max_size)
+            {
+                struct Frame
+                {
+                    const TreeNode<ZDNodeData>* node;
+                    ZDMyersRow row;
+                };
 
-            std::tuple<bool, ZDTree<char>::iterator, int> found_sub(false, nullptr, -1);
-            std::tuple<bool, ZDTree<char>::iterator, int> found_add(false, nullptr, -1);
-            std::tuple<bool, ZDTree<char>::iterator, int> found_del(false, nullptr, -1);
+                const ZDMyersPattern pattern(word);
+                std::vector<Frame> stack;
+                std::string path;
 
-            ZDTree<char>::iterator currentNode = node;
+                for (auto root = tr.head->next_sibling; root != tr.feet; root = root->next_sibling)
+                {
+                    stack.push_back(Frame{ root, pattern.advance(pattern.first_row(), root->data.letter) });
+                }
 
-            int count = 1;
-            if (word.size() == 0)
-            {
-                return las_found;
-            }
+                while (!stack.empty())
+                {
+                    const Frame frame = stack.back();
+                    stack.pop_back();
 
-            for (auto charr : word)
+                    //no word below this node can be close enough
+                    if (pattern.minimum(frame.row, max_error) > max_error)
+                    {
+                        continue;
+                    }
+
+                    path.resize(frame.row.column - 1);
+                    path.push_back(frame.node->data.letter);
+
+                    if (frame.node->data.terminal && frame.row.score <= max_error && !visitor(path, frame.row.score))
+                    {
+                        return;
+                    }
+
+                    for (auto child = frame.node->first_child; child != 0; child = child->next_sibling)
+                    {
+                        stack.push_back(Frame{ child, pattern.advance(frame.row, child->data.letter) });
+                    }
+                }
+            }
+            else
             {
-                if (max_error > 0)
+                struct Frame
+                {
+                    const TreeNode<ZDNodeData>* node;
+                    std::size_t depth;
+                };
+
+                //rows[depth] holds the row of the last node visited at that depth, which is
+                //still the row of the parent when a node is popped (depth first order)
+                const std::size_t columns = word.size() + 1;
+                std::vector<int> rows(columns);
+                std::vector<Frame> stack;
+                std::string path;
+
+                for (std::size_t i = 0; i < columns; ++i)
+                {
+                    rows[i] = static_cast<int>(i);
+                }
+
+                for (auto root = tr.head->next_sibling; root != tr.feet; root = root->next_sibling)
+                {
+                    stack.push_back(Frame{ root, 1 });
+                }
+
+                while (!stack.empty())
                 {
-                    found_child = has_child(tr, currentNode, charr);
-                    // if the char is found in the child of the current node
-                    if (std::get<bool>(found_child))
+                    const Frame frame = stack.back();
+                    stack.pop_back();
+
+                    if (rows.size() < (frame.depth + 1) * columns)
                     {
-                        //get the next node
-                        currentNode = std::get<ZDTree<char>::iterator>(found_child);
+                        rows.resize((frame.depth + 1) * columns);
+                    }
+
+                    const int* previous = rows.data() + (frame.depth - 1) * columns;
+                    int* current = rows.data() + frame.depth * columns;
+                    const char letter = frame.node->data.letter;
 
-                        //save the lastest founded word
-                        las_found = std::tuple<bool, ZDTree<char>::iterator, int>(std::get<0>(found_child), std::get<1>(found_child), max_error);
+                    current[0] = static_cast<int>(frame.depth);
+                    int minimum = current[0];
+                    for (std::size_t i = 1; i < columns; ++i)
+                    {
+                        const int cost = (word[i - 1] == letter) ? 0 : 1;
+                        current[i] = std::min({ previous[i] + 1, current[i - 1] + 1, previous[i - 1] + cost });
+                        minimum = std::min(minimum, current[i]);
                     }
-                    //if char is not found, max_error is decreased, search continue:
-                        //-   with the next depth and the next char (case of substutuation of char)
-                        //-   with the same depth and the next char (case of add char)
-                        //-   with the next depth and the same char (case of deleate char)
-                    else
+
+                    //no word below this node can be close enough
+                    if (minimum > max_error)
+                    {
+                        continue;
+                    }
+
+                    path.resize(frame.depth - 1);
+                    path.push_back(letter);
+
+                    if (frame.node->data.terminal && current[columns - 1] <= max_error && !visitor(path, current[columns - 1]))
+                    {
+                        return;
+                    }
+
+                    for (auto child = frame.node->first_child; child != 0; child = child->next_sibling)
                     {
-                        --max_error;
+                        stack.push_back(Frame{ child, frame.depth + 1 });
+                    }
+                }
+            }
+        }
+
+        //! @brief find the words of a given dictionary close to a given word with a weighted edit distance : the
+        //! dictionary is walked depth first with one row of costs per node, like find_words above. A subtree is
+        //! skipped as soon as the lowest cost of the row of its node is over the budget, every later cost being
+        //! built on it, unless a transposition from the row of the parent may still fit. The word and the letters
+        //! are seen as symbols (see ZDCostModel::fold) : the node of the lead byte of a two bytes Latin-1 char costs
+        //! nothing, and its child stands for the whole char.
+        //! @param tr the given dictionary
+        //! @param given the word to be found
+        //! @param model the costs of the errors
+        //! @param budget the maximum total cost of the errors
+        //! @param visitor called with each found word and its cost, the walk stops if it returns false
+        template<class Visitor>
+        static inline void find_words(const ZDDictionaryTree& tr, const std::string& given, const ZDCostModel& model, float budget, Visitor visitor)
+        {
+            if (budget < 0.0f)
+            {
+                return;
+            }
 
-                        found_sub = find_word(tr, currentNode, word.substr(count, word.size()), max_error);
-                        found_add = find_word(tr, currentNode, word.substr(count, word.size()), max_error);
-                        found_del = find_word(tr, ZDTree<char>::iterator(currentNode.node->first_child), word.substr(count - 1, word.size()), max_error);
+            struct Frame
+            {
+                const TreeNode<ZDNodeData>* node;
+                std::size_t depth;
+            };
+
+            const std::string word = ZDCostModel::fold(given);
+
+            //rows[depth] holds the row of the last node visited at that depth, and minima[depth] its lowest cost
+            const float limit = budget + cost_tolerance;
+            const float transposition = model.transposition();
+            const std::size_t columns = word.size() + 1;
+            std::vector<float> rows(columns);
+            std::vector<float> minima(1, 0.0f);
+            std::vector<float> deletions(columns, 0.0f);
+            std::vector<Frame> stack;
+            std::string path;
+
+            //the symbol of each node of the path, null for a lead byte
+            std::string symbols;
+
+            for (std::size_t i = 1; i < columns; ++i)
+            {
+                deletions[i] = model.deletion(word[i - 1]);
+                rows[i] = rows[i - 1] + deletions[i];
+            }
 
-                        las_found = found_add;
+            for (auto root = tr.head->next_sibling; root != tr.feet; root = root->next_sibling)
+            {
+                stack.push_back(Frame{ root, 1 });
+            }
 
-                        if (std::get<0>(found_sub)) las_found = found_sub;
+            while (!stack.empty())
+            {
+                const Frame frame = stack.back();
+                stack.pop_back();
 
-                        if (std::get<0>(found_add) && std::get<2>(found_add) > std::get<2>(las_found)) las_found = found_add;
+                if (rows.size() < (frame.depth + 1) * columns)
+                {
+                    rows.resize((frame.depth + 1) * columns);
+                    minima.resize(frame.depth + 1);
+                }
 
-                        if (std::get<0>(found_del) && std::get<2>(found_del) > std::get<2>(las_found)) las_found = found_del;
+                const float* previous = rows.data() + (frame.depth - 1) * columns;
+                float* current = rows.data() + frame.depth * columns;
+                const char byte = frame.node->data.letter;
+                path.resize(frame.depth - 1);
+                symbols.resize(frame.depth - 1);
 
-                        break;
+                //the lead byte of a Latin-1 char : the row of the parent is kept for its child
+                if (ZDCostModel::is_latin1_lead(byte))
+                {
+                    std::copy(previous, previous + columns, current);
+                    minima[frame.depth] = minima[frame.depth - 1];
+                    path.push_back(byte);
+                    symbols.push_back(0);
+                    for (auto child = frame.node->first_child; child != 0; child = child->next_sibling)
+                    {
+                        stack.push_back(Frame{ child, frame.depth + 1 });
                     }
+                    continue;
                 }
-                else
+
+                const bool folded = frame.depth > 1 && symbols.back() == 0 && ZDCostModel::is_continuation(byte);
+                const char letter = folded ? ZDCostModel::to_latin1(path.back(), byte) : byte;
+                const float insertion = model.insertion(letter);
+                const float* substitutions = model.substitutions(letter);
+
+                //the symbol before this one, and the row before that symbol, for a transposition
+                const std::size_t beforeDepth = folded ? frame.depth - 2 : frame.depth - 1;
+                const bool swapped = beforeDepth > 0;
+                const char before = swapped ? symbols[beforeDepth - 1] : 0;
+                const float* beforeRow = swapped ? rows.data() + (beforeDepth - 1) * columns : 0;
+
+                current[0] = previous[0] + insertion;
+                float minimum = current[0];
+                for (std::size_t i = 1; i < columns; ++i)
+                {
+                    current[i] = std::min({ previous[i] + insertion,
+                                            current[i - 1] + deletions[i],
+                                            previous[i - 1] + substitutions[static_cast<unsigned char>(word[i - 1])] });
+                    if (swapped && i > 1 && word[i - 1] == before && word[i - 2] == letter)
+                    {
+                        current[i] = std::min(current[i], beforeRow[i - 2] + transposition);
+                    }
+                    minimum = std::min(minimum, current[i]);
+                }
+                minima[frame.depth] = minimum;
+
+                //no word below this node can be close enough
+                if (minimum > limit && minima[frame.depth - 1] + transposition > limit)
                 {
-                    las_found = std::tuple<bool, ZDTree<char>::iterator, int>(false, nullptr, -1);
+                    continue;
                 }
 
-                ++count;
-            }
+                path.push_back(byte);
+                symbols.push_back(letter);
 
-            return las_found;
+                if (frame.node->data.terminal && current[columns - 1] <= limit && !visitor(path, current[columns - 1]))
+                {
+                    return;
+                }
+
+                for (auto child = frame.node->first_child; child != 0; child = child->next_sibling)
+                {
+                    stack.push_back(Frame{ child, frame.depth + 1 });
+                }
+            }
         }
 
-        //! @brief remove a word from a giveen dicionary , the word to be removed is identified by the pre_begin_node and pre_end_node
+        //! @brief insert a new child to a node of a given dictionary, the children being kept in alphabetical
+        //! order so that word ids follow the alphabetical order
         //! @param tr the given dictionary
-        //! @param pre_begin_node the most deeper node of the word in the dictionary
-        //! @param pre_end_node the most shallow node of the word in the dictionary
-        //! @return  true if the word was sucefully removed , false otherwise
-        static inline bool remove_word(ZDTree<char>& tr, ZDTree<char>::iterator& pre_begin_node, ZDTree<char>::iterator& pre_end_node)
+        //! @param node the given node
+        //! @param data the char of the new child
+        //! @return the new child
+        static inline ZDDictionaryTree::iterator insert_child(ZDDictionaryTree& tr, const ZDDictionaryTree::iterator& node, char data)
         {
-            ZDTree<char>::pre_order_iterator pre = pre_begin_node;
-            ZDTree<char>::pre_order_iterator toArase = pre_begin_node;
-            while (pre != pre_end_node)
+            for (auto sib = node.node->first_child; sib != 0; sib = sib->next_sibling)
             {
-                if (!has_child(pre.node))
+                if (static_cast<unsigned char>(sib->data.letter) > static_cast<unsigned char>(data))
                 {
-                    toArase = pre;
-                    --pre;
-                    tr.erase(toArase);
+                    return tr.emplace(ZDDictionaryTree::iterator(sib), data);
                 }
-                else
+            }
+            return tr.emplace_child(node, data);
+        };
+
+        //! @brief fill the jump table from the first two levels of the tree, or empty it if turned off; needed
+        //! whenever the nodes are moved or replaced
+        void rebuild_jump_table()
+        {
+            m_roots.clear();
+            m_jump.clear();
+            m_rootSlots.assign(jump_width, no_slot);
+            if (!m_jumpEnabled)
+            {
+                return;
+            }
+
+            for (auto root = m_internalTree.head->next_sibling; root != m_internalTree.feet && m_roots.size() < no_slot; root = root->next_sibling)
+            {
+                m_rootSlots[static_cast<unsigned char>(root->data.letter)] = static_cast<uint8_t>(m_roots.size());
+                m_roots.push_back(root);
+                m_jump.resize(m_jump.size() + jump_width, nullptr);
+                for (auto child = root->first_child; child != 0; child = child->next_sibling)
+                {
+                    m_jump[(m_roots.size() - 1) * jump_width + static_cast<unsigned char>(child->data.letter)] = child;
+                }
+            }
+        };
+
+        //! @brief set the jump table entry of the second level node of a word, after it was added or removed
+        //! @param root the root of the word
+        //! @param rest the rest of the word, after the root char
+        void update_jump_table(const TreeNode<ZDNodeData>* root, const std::string& rest)
+        {
+            if (m_roots.empty() || rest.empty())
+            {
+                return;
+            }
+            TreeNode<ZDNodeData>* child = root->first_child;
+            while (child != 0 && child->data.letter != rest[0])
+            {
+                child = child->next_sibling;
+            }
+            m_jump[m_rootSlots[static_cast<unsigned char>(root->data.letter)] * jump_width + static_cast<unsigned char>(rest[0])] = child;
+        };
+
+        //! @brief update the number of words of a node and of all its parents
+        //! @param node the given node
+        //! @param delta the number of words added (or removed if negative)
+        static inline void add_words(const ZDDictionaryTree::iterator& node, int delta)
+        {
+            for (auto current = node.node; current != 0; current = current->parent)
+            {
+                current->data.words = static_cast<uint32_t>(static_cast<int64_t>(current->data.words) + delta);
+            }
+        };
+
+        //! @brief compute again the highest weight of the subtree of a node, and of its parents while it changes
+        //! @param node the given node
+        static inline void update_max_weight(const ZDDictionaryTree::iterator& node)
+        {
+            for (auto current = node.node; current != 0; current = current->parent)
+            {
+                uint32_t maxWeight = current->data.terminal ? current->data.weight : 0;
+                for (auto child = current->first_child; child != 0; child = child->next_sibling)
+                {
+                    maxWeight = std::max(maxWeight, child->data.max_weight);
+                }
+
+                if (maxWeight == current->data.max_weight)
                 {
                     break;
                 }
+                current->data.max_weight = maxWeight;
+            }
+        };
+
+        //! @brief remove a word from a giveen dicionary : the word is unmarked, then its nodes which are not
+        //! used by other words are erased, from the deeper one up to the root (excluded)
+        //! @param tr the given dictionary
+        //! @param pre_begin_node the most deeper node of the word in the dictionary
+        //! @param pre_end_node the most shallow node of the word in the dictionary
+        //! @return  true if the word was sucefully removed , false otherwise
+        static inline bool remove_word(ZDDictionaryTree& tr, const ZDDictionaryTree::iterator& pre_begin_node, const ZDDictionaryTree::iterator& pre_end_node)
+        {
+            pre_begin_node->terminal = false;
+            pre_begin_node->weight = 0;
+            add_words(pre_begin_node, -1);
+
+            ZDDictionaryTree::iterator pre = pre_begin_node;
+            while (pre != pre_end_node && !has_child(pre) && !pre->terminal)
+            {
+                ZDDictionaryTree::iterator toArase = pre;
+                pre = ZDDictionaryTree::iterator(pre.node->parent);
+                tr.erase(toArase);
             }
+            update_max_weight(pre);
 
             return true;
         }
@@ -373,7 +1660,7 @@ namespace Dico
         //! @brief check if a node has a leat one child
         //! @param node 
         //! @return 
-        static inline bool has_child(const ZDTree<char>::iterator_base& node)
+        static inline bool has_child(const ZDDictionaryTree::iterator_base& node)
         {
             return (node.node->first_child != 0 || node.node->last_child != 0);
         };
@@ -384,19 +1671,19 @@ namespace Dico
         //! @param data the given char
         //! @return a tuple with the following value : 
         //! - bool                  : true if the char is found, false othserwise
-        //! - ZDTree<char>::iterator  : if founded, the node corresponding to the child countaining the given char
-        static inline std::tuple<bool, ZDTree<char>::iterator> has_child(const ZDTree<char>& tr, ZDTree<char>::iterator& node, char data)
+        //! - ZDDictionaryTree::iterator  : if founded, the node corresponding to the child countaining the given char
+        static inline std::tuple<bool, ZDDictionaryTree::iterator> has_child(const ZDDictionaryTree& tr, ZDDictionaryTree::iterator& node, char data)
         {
-            std::tuple<bool, ZDTree<char>::iterator> result(false, nullptr);
+            std::tuple<bool, ZDDictionaryTree::iterator> result(false, nullptr);
 
             if (has_child(node))
             {
-                ZDTree<char>::sibling_iterator sib = tr.begin(node.node);
+                ZDDictionaryTree::sibling_iterator sib = tr.begin(node.node);
                 while (sib != tr.end(node.node))
                 {
                     if ((*sib) == data)
                     {
-                        return std::tuple<bool, ZDTree<char>::iterator>(true, sib);
+                        return std::tuple<bool, ZDDictionaryTree::iterator>(true, sib);
                     }
                     ++sib;
                 }
@@ -421,6 +1708,57 @@ namespace Dico
             return lowerCase;
         };
 
+        //! @brief write a node of the tree to a binary stream
+        //! @param out the given stream
+        //! @param data the data of the node
+        static inline void write_node(std::ostream& out, const ZDNodeData& data)
+        {
+            const bool weighted = data.terminal && data.weight != 0;
+            out.put(data.letter);
+            out.put(static_cast<char>((data.terminal ? terminal_flag | id_flag : 0) | (weighted ? weight_flag : 0)));
+            if (weighted)
+            {
+                write_pod(out, data.weight);
+            }
+            if (data.terminal)
+            {
+                write_pod(out, data.id);
+            }
+        };
+
+        //! @brief the file type and version of the binary format
+        static constexpr char file_magic[5] = "ZDDC";
+        static constexpr uint32_t file_version = 3;
+
+        //! @brief the flag of a node ending a word, in the binary format
+        static constexpr int terminal_flag = 1;
+
+        //! @brief the flag of a word followed by its weight, in the binary format (since version 2)
+        static constexpr int weight_flag = 2;
+
+        //! @brief the flag of a word followed by its id, in the binary format (since version 3)
+        static constexpr int id_flag = 4;
+
+        //! @brief the id of a word not numbered yet (see rebuild_ids)
+        static constexpr uint32_t no_id = 0xFFFFFFFF;
+
+        //! @brief the rounding allowed on the total cost of a weighted search, so that the costs adding up to
+        //! the budget exactly are kept
+        static constexpr float cost_tolerance = 1e-4f;
+
+        //! @brief the jump table (see set_jump_table) : the slot of each root by char, the roots by slot, and the
+        //! second level nodes by root slot and char; empty when turned off
+        static constexpr std::size_t jump_width = 256;
+        static constexpr uint8_t no_slot = 0xFF;
+        bool m_jumpEnabled = true;
+        std::vector<uint8_t> m_rootSlots;
+        std::vector<TreeNode<ZDNodeData>*> m_roots;
+        std::vector<TreeNode<ZDNodeData>*> m_jump;
+
+        //! @brief the node of the word of each id, null for a free id, and the free ids (see word_id)
+        std::vector<const TreeNode<ZDNodeData>*> m_idNodes;
+        std::vector<uint32_t> m_freeIds;
+
         //! @brief this is a helper vector to stor alphabetic later, used in the initialiszation of the dictionary
         std::vector<char> FrenchAlphabet = { 'a','b','c','d','e','f','g','h','i','j','k','l','m','n',
                                        'o','p','q','r','s','t','u','v','w','x','y','z' };
@@ -444,7 +1782,7 @@ namespace Dico
         //!    +----N----E-----T------F-----L-----I-----X
         //!         |
         //!         A----N-----O------M-----E------T------T-----R-----E
-        ZDTree<char> m_internalTree;
+        ZDDictionaryTree m_internalTree;
     };
 }
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include "Tree/ZDTree.h"
+#include "Memory/ZDPlacement.h"
+
+namespace Dico
+{
+    //! @brief the data stored at each node of the dictionary tree : a letter of a word, whether a
+    //! word ends on this letter and its weight, and for the subtree of the node how many words end
+    //! in it and the highest weight of these words
+    struct ZDNodeData
+    {
+        //! @brief default constructor
+        ZDNodeData() = default;
+
+        //! @brief build the data of a letter, not ending any word (implicit so a char can be inserted in the tree)
+        //! @param letter the given letter
+        ZDNodeData(char letter)
+            : letter(letter)
+        {
+        };
+
+        //! @brief compare the letter of the node with a given char
+        bool operator==(char other) const
+        {
+            return letter == other;
+        };
+
+        //! @brief compare the letter of the node with a given char
+        bool operator!=(char other) const
+        {
+            return letter != other;
+        };
+
+        //! @brief the letter
+        char letter = 0;
+
+        //! @brief true if a word of the dictionary ends on this letter
+        bool terminal = false;
+
+        //! @brief the number of words ending on this node or below it
+        uint32_t words = 0;
+
+        //! @brief the weight of the word ending on this letter (typicaly its frequency), if any
+        uint32_t weight = 0;
+
+        //! @brief the highest weight of the words ending on this node or below it
+        uint32_t max_weight = 0;
+
+        //! @brief the id of the word ending on this letter, if any (see ZDDictionary::word_id)
+        uint32_t id = 0;
+    };
+
+    //! @brief the tree type used to manage the dictionary, its block of nodes may be placed (see ZDDictionary::set_placement)
+    typedef ZDTree<ZDNodeData, ZDPlacedAllocator<TreeNode<ZDNodeData>>> ZDDictionaryTree;
+}
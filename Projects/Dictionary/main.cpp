@@ -3,6 +3,12 @@
 #include "Lexico/ZDLexico.h"
 #include "ZDDictionary.h"
 #include "Tree/ZDTree.h"
+#include "Index/ZDBKTree.h"
+#include "Index/ZDPhoneticIndex.h"
+#include "Pipeline/ZDSpellChecker.h"
+#if defined(ZD_EMBEDDED_LEXICO)
+#include "ZDEmbeddedLexico.h"
+#endif
 
 using namespace std;
 using namespace Dico;
@@ -23,12 +29,14 @@ int main(int argc, char* argv[])
     
         ZDDictionary dictionary;
 
-        //add all words from data base lexico
-        for (auto word : lexicoBase.getWords())
+        //add all words from data base lexico, with their weight
+        const auto& words = lexicoBase.getWords();
+        const auto& weights = lexicoBase.getWeights();
+        for (std::size_t i = 0; i < words.size(); ++i)
         {
-            if (!dictionary.insert_word(word))
+            if (!dictionary.insert_word(words[i], weights[i]))
             {
-                std::cout << "can not insert word" << word;
+                std::cout << "can not insert word" << words[i];
                 assert(false);
             }
         }
@@ -81,6 +89,42 @@ int main(int argc, char* argv[])
         foundResult = dictionary.find_word("aaissa", 3);
 
         std::cout << "find remove middle word " << "aaissa" << " found  = " << foundResult << std::endl;
+
+        std::cout << "word " << "abaissa" << " id = " << std::get<uint32_t>(dictionary.word_id("abaissa")) << " of " << dictionary.word_count() << std::endl;
+
+        std::cout << "words matching " << "a?ai*nt" << " : " << dictionary.match("a?ai*nt").all().size() << std::endl;
+
+        std::cout << "completions of " << "abaiss" << " : " << dictionary.complete("abaiss", 5).size() << std::endl;
+
+        ZDSpellChecker spellChecker(dictionary);
+        std::cout << "misspelled words in text : " << spellChecker.check("Il s'abaissa aujourd'hui sur l'abat-jour, puis s'abaisza.").size() << std::endl;
+
+        //alternative fuzzy engine : a BK-tree over the same lexico
+        ZDBKTree bkTree;
+        bkTree.build(lexicoBase.getWords());
+
+        foundResult = bkTree.find_word("azaissa", 1);
+
+        std::cout << "bk-tree find sub middle word " << "azaissa" << " found  = " << foundResult << std::endl;
+
+        foundResult = bkTree.find_word("aaissa", 1);
+
+        std::cout << "bk-tree find remove middle word " << "aaissa" << " found  = " << foundResult << std::endl;
+
+        //sound-alike lookups : a phonetic key index over the words of the dictionary
+        ZDPhoneticIndex phoneticIndex;
+        phoneticIndex.build(dictionary);
+
+        foundResult = phoneticIndex.find_word("fotographie", 2);
+
+        std::cout << "phonetic find sound-alike word " << "fotographie" << " found  = " << foundResult << std::endl;
+
+#if defined(ZD_EMBEDDED_LEXICO)
+        //the same lexico compiled into the binary at build time, read without loading
+        foundResult = embedded_lexico.find_word("abaissa");
+
+        std::cout << "embedded find word " << "abaissa" << " found  = " << foundResult << " of " << embedded_lexico.word_count() << std::endl;
+#endif
     }
     else
     {
@@ -0,0 +1,66 @@
+
+#include <iostream>
+#include <string>
+#include "Lexico/ZDLexico.h"
+#include "ZDDictionary.h"
+#include "Embed/ZDStaticDictionaryWriter.h"
+
+using namespace std;
+using namespace Dico;
+
+//! @brief load a dictionary from a snapshot written by ZDDictionary::save, or from a lexico text file
+//! @param path the path of the file
+//! @param dictionary the loaded dictionary
+//! @return true if succes, false otherwise
+static bool load_dictionary(const string& path, ZDDictionary& dictionary)
+{
+    if (dictionary.load(path))
+    {
+        return true;
+    }
+
+    Lexico lexicoBase;
+    if (!lexicoBase.read(path))
+    {
+        return false;
+    }
+
+    const auto& words = lexicoBase.getWords();
+    const auto& weights = lexicoBase.getWeights();
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        dictionary.insert_word(words[i], weights[i]);
+    }
+    return true;
+}
+
+//! @brief This this the dictionary embedding app, run at build time to compile a fixed lexicon into a binary :
+//! DictionaryEmbed <dictionary or lexico file> <output source> <output header> <name>
+//! @param argc
+//! @param argv
+//! @return return 0 if succes
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cout << "usage : DictionaryEmbed <dictionary or lexico file> <output source> <output header> [name]" << std::endl;
+        return 1;
+    }
+    const string name = (argc > 4) ? argv[4] : "embedded_lexico";
+
+    ZDDictionary dictionary;
+    if (!load_dictionary(argv[1], dictionary))
+    {
+        std::cout << "Errro reading dictionary " << argv[1] << std::endl;
+        return 1;
+    }
+
+    if (!ZDStaticDictionaryWriter::write(dictionary, argv[2], argv[3], name))
+    {
+        std::cout << "Errro writing " << argv[2] << " and " << argv[3] << std::endl;
+        return 1;
+    }
+
+    std::cout << "embedded " << dictionary.word_count() << " words as " << name << std::endl;
+    return 0;
+}
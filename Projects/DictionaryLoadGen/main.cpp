@@ -0,0 +1,148 @@
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include "Lexico/ZDLexico.h"
+#include "Server/ZDClient.h"
+
+using namespace std;
+using namespace Dico;
+
+typedef std::chrono::steady_clock Clock;
+
+//! @brief the settings of a run
+struct LoadSettings
+{
+    string socketPath = "/tmp/dictionary.sock";
+    string wordsPath = "./Lexico.txt";
+    unsigned int connections = 4;           //!< the number of clients, one thread each
+    unsigned int depth = 16;                //!< the number of requests in flight per client
+    unsigned int requests = 100000;         //!< the number of requests per client
+    ZDOperation operation = ZDOperation::Lookup;
+};
+
+//! @brief run one client : keep depth requests in flight, and measure the time of each one
+//! @param settings the settings of the run
+//! @param words the words to be requested
+//! @param seed the seed of the choice of the words
+//! @param latencies the time of each answered request, in nanoseconds, appended
+//! @return true if succes, false otherwise
+static bool run_client(const LoadSettings& settings, const vector<string>& words, unsigned int seed, vector<uint64_t>& latencies)
+{
+    ZDClient client;
+    if (!client.connect(settings.socketPath))
+    {
+        return false;
+    }
+
+    std::mt19937 random(seed);
+    std::deque<Clock::time_point> inFlight;
+    ZDRequest request;
+    request.operation = settings.operation;
+    request.max_error = 1;
+    request.count = 10;
+    ZDResponse response;
+
+    unsigned int sent = 0;
+    latencies.reserve(latencies.size() + settings.requests);
+    while (sent < settings.requests || !inFlight.empty())
+    {
+        while (sent < settings.requests && inFlight.size() < settings.depth)
+        {
+            request.id = sent++;
+            request.key = words[random() % words.size()];
+            if (request.operation == ZDOperation::Complete)
+            {
+                request.key.resize(std::min<std::size_t>(request.key.size(), 3));
+            }
+            client.send(request);
+            inFlight.push_back(Clock::now());
+        }
+
+        if (!client.receive(response))
+        {
+            return false;
+        }
+        latencies.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - inFlight.front()).count()));
+        inFlight.pop_front();
+    }
+    return true;
+}
+
+//! @brief This this the dictionary server load generator app :
+//! DictionaryLoadGen <socket path> <lexico file> <connections> <depth> <requests per connection> <lookup|complete|suggest>
+//! @param argc
+//! @param argv
+//! @return return 0 if succes
+int main(int argc, char* argv[])
+{
+    LoadSettings settings;
+    if (argc > 1) settings.socketPath = argv[1];
+    if (argc > 2) settings.wordsPath = argv[2];
+    if (argc > 3) settings.connections = std::max(1, atoi(argv[3]));
+    if (argc > 4) settings.depth = std::max(1, atoi(argv[4]));
+    if (argc > 5) settings.requests = std::max(1, atoi(argv[5]));
+    if (argc > 6)
+    {
+        const string operation = argv[6];
+        settings.operation = (operation == "complete") ? ZDOperation::Complete : (operation == "suggest") ? ZDOperation::Suggest : ZDOperation::Lookup;
+    }
+
+    Lexico lexicoBase;
+    if (!lexicoBase.read(settings.wordsPath) || lexicoBase.getWords().empty())
+    {
+        std::cout << "Errro reading lexico data base" << std::endl;
+        return 1;
+    }
+
+    vector<vector<uint64_t>> latencies(settings.connections);
+    vector<char> succes(settings.connections, 0);
+    vector<std::thread> clients;
+
+    const Clock::time_point start = Clock::now();
+    for (unsigned int c = 0; c < settings.connections; ++c)
+    {
+        clients.emplace_back([&, c]()
+        {
+            succes[c] = run_client(settings, lexicoBase.getWords(), c + 1, latencies[c]);
+        });
+    }
+    for (auto& client : clients)
+    {
+        client.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    vector<uint64_t> all;
+    for (unsigned int c = 0; c < settings.connections; ++c)
+    {
+        if (!succes[c])
+        {
+            std::cout << "client " << c << " failed" << std::endl;
+        }
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+    }
+    if (all.empty())
+    {
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+
+    auto percentile = [&all](double p)
+    {
+        return all[std::min(all.size() - 1, static_cast<std::size_t>(p * all.size()))] / 1000.0;
+    };
+
+    std::cout << "requests      : " << all.size() << std::endl;
+    std::cout << "throughput    : " << all.size() / seconds << " requests/s" << std::endl;
+    std::cout << "latency (us)  : p50 " << percentile(0.50) << ", p90 " << percentile(0.90) << ", p99 " << percentile(0.99)
+        << ", p99.9 " << percentile(0.999) << ", max " << all.back() / 1000.0 << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,350 @@
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "Lexico/ZDLexico.h"
+#include "ZDDictionary.h"
+#include "Radix/ZDRadixTree.h"
+#include "Radix/ZDAdaptiveRadixTree.h"
+#include "Trace/ZDTrace.h"
+#include "Trace/ZDHistogram.h"
+
+using namespace std;
+using namespace Dico;
+
+typedef std::chrono::steady_clock Clock;
+
+//! @brief the settings of a replay
+struct ReplaySettings
+{
+    string tracePath = "./trace.zdt";
+    string dictionaryPath = "./Lexico.txt";
+    string backend = "dictionary";          //!< dictionary, radix or art
+    unsigned int threads = 1;
+    bool openLoop = false;                  //!< true to send the queries at the times of the trace, false to send each one when the previous one is answered
+    double speed = 1.0;                     //!< the rate of the trace is multiplied by speed, in open loop
+};
+
+//! @brief the counters of a replay, per thread then added
+struct ReplayCounters
+{
+    uint64_t lookups = 0;
+    uint64_t completions = 0;
+    uint64_t suggestions = 0;
+    uint64_t unsupported = 0;               //!< the queries the backend can not answer
+    uint64_t found = 0;                     //!< the queries having results
+    uint64_t results = 0;                   //!< the number of results
+    uint64_t late = 0;                      //!< the queries started more than a millisecond after their time, in open loop
+    uint64_t maxLag = 0;                    //!< the longest delay of a query start after its time, in nanoseconds
+
+    //! @brief add the counters of another thread
+    void merge(const ReplayCounters& other)
+    {
+        lookups += other.lookups;
+        completions += other.completions;
+        suggestions += other.suggestions;
+        unsupported += other.unsupported;
+        found += other.found;
+        results += other.results;
+        late += other.late;
+        maxLag = std::max(maxLag, other.maxLag);
+    }
+};
+
+//! @brief a structure answering the queries of a trace
+class ReplayBackend
+{
+public:
+    virtual ~ReplayBackend() = default;
+
+    //! @brief answer a query
+    //! @param record the query
+    //! @param counters the counters of the thread
+    virtual void run(const ZDTraceRecord& record, ReplayCounters& counters) const = 0;
+
+    //! @brief print the counters of the structure
+    virtual void report() const = 0;
+
+protected:
+    //! @brief count the results of a query
+    static void count_results(std::size_t results, ReplayCounters& counters)
+    {
+        counters.results += results;
+        counters.found += (results != 0) ? 1 : 0;
+    }
+};
+
+//! @brief the queries answered by ZDDictionary, as the dictionary server does
+class DictionaryBackend : public ReplayBackend
+{
+public:
+    explicit DictionaryBackend(const ZDDictionary& dictionary)
+        : m_dictionary(dictionary)
+    {
+    }
+
+    void run(const ZDTraceRecord& record, ReplayCounters& counters) const override
+    {
+        switch (record.operation)
+        {
+        case ZDOperation::Lookup:
+            ++counters.lookups;
+            count_results(std::get<bool>(m_dictionary.word_weight(record.key)) ? 1 : 0, counters);
+            break;
+        case ZDOperation::Complete:
+            ++counters.completions;
+            count_results(m_dictionary.complete(record.key, record.count).size(), counters);
+            break;
+        case ZDOperation::Suggest:
+            ++counters.suggestions;
+            count_results(m_dictionary.suggest(record.key, record.max_error, record.count).size(), counters);
+            break;
+        default:
+            ++counters.unsupported;
+            break;
+        }
+    }
+
+    void report() const override
+    {
+        std::cout << "backend       : dictionary, " << m_dictionary.word_count() << " words" << std::endl;
+    }
+
+private:
+    const ZDDictionary& m_dictionary;
+};
+
+//! @brief the queries answered by a radix tree (ZDRadixTree or ZDAdaptiveRadixTree) : the words have no weight,
+//! so a completion gets the first words of the prefix and a suggestion the closest words
+template<class Tree>
+class RadixBackend : public ReplayBackend
+{
+public:
+    explicit RadixBackend(const vector<string>& words)
+    {
+        m_tree.build(words);
+    }
+
+    void run(const ZDTraceRecord& record, ReplayCounters& counters) const override
+    {
+        switch (record.operation)
+        {
+        case ZDOperation::Lookup:
+            ++counters.lookups;
+            count_results(m_tree.find_word(record.key) ? 1 : 0, counters);
+            break;
+        case ZDOperation::Complete:
+            ++counters.completions;
+            count_results(m_tree.find_prefix(record.key, record.count).size(), counters);
+            break;
+        case ZDOperation::Suggest:
+            ++counters.suggestions;
+            count_results(m_tree.find_words(record.key, record.max_error, record.count).size(), counters);
+            break;
+        default:
+            ++counters.unsupported;
+            break;
+        }
+    }
+
+    void report() const override;
+
+private:
+    Tree m_tree;
+};
+
+template<>
+void RadixBackend<ZDRadixTree>::report() const
+{
+    std::cout << "backend       : radix, " << m_tree.word_count() << " words, " << m_tree.node_count() << " nodes, "
+        << m_tree.label_size() << " label bytes" << std::endl;
+}
+
+template<>
+void RadixBackend<ZDAdaptiveRadixTree>::report() const
+{
+    const auto statistics = m_tree.statistics();
+    std::cout << "backend       : art, " << m_tree.word_count() << " words, " << statistics.leaves << " leaves, " << statistics.node4 << " node4, "
+        << statistics.node16 << " node16, " << statistics.node48 << " node48, " << statistics.node256 << " node256, " << statistics.bytes << " bytes" << std::endl;
+}
+
+//! @brief load a dictionary from a snapshot written by ZDDictionary::save, or from a lexico text file
+//! @param path the path of the file
+//! @param dictionary the loaded dictionary
+//! @return true if succes, false otherwise
+static bool load_dictionary(const string& path, ZDDictionary& dictionary)
+{
+    if (dictionary.load(path))
+    {
+        return true;
+    }
+
+    Lexico lexicoBase;
+    if (!lexicoBase.read(path))
+    {
+        return false;
+    }
+
+    const auto& words = lexicoBase.getWords();
+    const auto& weights = lexicoBase.getWeights();
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        dictionary.insert_word(words[i], weights[i]);
+    }
+    return true;
+}
+
+//! @brief replay the queries of one thread
+//! @param settings the settings of the replay
+//! @param backend the structure answering the queries
+//! @param records the queries of the trace
+//! @param thread the index of the thread, it takes every threads-th query in open loop
+//! @param next the index of the next query not taken, in closed loop
+//! @param start the start of the replay
+//! @param latencies the latency of each query, in nanoseconds
+//! @param counters the counters of the thread
+static void run_thread(const ReplaySettings& settings, const ReplayBackend& backend, const vector<ZDTraceRecord>& records, unsigned int thread,
+    std::atomic<std::size_t>& next, Clock::time_point start, ZDHistogram& latencies, ReplayCounters& counters)
+{
+    if (settings.openLoop)
+    {
+        //the latency is counted from the time of the query, so a late start is part of it (no coordinated omission)
+        for (std::size_t i = thread; i < records.size(); i += settings.threads)
+        {
+            const Clock::time_point scheduled = start + std::chrono::nanoseconds(static_cast<int64_t>(records[i].time / settings.speed));
+            std::this_thread::sleep_until(scheduled);
+            const Clock::time_point begin = Clock::now();
+            const uint64_t lag = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - scheduled).count());
+            counters.maxLag = std::max(counters.maxLag, lag);
+            counters.late += (lag > 1000000) ? 1 : 0;
+
+            backend.run(records[i], counters);
+            latencies.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - scheduled).count()));
+        }
+    }
+    else
+    {
+        for (std::size_t i = next++; i < records.size(); i = next++)
+        {
+            const Clock::time_point begin = Clock::now();
+            backend.run(records[i], counters);
+            latencies.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+        }
+    }
+}
+
+//! @brief This this the trace replay app, to measure a structure against real traffic captured by DictionaryServer :
+//! DictionaryReplay <trace file> <dictionary or lexico file> <dictionary|radix|art> <threads> <closed|open> <speed>
+//! @param argc
+//! @param argv
+//! @return return 0 if succes
+int main(int argc, char* argv[])
+{
+    ReplaySettings settings;
+    if (argc > 1) settings.tracePath = argv[1];
+    if (argc > 2) settings.dictionaryPath = argv[2];
+    if (argc > 3) settings.backend = argv[3];
+    if (argc > 4) settings.threads = std::max(1, atoi(argv[4]));
+    if (argc > 5) settings.openLoop = string(argv[5]) == "open";
+    if (argc > 6) settings.speed = std::max(0.001, atof(argv[6]));
+
+    vector<ZDTraceRecord> records;
+    if (!ZDTraceReader::read(settings.tracePath, records) || records.empty())
+    {
+        std::cout << "Errro reading trace " << settings.tracePath << std::endl;
+        return 1;
+    }
+
+    ZDDictionary dictionary;
+    if (!load_dictionary(settings.dictionaryPath, dictionary))
+    {
+        std::cout << "Errro reading dictionary " << settings.dictionaryPath << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<ReplayBackend> backend;
+    if (settings.backend == "dictionary")
+    {
+        backend.reset(new DictionaryBackend(dictionary));
+    }
+    else
+    {
+        vector<string> words;
+        words.reserve(dictionary.word_count());
+        for (std::size_t id = 0; id < dictionary.word_count(); ++id)
+        {
+            words.push_back(dictionary.select(id));
+        }
+        if (settings.backend == "radix")
+        {
+            backend.reset(new RadixBackend<ZDRadixTree>(words));
+        }
+        else if (settings.backend == "art")
+        {
+            backend.reset(new RadixBackend<ZDAdaptiveRadixTree>(words));
+        }
+        else
+        {
+            std::cout << "unknown backend " << settings.backend << std::endl;
+            return 1;
+        }
+    }
+
+    vector<ZDHistogram> latencies(settings.threads);
+    vector<ReplayCounters> counters(settings.threads);
+    vector<std::thread> threads;
+    std::atomic<std::size_t> next(0);
+
+    const Clock::time_point start = Clock::now();
+    for (unsigned int t = 0; t < settings.threads; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            run_thread(settings, *backend, records, t, next, start, latencies[t], counters[t]);
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    ZDHistogram all;
+    ReplayCounters total;
+    for (unsigned int t = 0; t < settings.threads; ++t)
+    {
+        all.merge(latencies[t]);
+        total.merge(counters[t]);
+    }
+
+    auto microseconds = [](uint64_t nanoseconds)
+    {
+        return nanoseconds / 1000.0;
+    };
+
+    const double traceSeconds = records.back().time / 1e9;
+    std::cout << "trace         : " << records.size() << " queries over " << traceSeconds << " s" << std::endl;
+    std::cout << "mode          : " << (settings.openLoop ? "open loop, speed " + std::to_string(settings.speed) : string("closed loop"))
+        << ", " << settings.threads << " threads" << std::endl;
+    backend->report();
+    std::cout << "requests      : " << all.count() << " in " << seconds << " s" << std::endl;
+    std::cout << "throughput    : " << all.count() / seconds << " requests/s" << std::endl;
+    std::cout << "latency (us)  : p50 " << microseconds(all.percentile(0.50)) << ", p90 " << microseconds(all.percentile(0.90))
+        << ", p99 " << microseconds(all.percentile(0.99)) << ", p99.9 " << microseconds(all.percentile(0.999))
+        << ", max " << microseconds(all.max()) << ", mean " << all.mean() / 1000.0 << std::endl;
+    std::cout << "operations    : lookup " << total.lookups << ", complete " << total.completions << ", suggest " << total.suggestions
+        << ", unsupported " << total.unsupported << std::endl;
+    std::cout << "results       : found " << total.found << ", results " << total.results << std::endl;
+    if (settings.openLoop)
+    {
+        std::cout << "schedule      : late " << total.late << ", max lag (us) " << microseconds(total.maxLag) << std::endl;
+    }
+
+    return 0;
+}
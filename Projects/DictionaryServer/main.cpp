@@ -0,0 +1,101 @@
+
+#include <iostream>
+#include <csignal>
+#include "Lexico/ZDLexico.h"
+#include "ZDDictionary.h"
+#include "Server/ZDServer.h"
+
+using namespace std;
+using namespace Dico;
+
+//! @brief the running server, stopped by SIGINT and SIGTERM
+static ZDServer* runningServer = nullptr;
+
+//! @brief stop the running server
+static void on_signal(int)
+{
+    if (runningServer != nullptr)
+    {
+        runningServer->stop();
+    }
+}
+
+//! @brief load a dictionary from a snapshot written by ZDDictionary::save, or from a lexico text file
+//! @param path the path of the file
+//! @param dictionary the loaded dictionary
+//! @return true if succes, false otherwise
+static bool load_dictionary(const string& path, ZDDictionary& dictionary)
+{
+    if (dictionary.load(path))
+    {
+        return true;
+    }
+
+    Lexico lexicoBase;
+    if (!lexicoBase.read(path))
+    {
+        return false;
+    }
+
+    const auto& words = lexicoBase.getWords();
+    const auto& weights = lexicoBase.getWeights();
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        dictionary.insert_word(words[i], weights[i]);
+    }
+    return true;
+}
+
+//! @brief This this the dictionary server app : DictionaryServer <socket path> <dictionary or lexico file> [trace file]
+//! @param argc
+//! @param argv
+//! @return return 0 if succes
+int main(int argc, char* argv[])
+{
+    const string socketPath = (argc > 1) ? argv[1] : "/tmp/dictionary.sock";
+    const string dictionaryPath = (argc > 2) ? argv[2] : "./Lexico.txt";
+    const string tracePath = (argc > 3) ? argv[3] : "";
+
+    ZDDictionary dictionary;
+    if (!load_dictionary(dictionaryPath, dictionary))
+    {
+        std::cout << "Errro reading dictionary " << dictionaryPath << std::endl;
+        return 1;
+    }
+    std::cout << "number of words is " << dictionary.word_count() << std::endl;
+
+    ZDServer server(dictionary);
+    if (!server.listen(socketPath))
+    {
+        std::cout << "Errro listening on " << socketPath << std::endl;
+        return 1;
+    }
+
+    //optional capture of the requests, for DictionaryReplay
+    ZDTraceWriter trace;
+    if (!tracePath.empty())
+    {
+        if (!trace.open(tracePath))
+        {
+            std::cout << "Errro writing trace " << tracePath << std::endl;
+            return 1;
+        }
+        server.set_trace(&trace);
+    }
+
+    runningServer = &server;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    std::cout << "listening on " << socketPath << std::endl;
+    const bool result = server.run();
+    runningServer = nullptr;
+
+    if (trace.is_open())
+    {
+        std::cout << "requests captured : " << trace.record_count() << std::endl;
+        trace.close();
+    }
+
+    return result ? 0 : 1;
+}
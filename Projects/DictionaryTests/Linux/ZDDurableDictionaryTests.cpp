@@ -0,0 +1,168 @@
+#include <filesystem>
+#include <thread>
+#include <random>
+#include <csignal>
+#include <sys/resource.h>
+#include "ZDTest.h"
+#include "Persistence/ZDDurableDictionary.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get an empty directory for the files of a durable dictionary
+    std::string empty_directory(const std::string& name)
+    {
+        const std::string path = Test::temporary_path(name);
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+        return path;
+    }
+
+    bool durable_has(const ZDDurableDictionary& dictionary, const std::string& word)
+    {
+        return dictionary.read([&word](const ZDDictionary& read) { return read.find_word(word); });
+    }
+}
+
+ZD_TEST(durable_dictionary_reopen)
+{
+    const std::string directory = empty_directory("durable");
+    ZDDictionary base;
+    base.insert_word("base");
+    {
+        ZDDurableDictionary dictionary;
+        ZD_CHECK(dictionary.open(directory, base));
+        ZD_CHECK(dictionary.insert_word("ajout", 4));
+        ZD_CHECK(dictionary.remove_word("base"));
+        ZD_CHECK(!dictionary.remove_word("absent"));
+        ZD_CHECK(dictionary.compact());
+        ZD_CHECK(dictionary.insert_word("apres"));
+    }
+
+    ZDDurableDictionary dictionary;
+    ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+    ZD_CHECK(durable_has(dictionary, "ajout") && durable_has(dictionary, "apres"));
+    ZD_CHECK(!durable_has(dictionary, "base"));
+    ZD_CHECK(dictionary.read([](const ZDDictionary& read) { return read.word_weight("ajout"); }) == std::make_tuple(true, 4u));
+    dictionary.close();
+    std::filesystem::remove_all(directory);
+}
+
+ZD_TEST(durable_dictionary_long_word)
+{
+    //a word the log can not hold is refused, rather than replayed cut after a restart
+    ZDChange change;
+    change.word.assign(ZDWriteAheadLog::max_word, 'a');
+    ZD_CHECK(ZDWriteAheadLog::accepts(change));
+    change.word.push_back('a');
+    ZD_CHECK(!ZDWriteAheadLog::accepts(change));
+
+    const std::string directory = empty_directory("long");
+    const std::string word(1000, 'a');
+    {
+        ZDDurableDictionary dictionary;
+        ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+        ZD_CHECK(!dictionary.insert_word(change.word));
+        ZD_CHECK(dictionary.read([](const ZDDictionary& read) { return read.word_count(); }) == 0);
+        ZD_CHECK(dictionary.insert_word(word));
+    }
+
+    ZDDurableDictionary dictionary;
+    ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+    ZD_CHECK(durable_has(dictionary, word));
+    ZD_CHECK(dictionary.read([](const ZDDictionary& read) { return read.word_count(); }) == 1);
+    dictionary.close();
+    std::filesystem::remove_all(directory);
+}
+
+ZD_TEST(durable_dictionary_log_failure)
+{
+    //a change which can not be logged is refused and never applied : the dictionary is the one found on reopen
+    const std::string directory = empty_directory("failure");
+    {
+        ZDDurableDictionary dictionary;
+        ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+        ZD_CHECK(dictionary.insert_word("avant"));
+
+        //the log can not grow anymore : its writes fail instead of raising SIGXFSZ
+        const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit limit;
+        ::getrlimit(RLIMIT_FSIZE, &limit);
+        const rlimit previous = limit;
+        limit.rlim_cur = static_cast<rlim_t>(std::filesystem::file_size(directory + "/log.0"));
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+
+        ZD_CHECK(!dictionary.insert_word("refuse"));
+        ZD_CHECK(!durable_has(dictionary, "refuse"));
+        ZD_CHECK(!dictionary.remove_word("avant"));
+        ZD_CHECK(durable_has(dictionary, "avant"));
+
+        ::setrlimit(RLIMIT_FSIZE, &previous);
+        std::signal(SIGXFSZ, handler);
+    }
+
+    ZDDurableDictionary dictionary;
+    ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+    ZD_CHECK(durable_has(dictionary, "avant"));
+    ZD_CHECK(!durable_has(dictionary, "refuse"));
+    ZD_CHECK(dictionary.insert_word("ensuite"));
+    ZD_CHECK(durable_has(dictionary, "ensuite"));
+    dictionary.close();
+    std::filesystem::remove_all(directory);
+}
+
+ZD_TEST(durable_dictionary_concurrent_changes)
+{
+    //changes of the same words from several threads : the log replays them in the order they were applied
+    const std::string directory = empty_directory("concurrent");
+    std::vector<std::string> words;
+    {
+        ZDDurableDictionary dictionary;
+        ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+        std::vector<std::thread> writers;
+        for (unsigned writer = 0; writer < 4; ++writer)
+        {
+            writers.emplace_back([&dictionary, writer]()
+            {
+                std::mt19937 random(writer);
+                for (const auto& word : Test::random_words(random, 300, 2, "abc"))
+                {
+                    if (random() % 2 == 0)
+                    {
+                        dictionary.insert_word(word, random() % 10);
+                    }
+                    else
+                    {
+                        dictionary.remove_word(word);
+                    }
+                }
+            });
+        }
+        for (auto& writer : writers)
+        {
+            writer.join();
+        }
+        dictionary.read([&words](const ZDDictionary& read)
+        {
+            read.for_each_word([&words](const std::string& word, uint32_t, uint32_t weight)
+            {
+                words.push_back(word + ":" + std::to_string(weight));
+            });
+        });
+    }
+
+    ZDDurableDictionary dictionary;
+    ZD_CHECK(dictionary.open(directory, ZDDictionary()));
+    std::vector<std::string> reopened;
+    dictionary.read([&reopened](const ZDDictionary& read)
+    {
+        read.for_each_word([&reopened](const std::string& word, uint32_t, uint32_t weight)
+        {
+            reopened.push_back(word + ":" + std::to_string(weight));
+        });
+    });
+    ZD_CHECK(reopened == words);
+    dictionary.close();
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,134 @@
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <cstdio>
+#include "ZDTest.h"
+#include "Update/ZDLiveDictionary.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief wait for a condition, set by the thread of the file watcher
+    //! @return true if the condition became true within a few seconds
+    bool eventually(const std::function<bool()>& condition)
+    {
+        for (int attempt = 0; attempt < 500; ++attempt)
+        {
+            if (condition())
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return condition();
+    }
+
+    bool live_has(const ZDLiveDictionary& live, const std::string& word)
+    {
+        return live.snapshot()->find_word(word);
+    }
+
+    void append_file(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << text;
+    }
+
+    ZDDelta read_delta(const std::string& text)
+    {
+        ZDDelta delta;
+        std::istringstream in(text);
+        delta.read(in);
+        return delta;
+    }
+}
+
+ZD_TEST(live_dictionary_apply)
+{
+    ZDDictionary initial;
+    initial.insert_word("maison", 3);
+    initial.insert_word("chat");
+    ZDLiveDictionary live(initial);
+
+    //each update goes to both copies : after two updates the current copy has seen both
+    ZD_CHECK(live.apply(read_delta("+chien\t7\n-chat\n-absent\n")) == 2);
+    ZD_CHECK(live.apply(read_delta("+oiseau\n")) == 1);
+    for (int round = 0; round < 2; ++round)
+    {
+        {
+            const ZDLiveDictionary::Snapshot snapshot = live.snapshot();
+            ZD_CHECK(snapshot->find_word("chien") && snapshot->find_word("oiseau") && snapshot->find_word("maison"));
+            ZD_CHECK(!snapshot->find_word("chat"));
+            ZD_CHECK(snapshot->word_weight("chien") == std::make_tuple(true, 7u));
+            ZD_CHECK(snapshot->word_count() == 3);
+        }
+        //the snapshot is released first, the update waits for its readers
+        live.optimize();
+    }
+    ZD_CHECK(live.version() == 4);
+
+    //a snapshot is left unchanged by the updates made after it is taken
+    ZDLiveDictionary::Snapshot before = live.snapshot();
+    std::thread updater([&live]() { live.apply(read_delta("+tortue\n")); });
+    ZD_CHECK(!before->find_word("tortue"));
+    ZD_CHECK(before->word_count() == 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    before.reset();
+    updater.join();
+    ZD_CHECK(live_has(live, "tortue"));
+}
+
+ZD_TEST(live_dictionary_watch_appended)
+{
+    const std::string path = Test::temporary_path("live.delta");
+    std::remove(path.c_str());
+    std::ofstream(path) << "+bonjour\n";
+
+    ZDLiveDictionary live(ZDDictionary{});
+    ZD_CHECK(live.watch(path));
+    ZD_CHECK(live_has(live, "bonjour"));
+
+    //the appended lines only, a line without its end waiting for it
+    append_file(path, "+salut\n-bonjour\n+partiel");
+    ZD_CHECK(eventually([&]() { return live_has(live, "salut") && !live_has(live, "bonjour"); }));
+    ZD_CHECK(!live_has(live, "partiel"));
+    append_file(path, "lement\n");
+    ZD_CHECK(eventually([&]() { return live_has(live, "partiellement"); }));
+    ZD_CHECK(!live_has(live, "partiel"));
+
+    //a replaced file is applied again from its start
+    const std::string replacement = path + ".new";
+    std::ofstream(replacement) << "+remplace\n";
+    std::rename(replacement.c_str(), path.c_str());
+    ZD_CHECK(eventually([&]() { return live_has(live, "remplace"); }));
+
+    live.unwatch();
+    std::remove(path.c_str());
+}
+
+ZD_TEST(live_dictionary_watch_bad_line)
+{
+    //a malformed line is skipped : the lines around it, and the ones appended later, are applied
+    const std::string path = Test::temporary_path("bad.delta");
+    std::remove(path.c_str());
+    std::ofstream(path) << "+avant\nmalformed\n+apres\n";
+
+    ZDLiveDictionary live(ZDDictionary{});
+    ZD_CHECK(live.watch(path));
+    ZD_CHECK(live_has(live, "avant") && live_has(live, "apres"));
+    ZD_CHECK(live.rejected_lines() == 1);
+
+    append_file(path, "+\n+ensuite\n");
+    ZD_CHECK(eventually([&]() { return live_has(live, "ensuite"); }));
+    ZD_CHECK(live.rejected_lines() == 2);
+
+    append_file(path, "-avant\n");
+    ZD_CHECK(eventually([&]() { return !live_has(live, "avant"); }));
+    ZD_CHECK(live.rejected_lines() == 2);
+
+    live.unwatch();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,218 @@
+#include <fstream>
+#include <random>
+#include <cstdio>
+#include "ZDTest.h"
+#include "Persistence/ZDWriteAheadLog.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get random changes of every kind
+    std::vector<ZDChange> random_changes(std::mt19937& random, std::size_t count)
+    {
+        std::vector<ZDChange> result;
+        for (const auto& word : Test::random_words(random, count, 20, "abcdefgh"))
+        {
+            ZDChange change;
+            change.insert = random() % 3 != 0;
+            change.weighted = change.insert && random() % 2 == 0;
+            change.weight = change.weighted ? static_cast<uint32_t>(random()) : 0;
+            change.word = word;
+            result.push_back(change);
+        }
+        return result;
+    }
+
+    bool same(const ZDChange& a, const ZDChange& b)
+    {
+        return a.insert == b.insert && a.weighted == b.weighted && a.weight == b.weight && a.word == b.word;
+    }
+
+    //! @brief read the changes of a log file
+    //! @return true if the file was read and holds the given changes
+    bool replays(const std::string& path, const std::vector<ZDChange>& expected, uint64_t& end)
+    {
+        std::vector<ZDChange> found;
+        if (!ZDWriteAheadLog::replay(path, [&found](const ZDChange& change) { found.push_back(change); }, end))
+        {
+            return false;
+        }
+        return found.size() == expected.size() && std::equal(found.begin(), found.end(), expected.begin(), same);
+    }
+
+    //! @brief write changes to a log file, durable on return
+    bool write_changes(const std::string& path, const std::vector<ZDChange>& changes)
+    {
+        ZDWriteAheadLog log;
+        if (!log.open(path))
+        {
+            return false;
+        }
+        for (const auto& change : changes)
+        {
+            log.append(change);
+        }
+        return log.sync();
+    }
+
+    std::string read_file(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void write_file(const std::string& path, const std::string& content)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+}
+
+ZD_TEST(write_ahead_log_replays_changes)
+{
+    std::mt19937 random(36);
+    const std::string path = Test::temporary_path("replay.wal");
+    std::remove(path.c_str());
+
+    const auto changes = random_changes(random, 500);
+    ZD_CHECK(write_changes(path, std::vector<ZDChange>(changes.begin(), changes.begin() + 200)));
+    ZD_CHECK(write_changes(path, std::vector<ZDChange>(changes.begin() + 200, changes.end())));
+
+    uint64_t end = 0;
+    ZD_CHECK(replays(path, changes, end));
+    ZD_CHECK(end == read_file(path).size());
+    std::remove(path.c_str());
+}
+
+ZD_TEST(write_ahead_log_torn_tail)
+{
+    //a crash leaves part of the last record, or garbage : replay stops before it, and open cuts it off so that
+    //the next records follow the last whole one
+    std::mt19937 random(136);
+    const std::string path = Test::temporary_path("torn.wal");
+    const auto changes = random_changes(random, 30);
+    std::remove(path.c_str());
+    ZD_CHECK(write_changes(path, changes));
+    const std::string whole = read_file(path);
+
+    //the last record : uint32 size, uint32 CRC, then the kind, the weight and the word
+    const std::vector<ZDChange> before(changes.begin(), changes.end() - 1);
+    const std::size_t lastStart = whole.size() - (4 + 4 + 5 + changes.back().word.size());
+    uint64_t end = 0;
+
+    for (std::size_t size = lastStart + 1; size < whole.size(); ++size)
+    {
+        write_file(path, whole.substr(0, size));
+        ZD_CHECK(replays(path, before, end));
+        ZD_CHECK(end == lastStart);
+    }
+
+    for (int round = 0; round < 50; ++round)
+    {
+        std::string garbage(1 + random() % 40, ' ');
+        for (auto& c : garbage)
+        {
+            c = static_cast<char>(random());
+        }
+        write_file(path, whole + garbage);
+        ZD_CHECK(replays(path, changes, end));
+        ZD_CHECK(end == whole.size());
+    }
+
+    //reopened, the garbage is cut off and the new records are read after the old ones
+    const auto more = random_changes(random, 10);
+    ZD_CHECK(write_changes(path, more));
+    std::vector<ZDChange> all = changes;
+    all.insert(all.end(), more.begin(), more.end());
+    ZD_CHECK(replays(path, all, end));
+    ZD_CHECK(end == read_file(path).size());
+    std::remove(path.c_str());
+}
+
+ZD_TEST(write_ahead_log_corrupt_record)
+{
+    //a record whose CRC does not match ends the log
+    std::mt19937 random(236);
+    const std::string path = Test::temporary_path("corrupt.wal");
+    const auto changes = random_changes(random, 20);
+    std::remove(path.c_str());
+    ZD_CHECK(write_changes(path, changes));
+    const std::string whole = read_file(path);
+
+    for (int round = 0; round < 200; ++round)
+    {
+        std::string damaged = whole;
+        const std::size_t at = 8 + random() % (whole.size() - 8);
+        damaged[at] ^= static_cast<char>(1 << (random() % 8));
+        write_file(path, damaged);
+
+        std::vector<ZDChange> found;
+        uint64_t end = 0;
+        ZD_CHECK(ZDWriteAheadLog::replay(path, [&found](const ZDChange& change) { found.push_back(change); }, end));
+        ZD_CHECK(end <= at);
+        ZD_CHECK(found.size() < changes.size());
+        ZD_CHECK(std::equal(found.begin(), found.end(), changes.begin(), same));
+    }
+    std::remove(path.c_str());
+}
+
+ZD_TEST(write_ahead_log_torn_header)
+{
+    //a file shorter than the header was cut before its header was written : it is started again
+    const std::string path = Test::temporary_path("header.wal");
+    std::mt19937 random(336);
+    const auto changes = random_changes(random, 5);
+    std::remove(path.c_str());
+    ZD_CHECK(write_changes(path, changes));
+    const std::string whole = read_file(path);
+
+    for (std::size_t size = 0; size < 8; ++size)
+    {
+        write_file(path, whole.substr(0, size));
+        uint64_t end = 0;
+        ZD_CHECK(!ZDWriteAheadLog::replay(path, [](const ZDChange&) {}, end));
+        ZD_CHECK(write_changes(path, changes));
+        ZD_CHECK(replays(path, changes, end));
+    }
+
+    //a damaged header is not taken for an empty log
+    std::string damaged = whole;
+    damaged[0] = 'X';
+    write_file(path, damaged);
+    ZDWriteAheadLog log;
+    ZD_CHECK(!log.open(path));
+    ZD_CHECK(read_file(path) == damaged);
+    std::remove(path.c_str());
+}
+
+ZD_TEST(write_ahead_log_rotate)
+{
+    std::mt19937 random(436);
+    const std::string first = Test::temporary_path("first.wal");
+    const std::string second = Test::temporary_path("second.wal");
+    const auto changes = random_changes(random, 100);
+    std::remove(first.c_str());
+
+    {
+        ZDWriteAheadLog log;
+        ZD_CHECK(log.open(first));
+        for (std::size_t i = 0; i < 60; ++i)
+        {
+            log.append(changes[i]);
+        }
+        ZD_CHECK(log.rotate(second));
+        for (std::size_t i = 60; i < changes.size(); ++i)
+        {
+            log.append(changes[i]);
+        }
+        ZD_CHECK(log.sync());
+        ZD_CHECK(log.size() == read_file(second).size());
+    }
+
+    uint64_t end = 0;
+    ZD_CHECK(replays(first, std::vector<ZDChange>(changes.begin(), changes.begin() + 60), end));
+    ZD_CHECK(replays(second, std::vector<ZDChange>(changes.begin() + 60, changes.end()), end));
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
@@ -0,0 +1,56 @@
+#include "ZDWordSetTests.h"
+#include "Radix/ZDAdaptiveRadixTree.h"
+
+using namespace Dico;
+
+ZD_TEST(adaptive_radix_tree_matches_set)
+{
+    for (unsigned seed = 40; seed < 43; ++seed)
+    {
+        Test::check_word_tree<ZDAdaptiveRadixTree>(seed);
+    }
+}
+
+ZD_TEST(adaptive_radix_tree_node_layouts)
+{
+    //one inner node through every layout, growing then shrinking
+    ZDAdaptiveRadixTree tree;
+    std::vector<std::string> words;
+    for (int byte = 0x21; byte < 0x7F; ++byte)
+    {
+        if (byte < 'A' || byte > 'Z')
+        {
+            words.push_back(std::string("x") + static_cast<char>(byte));
+        }
+    }
+    for (const auto& word : words)
+    {
+        ZD_CHECK(tree.insert_word(word));
+    }
+    ZD_CHECK(tree.statistics().node256 == 1);
+    ZD_CHECK(tree.find_prefix("x") == std::vector<std::string>(words.begin(), words.end()));
+
+    while (words.size() > 1)
+    {
+        ZD_CHECK(tree.remove_word(words.back()));
+        words.pop_back();
+        ZD_CHECK(tree.find_prefix("x") == words);
+    }
+    const auto statistics = tree.statistics();
+    ZD_CHECK(statistics.node4 + statistics.node16 + statistics.node48 + statistics.node256 == 0);
+    ZD_CHECK(tree.find_word(words.front()));
+}
+
+ZD_TEST(adaptive_radix_tree_long_prefix)
+{
+    //prefixes longer than the part stored in the nodes are read from a leaf
+    ZDAdaptiveRadixTree tree;
+    const std::string stem(40, 'q');
+    tree.build({ stem + "a", stem + "b", stem, "q" });
+    ZD_CHECK(tree.word_count() == 4);
+    ZD_CHECK(tree.find_word(stem));
+    ZD_CHECK(!tree.find_word(stem.substr(1)));
+    ZD_CHECK(!tree.find_word(stem.substr(0, 20) + "r" + stem.substr(21)));
+    ZD_CHECK(tree.find_prefix(stem.substr(0, 30)).size() == 3);
+    ZD_CHECK(tree.find_prefix(stem + "a") == std::vector<std::string>{ stem + "a" });
+}
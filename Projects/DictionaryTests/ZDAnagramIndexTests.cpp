@@ -0,0 +1,87 @@
+#include <set>
+#include <random>
+#include "ZDTest.h"
+#include "Index/ZDAnagramIndex.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief count the bytes of a word
+    std::vector<int> byte_counts(const std::string& word)
+    {
+        std::vector<int> counts(256, 0);
+        for (const char c : word)
+        {
+            ++counts[static_cast<unsigned char>(c)];
+        }
+        return counts;
+    }
+
+    //! @brief get the words of a set made of the letters of a rack, compared one by one
+    //! @param exact true for the anagrams, false for the sub-anagrams
+    std::vector<std::string> reference_anagrams(const std::set<std::string>& words, const std::string& rack, bool exact, std::size_t min_size)
+    {
+        const std::vector<int> available = byte_counts(rack);
+        const int blanks = available[static_cast<unsigned char>(ZDAnagramIndex::blank)];
+        std::vector<std::string> result;
+        for (const auto& word : words)
+        {
+            const std::vector<int> needed = byte_counts(word);
+            int missing = 0;
+            for (std::size_t c = 0; c < 256; ++c)
+            {
+                missing += (c == static_cast<unsigned char>(ZDAnagramIndex::blank)) ? needed[c] : std::max(0, needed[c] - available[c]);
+            }
+            const bool found = exact ? (needed == available) : (word.size() >= min_size && missing <= blanks);
+            if (found)
+            {
+                result.push_back(word);
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::string> sorted(std::vector<std::string> words)
+    {
+        std::sort(words.begin(), words.end());
+        return words;
+    }
+}
+
+ZD_TEST(anagram_index_matches_brute_force)
+{
+    //accented letters in Latin-1 and in UTF-8, whose bytes sort after the plain letters
+    std::mt19937 random(29);
+    const std::string alphabet = "abcde\xE0\xE9\xE8\xC3\xA9";
+    const auto words = Test::random_words(random, 3000, 6, alphabet);
+    const std::set<std::string> reference(words.begin(), words.end());
+
+    ZDAnagramIndex index;
+    index.build(words);
+    ZD_CHECK(index.word_count() == reference.size());
+
+    //every word is an anagram of itself
+    for (const auto& word : reference)
+    {
+        const auto found = index.find_anagrams(word);
+        ZD_CHECK(std::find(found.begin(), found.end(), word) != found.end());
+    }
+
+    for (const auto& rack : Test::random_words(random, 300, 7, alphabet + "??"))
+    {
+        ZD_CHECK(sorted(index.find_anagrams(rack)) == reference_anagrams(reference, rack, true, 0));
+        const std::size_t min_size = 1 + random() % 3;
+        ZD_CHECK(sorted(index.find_sub_anagrams(rack, min_size)) == reference_anagrams(reference, rack, false, min_size));
+    }
+}
+
+ZD_TEST(anagram_index_accents)
+{
+    ZDAnagramIndex index;
+    index.build({ "\xE9t\xE9", "ab", "\xE0", "ba" });
+    ZD_CHECK(sorted(index.find_anagrams("ab")) == (std::vector<std::string>{ "ab", "ba" }));
+    ZD_CHECK(index.find_anagrams("\xE0") == std::vector<std::string>{ "\xE0" });
+    ZD_CHECK(index.find_anagrams("\xE9\xE9t") == std::vector<std::string>{ "\xE9t\xE9" });
+    ZD_CHECK(sorted(index.find_sub_anagrams("\xE0" "ab?")) == (std::vector<std::string>{ "ab", "ba", "\xE0" }));
+}
@@ -0,0 +1,314 @@
+#include <map>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief convert the ASCII letters of a word to lower case, the other chars are kept
+    std::string lower_case(std::string word)
+    {
+        std::transform(word.begin(), word.end(), word.begin(), [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; });
+        return word;
+    }
+
+    //! @brief get a word as the dictionary stores it : in lower case, the leading chars which are not a root skipped
+    std::string stored_word(const std::string& given)
+    {
+        const std::string word = lower_case(given);
+        const std::size_t root = word.find_first_of("abcdefghijklmnopqrstuvwxyz");
+        return (root == std::string::npos) ? std::string() : word.substr(root);
+    }
+
+    //! @brief fill a dictionary and its reference, a map of the stored words to their weights, with random words
+    //! of few distinct weights so that many weights are equal; a word inserted twice keeps its last weight
+    void fill(std::mt19937& random, std::size_t count, ZDDictionary& dictionary, std::map<std::string, uint32_t>& reference)
+    {
+        for (const auto& word : Test::random_words(random, count, 8, "abcdE\xC3\xA9"))
+        {
+            const uint32_t weight = random() % 12;
+            const bool inserted = dictionary.insert_word(word, weight);
+            ZD_CHECK(inserted == !stored_word(word).empty());
+            if (inserted)
+            {
+                reference[stored_word(word)] = weight;
+            }
+        }
+    }
+
+    //! @brief get the weights of the words of a reference accepted by a filter, by decreasing weight
+    template<class Filter>
+    std::vector<uint32_t> reference_weights(const std::map<std::string, uint32_t>& reference, Filter filter)
+    {
+        std::vector<uint32_t> result;
+        for (const auto& word : reference)
+        {
+            if (filter(word.first))
+            {
+                result.push_back(word.second);
+            }
+        }
+        std::sort(result.begin(), result.end(), std::greater<uint32_t>());
+        return result;
+    }
+}
+
+ZD_TEST(dictionary_complete_top_k)
+{
+    std::mt19937 random(32);
+    ZDDictionary dictionary;
+    std::map<std::string, uint32_t> reference;
+    fill(random, 4000, dictionary, reference);
+
+    for (const auto& prefix : Test::random_words(random, 200, 3, "abcdE"))
+    {
+        const std::string key = stored_word(prefix);
+        const std::vector<uint32_t> weights = reference_weights(reference, [&key](const std::string& word)
+        {
+            return word.compare(0, key.size(), key) == 0;
+        });
+
+        //the k best words : the weights of the k first ones, words of equal weight coming in any order
+        for (const std::size_t count : { std::size_t(1), std::size_t(7), std::size_t(40), weights.size() + 1 })
+        {
+            const auto completed = dictionary.complete(prefix, count);
+            ZD_CHECK(completed.size() == std::min(count, weights.size()));
+            std::vector<std::string> words;
+            for (std::size_t i = 0; i < completed.size(); ++i)
+            {
+                ZD_CHECK(completed[i].second == weights[i]);
+                ZD_CHECK(completed[i].first.compare(0, key.size(), key) == 0);
+                ZD_CHECK(reference.count(completed[i].first) == 1 && reference.at(completed[i].first) == completed[i].second);
+                words.push_back(completed[i].first);
+            }
+            std::sort(words.begin(), words.end());
+            ZD_CHECK(std::adjacent_find(words.begin(), words.end()) == words.end());
+        }
+    }
+    ZD_CHECK(dictionary.complete("", 0).empty());
+    ZD_CHECK(dictionary.complete("zzz", 5).empty());
+}
+
+ZD_TEST(dictionary_suggest_top_k)
+{
+    std::mt19937 random(132);
+    ZDDictionary dictionary;
+    std::map<std::string, uint32_t> reference;
+    fill(random, 3000, dictionary, reference);
+
+    //a few words longer than the bit-vector row, suggested by the full search
+    for (int i = 0; i < 20; ++i)
+    {
+        const std::string word = Test::random_words(random, 1, 1, "ab")[0] + std::string(70, 'c') + Test::random_words(random, 1, 3, "ab")[0];
+        dictionary.insert_word(word, i % 4);
+        reference[word] = i % 4;
+    }
+
+    auto queries = Test::random_words(random, 150, 8, "abcdE\xC3\xA9");
+    for (int i = 0; i < 10; ++i)
+    {
+        queries.push_back("a" + std::string(70, 'c') + Test::random_words(random, 1, 3, "abc")[0]);
+    }
+    for (const auto& query : queries)
+    {
+        //the distance is to the whole query, its leading chars included
+        const std::string lower = lower_case(query);
+        const int max_error = static_cast<int>(random() % 3);
+        const std::vector<uint32_t> weights = reference_weights(reference, [&](const std::string& word)
+        {
+            return Test::reference_distance(lower, word) <= max_error;
+        });
+        for (const std::size_t count : { std::size_t(1), std::size_t(5), weights.size() + 1 })
+        {
+            const auto suggested = dictionary.suggest(query, max_error, count);
+            ZD_CHECK(suggested.size() == std::min(count, weights.size()));
+            std::vector<std::string> words;
+            for (std::size_t i = 0; i < suggested.size(); ++i)
+            {
+                const std::string& word = std::get<std::string>(suggested[i]);
+                ZD_CHECK(std::get<uint32_t>(suggested[i]) == weights[i]);
+                ZD_CHECK(std::get<int>(suggested[i]) == Test::reference_distance(lower, word));
+                ZD_CHECK(reference.count(word) == 1 && reference.at(word) == weights[i]);
+                words.push_back(word);
+            }
+            std::sort(words.begin(), words.end());
+            ZD_CHECK(std::adjacent_find(words.begin(), words.end()) == words.end());
+        }
+    }
+    ZD_CHECK(dictionary.suggest("abc", -1, 5).empty());
+}
+
+ZD_TEST(dictionary_rank_select_round_trip)
+{
+    std::mt19937 random(42);
+    ZDDictionary dictionary;
+    std::map<std::string, uint32_t> reference;
+    fill(random, 3000, dictionary, reference);
+
+    //removals leave subtrees whose counts must drop
+    for (const auto& word : Test::random_words(random, 1500, 8, "abcdE\xC3\xA9"))
+    {
+        ZD_CHECK(dictionary.remove_word(word) == (reference.erase(stored_word(word)) == 1));
+    }
+    const std::vector<std::string> words = [&reference]()
+    {
+        std::vector<std::string> result;
+        for (const auto& word : reference)
+        {
+            result.push_back(word.first);
+        }
+        return result;
+    }();
+    ZD_CHECK(dictionary.word_count() == words.size());
+
+    //select and rank are the reverse of each other over the words, in alphabetical order
+    for (std::size_t index = 0; index < words.size(); ++index)
+    {
+        ZD_CHECK(dictionary.select(index) == words[index]);
+        ZD_CHECK(dictionary.rank(words[index]) == index);
+    }
+    ZD_CHECK(dictionary.select(words.size()).empty());
+
+    //a word not in the dictionary is ranked where it would be inserted
+    for (const auto& query : Test::random_words(random, 500, 9, "abcdeE"))
+    {
+        const std::string key = stored_word(query);
+        ZD_CHECK(dictionary.rank(query) == static_cast<std::size_t>(std::lower_bound(words.begin(), words.end(), key) - words.begin()));
+    }
+
+    for (const auto& prefix : Test::random_words(random, 200, 4, "abcdE"))
+    {
+        const std::string key = stored_word(prefix);
+        const auto first = std::lower_bound(words.begin(), words.end(), key);
+        const auto last = std::find_if(first, words.end(), [&key](const std::string& word) { return word.compare(0, key.size(), key) != 0; });
+        const std::size_t count = static_cast<std::size_t>(last - first);
+        ZD_CHECK(dictionary.count_prefix(prefix) == count);
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            ZD_CHECK(dictionary.select(index, prefix) == *(first + index));
+        }
+        ZD_CHECK(dictionary.select(count, prefix).empty());
+
+        //every word of a small prefix is drawn
+        if (count != 0 && count <= 8)
+        {
+            std::vector<std::string> drawn;
+            for (int draw = 0; draw < 400; ++draw)
+            {
+                drawn.push_back(dictionary.sample(prefix, random));
+            }
+            std::sort(drawn.begin(), drawn.end());
+            drawn.erase(std::unique(drawn.begin(), drawn.end()), drawn.end());
+            ZD_CHECK(drawn == std::vector<std::string>(first, last));
+        }
+        else if (count == 0)
+        {
+            ZD_CHECK(dictionary.sample(prefix, random).empty());
+        }
+    }
+    ZD_CHECK(dictionary.count_prefix("") == words.size());
+}
+
+namespace
+{
+    //! @brief check the lookups going through the jump table (find_node) against the reference, and against a
+    //! dictionary scanning the first two levels
+    void check_lookups(std::mt19937& random, const ZDDictionary& dictionary, const ZDDictionary& scanning, const std::map<std::string, uint32_t>& reference)
+    {
+        //leading chars which are not a root, and second chars out of the alphabet, the first levels of the table
+        auto queries = Test::random_words(random, 300, 4, "abcE\xC3\xA9-");
+        for (const auto& word : reference)
+        {
+            if (random() % 8 == 0)
+            {
+                queries.push_back(word.first);
+            }
+        }
+        for (const auto& query : queries)
+        {
+            const std::string key = stored_word(query);
+            const auto found = reference.find(key);
+            const bool present = !key.empty() && found != reference.end();
+            ZD_CHECK(dictionary.find_word(query) == present);
+            ZD_CHECK(dictionary.word_weight(query) == std::make_tuple(present, present ? found->second : 0u));
+            ZD_CHECK(std::get<bool>(dictionary.word_id(query)) == present);
+
+            std::size_t count = 0;
+            for (auto word = reference.lower_bound(key); !key.empty() && word != reference.end() && word->first.compare(0, key.size(), key) == 0; ++word)
+            {
+                ++count;
+            }
+            ZD_CHECK(dictionary.count_prefix(query) == count);
+
+            ZD_CHECK(scanning.find_word(query) == present);
+            ZD_CHECK(scanning.count_prefix(query) == dictionary.count_prefix(query));
+        }
+    }
+}
+
+ZD_TEST(dictionary_jump_table_follows_changes)
+{
+    std::mt19937 random(43);
+    ZDDictionary dictionary;
+    ZDDictionary scanning;
+    scanning.set_jump_table(false);
+    std::map<std::string, uint32_t> reference;
+
+    for (int round = 0; round < 6; ++round)
+    {
+        for (const auto& word : Test::random_words(random, 400, 5, "abcE\xC3\xA9"))
+        {
+            const uint32_t weight = random() % 50;
+            ZD_CHECK(dictionary.insert_word(word, weight) == scanning.insert_word(word, weight));
+            if (!stored_word(word).empty())
+            {
+                reference[stored_word(word)] = weight;
+            }
+        }
+        check_lookups(random, dictionary, scanning, reference);
+
+        //empty whole second levels, so that their entries of the table must be cleared, then some of the words
+        const std::string emptied = std::string(1, "abc"[random() % 3]) + "abcE\xC3"[random() % 5];
+        const std::string key = stored_word(emptied);
+        for (auto word = reference.lower_bound(key); word != reference.end() && word->first.compare(0, key.size(), key) == 0; )
+        {
+            ZD_CHECK(dictionary.remove_word(word->first));
+            ZD_CHECK(scanning.remove_word(word->first));
+            word = reference.erase(word);
+        }
+        ZD_CHECK(dictionary.count_prefix(emptied) == 0);
+        ZD_CHECK(!dictionary.find_word(emptied));
+        for (const auto& word : Test::random_words(random, 300, 5, "abcE\xC3\xA9"))
+        {
+            ZD_CHECK(dictionary.remove_word(word) == scanning.remove_word(word));
+            reference.erase(stored_word(word));
+        }
+        check_lookups(random, dictionary, scanning, reference);
+
+        //the nodes move : the table is built again
+        if (round % 2 == 0)
+        {
+            dictionary.optimize();
+        }
+        else
+        {
+            ZDDictionary copy;
+            ZD_CHECK(copy.merge(dictionary, ZDDictionary()));
+            std::stringstream buffer;
+            ZD_CHECK(copy.save(buffer));
+            ZD_CHECK(dictionary.load(buffer));
+        }
+        check_lookups(random, dictionary, scanning, reference);
+    }
+
+    //turned off then on, the table is built from the current tree
+    dictionary.set_jump_table(false);
+    check_lookups(random, dictionary, scanning, reference);
+    dictionary.set_jump_table(true);
+    check_lookups(random, dictionary, scanning, reference);
+}
@@ -0,0 +1,132 @@
+#include <random>
+#include "ZDTest.h"
+#include "Distance/ZDEditDistance.h"
+
+using namespace Dico;
+
+ZD_TEST(myers_distance_matches_dp)
+{
+    std::mt19937 random(26);
+    for (int round = 0; round < 2000; ++round)
+    {
+        const std::string pattern = Test::random_words(random, 1, ZDMyersPattern::max_size, "abcd")[0];
+        const std::string text = Test::random_words(random, 1, 80, "abcd")[0];
+        const ZDMyersPattern compiled(pattern);
+        const int expected = Test::reference_distance(pattern, text);
+
+        ZD_CHECK(compiled.distance(text) == expected);
+        for (int max_error = 0; max_error < 6; ++max_error)
+        {
+            ZD_CHECK(compiled.distance(text.data(), text.size(), max_error) == std::min(expected, max_error + 1));
+        }
+    }
+}
+
+ZD_TEST(myers_empty_words)
+{
+    ZD_CHECK(ZDMyersPattern(std::string()).distance("abc") == 3);
+    ZD_CHECK(ZDMyersPattern("abc").distance(std::string()) == 3);
+    ZD_CHECK(ZDMyersPattern(std::string()).distance(std::string()) == 0);
+    ZD_CHECK(ZDMyersPattern(std::string(64, 'a')).distance(std::string(64, 'b')) == 64);
+}
+
+ZD_TEST(myers_row_minimum_matches_dp)
+{
+    //the minimum of a row is the lowest distance between a prefix of the pattern and the text read so far
+    std::mt19937 random(126);
+    for (int round = 0; round < 500; ++round)
+    {
+        const std::string pattern = Test::random_words(random, 1, ZDMyersPattern::max_size, "abc")[0];
+        const std::string text = Test::random_words(random, 1, 40, "abc")[0];
+        const ZDMyersPattern compiled(pattern);
+        const auto d = Test::reference_matrix(pattern, text);
+
+        ZDMyersRow row = compiled.first_row();
+        for (std::size_t j = 1; j <= text.size(); ++j)
+        {
+            row = compiled.advance(row, text[j - 1]);
+            int lowest = d[0][j];
+            for (std::size_t i = 0; i <= pattern.size(); ++i)
+            {
+                lowest = std::min(lowest, d[i][j]);
+            }
+            ZD_CHECK(row.score == d[pattern.size()][j]);
+            ZD_CHECK(row.column == static_cast<int>(j));
+            for (int max_error = 0; max_error < 4; ++max_error)
+            {
+                ZD_CHECK(compiled.minimum(row, max_error) == std::min(lowest, max_error + 1));
+            }
+        }
+    }
+}
+
+ZD_TEST(levenshtein_distance_matches_dp)
+{
+    std::mt19937 random(226);
+    for (int round = 0; round < 500; ++round)
+    {
+        const std::string a = Test::random_words(random, 1, 100, "ab")[0];
+        const std::string b = Test::random_words(random, 1, 100, "ab")[0];
+        const int expected = Test::reference_distance(a, b);
+        ZD_CHECK(levenshtein_distance(a, b) == expected);
+        ZD_CHECK(levenshtein_distance(a, b, 3) == std::min(expected, 4));
+    }
+}
+
+ZD_TEST(myers_block_distance_matches_dp)
+{
+    std::mt19937 random(27);
+    for (int round = 0; round < 200; ++round)
+    {
+        //beyond 64 symbols, so that the carries go through several blocks
+        const std::size_t size = 65 + random() % (ZDMyersBlockPattern::max_size - 64);
+        const std::string pattern = Test::random_words(random, 1, size, "abc")[0];
+        const std::string text = Test::random_words(random, 1, 300, "abc")[0];
+        const ZDMyersBlockPattern compiled(pattern);
+        const int expected = Test::reference_distance(pattern, text);
+
+        ZD_CHECK(compiled.distance(text) == expected);
+        for (int max_error : { 0, 3, 40, 200 })
+        {
+            ZD_CHECK(compiled.distance(text.data(), text.size(), max_error) == std::min(expected, max_error + 1));
+        }
+    }
+}
+
+ZD_TEST(myers_block_close_words)
+{
+    //long words with a few edits, where the bounded distance stops late
+    std::mt19937 random(127);
+    for (int round = 0; round < 200; ++round)
+    {
+        const std::string pattern = Test::random_words(random, 1, ZDMyersBlockPattern::max_size, "abcdefgh")[0];
+        std::string text = pattern;
+        const int edits = static_cast<int>(random() % 5);
+        for (int edit = 0; edit < edits && !text.empty(); ++edit)
+        {
+            const std::size_t at = random() % text.size();
+            switch (random() % 3)
+            {
+            case 0: text.erase(at, 1); break;
+            case 1: text.insert(at, 1, 'z'); break;
+            default: text[at] = 'z'; break;
+            }
+        }
+        const ZDMyersBlockPattern compiled(pattern);
+        const int expected = Test::reference_distance(pattern, text);
+
+        ZD_CHECK(expected <= edits);
+        ZD_CHECK(compiled.distance(text) == expected);
+        ZD_CHECK(compiled.distance(text.data(), text.size(), 2) == std::min(expected, 3));
+    }
+}
+
+ZD_TEST(myers_block_full_size)
+{
+    const std::string pattern(ZDMyersBlockPattern::max_size, 'a');
+    const ZDMyersBlockPattern compiled(pattern);
+    ZD_CHECK(compiled.distance(pattern) == 0);
+    ZD_CHECK(compiled.distance(std::string()) == static_cast<int>(ZDMyersBlockPattern::max_size));
+    ZD_CHECK(compiled.distance(std::string(ZDMyersBlockPattern::max_size, 'b')) == static_cast<int>(ZDMyersBlockPattern::max_size));
+    ZD_CHECK(compiled.distance(pattern + "b") == 1);
+}
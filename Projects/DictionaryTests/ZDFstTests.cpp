@@ -0,0 +1,148 @@
+#include <map>
+#include <sstream>
+#include <random>
+#include "ZDTest.h"
+#include "Fst/ZDFst.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get random words with outputs of every size, from 0 to 64 bits
+    std::map<std::string, uint64_t> random_outputs(std::mt19937& random, std::size_t count)
+    {
+        std::mt19937_64 outputs(random());
+        std::map<std::string, uint64_t> result;
+        for (const auto& word : Test::random_words(random, count, 10, "abcdef"))
+        {
+            result[word] = outputs() >> (outputs() % 64);
+        }
+        return result;
+    }
+
+    //! @brief build a transducer from a map of outputs
+    ZDFst build(const std::map<std::string, uint64_t>& words)
+    {
+        return ZDFstBuilder::build(std::vector<std::pair<std::string, uint64_t>>(words.begin(), words.end()));
+    }
+
+    //! @brief get the words and outputs of a transducer, through for_each
+    std::vector<std::pair<std::string, uint64_t>> all_words(const ZDFst& fst)
+    {
+        std::vector<std::pair<std::string, uint64_t>> result;
+        fst.for_each([&](const std::string& word, uint64_t output)
+        {
+            result.emplace_back(word, output);
+        });
+        return result;
+    }
+}
+
+ZD_TEST(fst_outputs_match_map)
+{
+    std::mt19937 random(41);
+    for (int round = 0; round < 20; ++round)
+    {
+        const auto words = random_outputs(random, 1 + random() % 3000);
+        const ZDFst fst = build(words);
+
+        ZD_CHECK(fst.word_count() == words.size());
+        ZD_CHECK(all_words(fst) == std::vector<std::pair<std::string, uint64_t>>(words.begin(), words.end()));
+        for (const auto& word : words)
+        {
+            uint64_t output = 0;
+            ZD_CHECK(fst.find_word(word.first, output) && output == word.second);
+        }
+        for (const auto& word : Test::random_words(random, 500, 11, "abcdefg"))
+        {
+            ZD_CHECK(fst.find_word(word) == (words.count(word) == 1));
+        }
+    }
+}
+
+ZD_TEST(fst_builder_rejects_bad_words)
+{
+    ZDFstBuilder builder;
+    ZD_CHECK(!builder.add(std::string(), 1));
+    ZD_CHECK(builder.add("b", 1));
+    ZD_CHECK(!builder.add("a", 2));
+    ZD_CHECK(!builder.add("b", 3));
+    ZD_CHECK(!builder.add("c" + std::string(ZDFst::max_word, 'c'), 4));
+    ZD_CHECK(builder.add("C", 5));
+    const ZDFst fst = builder.finish();
+    ZD_CHECK(all_words(fst) == (std::vector<std::pair<std::string, uint64_t>>{ { "b", 1 }, { "c", 5 } }));
+
+    //the first output of a word given several times is kept
+    const ZDFst duplicates = ZDFstBuilder::build({ { "x", 7 }, { "X", 8 }, { "w", 0 } });
+    ZD_CHECK(all_words(duplicates) == (std::vector<std::pair<std::string, uint64_t>>{ { "w", 0 }, { "x", 7 } }));
+}
+
+ZD_TEST(fst_save_load)
+{
+    std::mt19937 random(141);
+    const auto words = random_outputs(random, 2000);
+    const ZDFst fst = build(words);
+
+    std::stringstream stream;
+    ZD_CHECK(fst.save(stream));
+    ZDFst loaded;
+    ZD_CHECK(loaded.load(stream));
+    ZD_CHECK(loaded.word_count() == words.size());
+    ZD_CHECK(all_words(loaded) == all_words(fst));
+
+    std::stringstream empty;
+    ZD_CHECK(ZDFst().save(empty));
+    ZD_CHECK(loaded.load(empty));
+    ZD_CHECK(loaded.word_count() == 0 && all_words(loaded).empty());
+}
+
+ZD_TEST(fst_corrupt_load)
+{
+    //a damaged file is either rejected or loads a transducer which can be walked safely, whose words are sorted
+    //and as many as it claims
+    std::mt19937 random(241);
+    const auto words = random_outputs(random, 300);
+    std::stringstream stream;
+    build(words).save(stream);
+    const std::string file = stream.str();
+
+    int loadedCount = 0;
+    for (int round = 0; round < 3000; ++round)
+    {
+        std::string damaged = file;
+        switch (round % 3)
+        {
+        case 0:
+            damaged.resize(random() % file.size());
+            break;
+        case 1:
+            for (int flip = 1 + random() % 3; flip > 0; --flip)
+            {
+                damaged[random() % damaged.size()] ^= static_cast<char>(1 << (random() % 8));
+            }
+            break;
+        default:
+            damaged[8 + random() % 16] = static_cast<char>(random());
+            break;
+        }
+
+        ZDFst fst;
+        std::istringstream in(damaged);
+        if (!fst.load(in))
+        {
+            ZD_CHECK(fst.word_count() == 0);
+            continue;
+        }
+        ++loadedCount;
+
+        const auto loaded = all_words(fst);
+        ZD_CHECK(loaded.size() == fst.word_count());
+        ZD_CHECK(std::is_sorted(loaded.begin(), loaded.end()));
+        for (const auto& word : words)
+        {
+            fst.find_word(word.first);
+        }
+    }
+    //changed outputs leave a valid transducer
+    ZD_CHECK(loadedCount != 0);
+}
@@ -0,0 +1,140 @@
+#include <random>
+#include <cctype>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Pattern/ZDPattern.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief match a word against a pattern by backtracking, the reference of the automaton
+    //! @param lower true to compare the literal chars of the pattern in lower case, as ZDDictionary::match does
+    bool reference_match(const std::string& pattern, std::size_t p, const std::string& word, std::size_t w, bool lower)
+    {
+        if (p == pattern.size())
+        {
+            return w == word.size();
+        }
+        if (pattern[p] == '*')
+        {
+            return reference_match(pattern, p + 1, word, w, lower) || (w < word.size() && reference_match(pattern, p, word, w + 1, lower));
+        }
+        if (w == word.size())
+        {
+            return false;
+        }
+        const unsigned char letter = static_cast<unsigned char>(word[w]);
+        if (pattern[p] == '?')
+        {
+            return reference_match(pattern, p + 1, word, w + 1, lower);
+        }
+        if (pattern[p] == '[')
+        {
+            std::size_t end = p + 1;
+            const bool negate = end < pattern.size() && pattern[end] == '^';
+            end += negate;
+            bool member = false;
+            for (std::size_t first = end; end < pattern.size() && (pattern[end] != ']' || end == first); )
+            {
+                const unsigned char low = static_cast<unsigned char>(pattern[end]);
+                const bool range = end + 2 < pattern.size() && pattern[end + 1] == '-' && pattern[end + 2] != ']';
+                const unsigned char high = range ? static_cast<unsigned char>(pattern[end + 2]) : low;
+                member = member || (letter >= low && letter <= high);
+                end += range ? 3 : 1;
+            }
+            return end < pattern.size() && member != negate && reference_match(pattern, end + 1, word, w + 1, lower);
+        }
+
+        std::size_t literal = p;
+        if (pattern[p] == '\\' && p + 1 < pattern.size())
+        {
+            ++literal;
+        }
+        const unsigned char expected = static_cast<unsigned char>(pattern[literal]);
+        return (lower ? ::tolower(expected) : expected) == letter && reference_match(pattern, literal + 1, word, w + 1, lower);
+    }
+
+    //! @brief get a random pattern made of literal chars in both cases, wildcards, escapes and classes
+    std::string random_pattern(std::mt19937& random)
+    {
+        static const char* elements[] = { "a", "b", "c", "d", "A", "C", "\xC3", "\xA9", "?", "*", "\\*", "\\?", "\\B", "\\[",
+            "[a-c]", "[^ab]", "[A-Z]", "[^A-Z]", "[]a]", "[^]b]", "[bD]", "[\xC3\xA9]", "[^\xC3]", "[-a]", "[a-]" };
+        std::string result;
+        for (std::size_t size = 1 + random() % 5; size > 0; --size)
+        {
+            result += elements[random() % (sizeof(elements) / sizeof(elements[0]))];
+        }
+        return result;
+    }
+
+    //! @brief get the words of a dictionary matching a pattern, sorted
+    std::vector<std::string> dictionary_matches(const ZDDictionary& dictionary, const std::string& pattern)
+    {
+        std::vector<std::string> result = dictionary.match(pattern).all();
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+ZD_TEST(pattern_matches_brute_force)
+{
+    std::mt19937 random(28);
+    for (int round = 0; round < 3; ++round)
+    {
+        ZDDictionary dictionary;
+        for (const auto& word : Test::random_words(random, 2000, 6, "abcd*?\xC3\xA9"))
+        {
+            dictionary.insert_word(word);
+        }
+        std::vector<std::string> words;
+        for (std::size_t index = 0; index < dictionary.word_count(); ++index)
+        {
+            words.push_back(dictionary.select(index));
+        }
+        std::sort(words.begin(), words.end());
+
+        for (int query = 0; query < 300; ++query)
+        {
+            const std::string pattern = random_pattern(random);
+            std::vector<std::string> reference;
+            for (const auto& word : words)
+            {
+                if (reference_match(pattern, 0, word, 0, true))
+                {
+                    reference.push_back(word);
+                }
+            }
+            ZD_CHECK(dictionary_matches(dictionary, pattern) == reference);
+
+            //the automaton alone compares every char as written
+            ZDPattern automaton(pattern);
+            ZD_CHECK(automaton.is_valid());
+            for (const auto& word : Test::random_words(random, 20, 6, "abcdABCD*?[]\xC3\xA9"))
+            {
+                ZD_CHECK(automaton.matches(word) == reference_match(pattern, 0, word, 0, false));
+            }
+        }
+    }
+}
+
+ZD_TEST(pattern_classes_keep_their_case)
+{
+    ZDDictionary dictionary;
+    for (const auto word : { "ab", "ac", "b", "abc" })
+    {
+        dictionary.insert_word(word);
+    }
+
+    //the words are in lower case : an upper case class matches none of them, its negation all of them
+    ZD_CHECK(dictionary_matches(dictionary, "A?") == std::vector<std::string>({ "ab", "ac" }));
+    ZD_CHECK(dictionary_matches(dictionary, "A[A-Z]").empty());
+    ZD_CHECK(dictionary_matches(dictionary, "A[^A-Z]") == std::vector<std::string>({ "ab", "ac" }));
+    ZD_CHECK(dictionary_matches(dictionary, "[^A-Z]*") == std::vector<std::string>({ "ab", "abc", "ac", "b" }));
+    ZD_CHECK(dictionary_matches(dictionary, "\\A[B]C").empty());
+    ZD_CHECK(dictionary_matches(dictionary, "\\A[b]C") == std::vector<std::string>({ "abc" }));
+
+    ZD_CHECK(ZDPattern::lower_case_literals("A[^A-Z]\\B[]C]D") == "a[^A-Z]\\b[]C]d");
+    ZD_CHECK(ZDPattern::lower_case_literals("A[^]B") == "a[^]B");
+    ZD_CHECK(!ZDPattern("[A-").is_valid());
+}
@@ -0,0 +1,126 @@
+#include <map>
+#include <set>
+#include <random>
+#include <algorithm>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Index/ZDPhoneticIndex.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get random French-like words : letters, accented letters and the groups the phonetic rules rewrite
+    std::vector<std::string> random_french_words(std::mt19937& random, std::size_t count)
+    {
+        static const char* parts[] = { "a", "e", "i", "o", "u", "c", "g", "s", "t", "n", "m", "r", "ph", "qu", "au", "eau",
+            "ain", "on", "an", "ch", "\xC3\xA9", "\xC3\xA8", "\xC3\xA0", "\xC3\xA7" };
+        std::vector<std::string> result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string word(1, "abcfgpstv"[random() % 9]);
+            for (std::size_t size = 1 + random() % 4; size > 0; --size)
+            {
+                word += parts[random() % (sizeof(parts) / sizeof(parts[0]))];
+            }
+            result.push_back(word);
+        }
+        return result;
+    }
+
+    //! @brief get the words of an index having the same key as a given word, sorted
+    std::vector<std::string> group_of(const ZDPhoneticIndex& index, const std::string& word)
+    {
+        std::vector<std::string> result;
+        for (const auto id : index.find_ids(word))
+        {
+            result.push_back(index.word(id));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    //! @brief check an index against the groups of its words by key, computed one word at a time
+    void check_groups(std::mt19937& random, const ZDPhoneticIndex& index, const std::set<std::string>& words)
+    {
+        std::map<std::string, std::vector<std::string>> groups;
+        for (const auto& word : words)
+        {
+            groups[index.key(word)].push_back(word);
+        }
+        ZD_CHECK(index.key_count() == groups.size());
+
+        auto queries = random_french_words(random, 200);
+        queries.insert(queries.end(), words.begin(), words.end());
+        for (const auto& query : queries)
+        {
+            const auto found = groups.find(index.key(query));
+            const std::vector<std::string> group = (found != groups.end()) ? found->second : std::vector<std::string>();
+            ZD_CHECK(group_of(index, query) == group);
+
+            //the words of the group within the errors, by number of errors then alphabetically
+            const int max_error = static_cast<int>(random() % 4);
+            std::vector<std::pair<std::string, int>> reference;
+            for (const auto& word : group)
+            {
+                const int errors = Test::reference_distance(query, word);
+                if (errors <= max_error)
+                {
+                    reference.emplace_back(word, errors);
+                }
+            }
+            std::sort(reference.begin(), reference.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            ZD_CHECK(index.find_words(query, max_error) == reference);
+            ZD_CHECK(index.find_word(query, max_error) == !reference.empty());
+        }
+    }
+}
+
+ZD_TEST(phonetic_index_groups_match_keys)
+{
+    std::mt19937 random(47);
+    const auto words = random_french_words(random, 3000);
+
+    ZDPhoneticIndex index;
+    index.build(words);
+    const std::set<std::string> unique(words.begin(), words.end());
+    ZD_CHECK(index.word_count() == unique.size());
+    ZD_CHECK(index.word(0) == *unique.begin());
+    check_groups(random, index, unique);
+}
+
+ZD_TEST(phonetic_index_follows_dictionary_ids)
+{
+    std::mt19937 random(147);
+    ZDDictionary dictionary;
+    std::set<std::string> words;
+    for (const auto& word : random_french_words(random, 3000))
+    {
+        dictionary.insert_word(word);
+        words.insert(word);
+    }
+
+    //removed words leave free ids, which have no word in the index
+    for (const auto& word : random_french_words(random, 3000))
+    {
+        dictionary.remove_word(word);
+        words.erase(word);
+    }
+
+    ZDPhoneticIndex index;
+    index.build(dictionary);
+    ZD_CHECK(index.word_count() == dictionary.id_capacity());
+    for (uint32_t id = 0; id < index.word_count(); ++id)
+    {
+        ZD_CHECK(index.word(id) == dictionary.word_from_id(id));
+    }
+    for (const auto& word : words)
+    {
+        const std::vector<uint32_t> ids = index.find_ids(word);
+        ZD_CHECK(std::find(ids.begin(), ids.end(), std::get<uint32_t>(dictionary.word_id(word))) != ids.end());
+    }
+    check_groups(random, index, words);
+}
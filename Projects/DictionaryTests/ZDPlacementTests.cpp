@@ -0,0 +1,113 @@
+#include <random>
+#include <cstdio>
+#include <sstream>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Memory/ZDPlacement.h"
+#include "Memory/ZDReplicatedDictionary.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief check that a copy of a dictionary answers as the original
+    void check_same(std::mt19937& random, const ZDDictionary& copy, const ZDDictionary& original)
+    {
+        ZD_CHECK(copy.word_count() == original.word_count());
+        for (std::size_t index = 0; index < original.word_count(); index += 1 + random() % 7)
+        {
+            const std::string word = original.select(index);
+            ZD_CHECK(copy.select(index) == word);
+            ZD_CHECK(copy.word_weight(word) == original.word_weight(word));
+            ZD_CHECK(copy.word_id(word) == original.word_id(word));
+        }
+        for (const auto& query : Test::random_words(random, 200, 7, "abcdE"))
+        {
+            ZD_CHECK(copy.find_word(query) == original.find_word(query));
+            ZD_CHECK(copy.count_prefix(query.substr(0, 2)) == original.count_prefix(query.substr(0, 2)));
+            ZD_CHECK(copy.find_words(query, 1) == original.find_words(query, 1));
+        }
+    }
+
+    //! @brief get a dictionary of random words and weights
+    void fill(std::mt19937& random, ZDDictionary& dictionary)
+    {
+        for (const auto& word : Test::random_words(random, 20000, 8, "abcde"))
+        {
+            dictionary.insert_word(word, random() % 100);
+        }
+    }
+}
+
+ZD_TEST(replicated_dictionary_matches_original)
+{
+    std::mt19937 random(49);
+    ZDDictionary original;
+    fill(random, original);
+
+    //placed copies : mapped apart from the heap, and huge pages, faulted in, when the system allows it
+    ZDPlacementOptions options;
+    options.huge_pages = ZDHugePages::Transparent;
+    options.prefault = true;
+    options.min_size = 4096;
+
+    ZDReplicatedDictionary replicated(options);
+    ZD_CHECK(replicated.build(original));
+    ZD_CHECK(replicated.replica_count() == static_cast<std::size_t>(numa_node_count()));
+    for (std::size_t node = 0; node < replicated.replica_count(); ++node)
+    {
+        check_same(random, replicated.replica(static_cast<int>(node)), original);
+#if defined(__linux__)
+        ZD_CHECK(replicated.replica(static_cast<int>(node)).placement().mapped);
+#endif
+    }
+    check_same(random, replicated.local(), original);
+    check_same(random, replicated.replica(-1), original);
+
+    //built again from a file, after the original changed
+    for (const auto& word : Test::random_words(random, 3000, 8, "abcde"))
+    {
+        original.remove_word(word);
+    }
+    const std::string path = Test::temporary_path("replicated.dico");
+    ZD_CHECK(original.save(path));
+    ZD_CHECK(replicated.load(path));
+    check_same(random, replicated.local(), original);
+    std::remove(path.c_str());
+    ZD_CHECK(!replicated.load(path));
+    check_same(random, replicated.local(), original);
+}
+
+ZD_TEST(placed_dictionary_matches_heap)
+{
+    std::mt19937 random(149);
+    ZDDictionary heap;
+    fill(random, heap);
+
+    std::stringstream buffer;
+    ZD_CHECK(heap.save(buffer));
+    ZDDictionary placed;
+    ZDPlacementOptions options;
+    options.huge_pages = ZDHugePages::Explicit;
+    options.numa_node = 0;
+    options.min_size = 4096;
+    placed.set_placement(options);
+    ZD_CHECK(placed.load(buffer));
+    check_same(random, placed, heap);
+
+    //the words inserted after come from the heap until the next optimize
+    for (const auto& word : Test::random_words(random, 2000, 9, "abcdef"))
+    {
+        const uint32_t weight = random() % 100;
+        heap.insert_word(word, weight);
+        placed.insert_word(word, weight);
+    }
+    check_same(random, placed, heap);
+    placed.optimize();
+    check_same(random, placed, heap);
+
+    //back to the heap
+    ZD_CHECK(placed.set_placement(ZDPlacementOptions()));
+    ZD_CHECK(!placed.placement().mapped);
+    check_same(random, placed, heap);
+}
@@ -0,0 +1,22 @@
+#include "ZDWordSetTests.h"
+#include "Radix/ZDRadixTree.h"
+
+using namespace Dico;
+
+ZD_TEST(radix_tree_matches_set)
+{
+    for (unsigned seed = 39; seed < 42; ++seed)
+    {
+        Test::check_word_tree<ZDRadixTree>(seed);
+    }
+}
+
+ZD_TEST(radix_tree_long_word)
+{
+    //beyond the single word kernel, the words are compared one by one
+    ZDRadixTree tree;
+    const std::string word(100, 'a');
+    tree.build({ word, word + "b", "a" });
+    ZD_CHECK(tree.find_words(word, 1) == (std::vector<std::pair<std::string, int>>{ { word, 0 }, { word + "b", 1 } }));
+    ZD_CHECK(tree.find_words(word, -1).empty());
+}
@@ -0,0 +1,159 @@
+#include <map>
+#include <set>
+#include <random>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Set/ZDDictionaryOverlay.h"
+
+using namespace Dico;
+
+namespace
+{
+    typedef std::map<std::string, uint32_t> Weights;
+
+    //! @brief get random words with random weights, sharing prefixes
+    Weights random_weights(std::mt19937& random, std::size_t count)
+    {
+        Weights result;
+        for (const auto& word : Test::random_words(random, count, 8, "abcde"))
+        {
+            result[word] = random() % 100;
+        }
+        return result;
+    }
+
+    //! @brief fill a dictionary with weighted words
+    void fill(ZDDictionary& dictionary, const Weights& words)
+    {
+        for (const auto& word : words)
+        {
+            dictionary.insert_word(word.first, word.second);
+        }
+    }
+
+    //! @brief check the words, weights, counts and ids of a dictionary against a map
+    void check_words(const ZDDictionary& dictionary, const Weights& expected)
+    {
+        Weights found;
+        std::set<uint32_t> ids;
+        dictionary.for_each_word([&](const std::string& word, uint32_t id, uint32_t weight)
+        {
+            found[word] = weight;
+            ids.insert(id);
+            ZD_CHECK(id < dictionary.id_capacity());
+            ZD_CHECK(dictionary.word_from_id(id) == word);
+        });
+        ZD_CHECK(found == expected);
+        ZD_CHECK(ids.size() == expected.size());
+        ZD_CHECK(dictionary.word_count() == expected.size());
+
+        for (const std::string prefix : { "a", "ab", "eed", "c" })
+        {
+            std::size_t count = 0;
+            for (auto it = expected.lower_bound(prefix); it != expected.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            {
+                ++count;
+            }
+            ZD_CHECK(dictionary.count_prefix(prefix) == count);
+        }
+    }
+}
+
+ZD_TEST(set_operations_match_map)
+{
+    std::mt19937 random(44);
+    for (int round = 0; round < 30; ++round)
+    {
+        const Weights first = random_weights(random, random() % 1500);
+        const Weights second = random_weights(random, random() % 1500);
+        ZDDictionary left;
+        ZDDictionary right;
+        fill(left, first);
+        fill(right, second);
+
+        Weights merged = first;
+        Weights common;
+        Weights rest;
+        for (const auto& word : second)
+        {
+            merged[word.first] = word.second;
+        }
+        for (const auto& word : first)
+        {
+            (second.count(word.first) != 0 ? common : rest).insert(word);
+        }
+
+        ZDDictionary result;
+        result.insert_word("replaced");
+        ZD_CHECK(result.merge(left, right));
+        check_words(result, merged);
+        ZD_CHECK(result.intersect(left, right));
+        check_words(result, common);
+        ZD_CHECK(result.subtract(left, right));
+        check_words(result, rest);
+
+        //the result is an ordinary dictionary afterwards
+        ZD_CHECK(result.insert_word("eeeeeeeee", 5));
+        rest["eeeeeeeee"] = 5;
+        if (!rest.empty() && rest.begin()->first != "eeeeeeeee")
+        {
+            ZD_CHECK(result.remove_word(rest.begin()->first));
+            rest.erase(rest.begin());
+        }
+        check_words(result, rest);
+    }
+}
+
+ZD_TEST(set_operations_refuse_aliasing)
+{
+    ZDDictionary dictionary;
+    ZDDictionary other;
+    dictionary.insert_word("abc");
+    ZD_CHECK(!dictionary.merge(dictionary, other));
+    ZD_CHECK(!dictionary.intersect(other, dictionary));
+    ZD_CHECK(!dictionary.subtract(dictionary, dictionary));
+    ZD_CHECK(dictionary.find_word("abc"));
+}
+
+ZD_TEST(overlay_matches_merge_then_subtract)
+{
+    std::mt19937 random(144);
+    for (int round = 0; round < 10; ++round)
+    {
+        const Weights base = random_weights(random, 1000);
+        const Weights added = random_weights(random, 300);
+        const Weights blocked = random_weights(random, 300);
+        ZDDictionary baseDictionary;
+        ZDDictionary additions;
+        ZDDictionary removals;
+        fill(baseDictionary, base);
+        fill(additions, added);
+        fill(removals, blocked);
+
+        ZDDictionary merged;
+        ZDDictionary expected;
+        merged.merge(baseDictionary, additions);
+        expected.subtract(merged, removals);
+        const ZDDictionaryOverlay overlay(baseDictionary, &additions, &removals);
+
+        for (const auto& word : Test::random_words(random, 500, 8, "abcde"))
+        {
+            ZD_CHECK(overlay.find_word(word) == expected.find_word(word));
+            ZD_CHECK(overlay.word_weight(word) == expected.word_weight(word));
+        }
+        //words of equal weight may come in any order, and the last ones be any of them
+        for (const std::string prefix : { "", "a", "bc", "dde" })
+        {
+            const auto completed = overlay.complete(prefix, 10);
+            const auto reference = expected.complete(prefix, 10);
+            ZD_CHECK(completed.size() == reference.size());
+            for (std::size_t i = 0; i < std::min(completed.size(), reference.size()); ++i)
+            {
+                ZD_CHECK(completed[i].second == reference[i].second);
+                ZD_CHECK(completed[i].first.compare(0, prefix.size(), prefix) == 0);
+                ZD_CHECK(expected.word_weight(completed[i].first) == std::make_tuple(true, completed[i].second));
+            }
+        }
+        ZD_CHECK(overlay.find_words("abcd", 1) == expected.find_words("abcd", 1));
+    }
+}
@@ -0,0 +1,150 @@
+#include <random>
+#include <sstream>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Pipeline/ZDSpellChecker.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get a random word over letters of one to three bytes, so that a chunk often ends inside a letter
+    std::string random_utf8_word(std::mt19937& random)
+    {
+        static const char* letters[] = { "a", "b", "c", "e", "\xC3\xA9", "\xC3\xA8", "\xC3\xA0", "\xC3\xA7", "\xC5\x93", "\xE1\xBA\xBD" };
+        std::string result;
+        for (std::size_t size = 1 + random() % 6; size > 0; --size)
+        {
+            result += letters[random() % (sizeof(letters) / sizeof(letters[0]))];
+        }
+        return result;
+    }
+
+    //! @brief get a text of known words, misspelled words and groups of words, separated by white spaces and by
+    //! punctuation of one to three bytes, with some long runs of words without any white space
+    std::string random_text(std::mt19937& random, const std::vector<std::string>& known, std::size_t count)
+    {
+        static const char* spaces[] = { " ", "\n", ", ", ". ", " \xC2\xAB\xC2\xA0", "\xC2\xA0\xC2\xBB " };
+        static const char* punctuations[] = { "\xC2\xA0", "\xE2\x80\xA6", "\xE2\x80\x94", ";", "," };
+        static const char* joins[] = { "-", "'", "\xE2\x80\x99", "\xE2\x80\x90" };
+        std::string result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string word = (random() % 3 != 0) ? known[random() % known.size()] : random_utf8_word(random);
+            if (random() % 5 == 0 && word[0] >= 'a' && word[0] <= 'z')
+            {
+                word[0] = static_cast<char>(word[0] - 'a' + 'A');
+            }
+            result += word;
+            if (random() % 4 == 0)
+            {
+                result += joins[random() % (sizeof(joins) / sizeof(joins[0]))];
+            }
+            else if (random() % 3 == 0)
+            {
+                //punctuation only, so that a chunk may have no white space at all
+                result += punctuations[random() % (sizeof(punctuations) / sizeof(punctuations[0]))];
+            }
+            else
+            {
+                result += spaces[random() % (sizeof(spaces) / sizeof(spaces[0]))];
+            }
+        }
+        return result;
+    }
+
+    //! @brief check a text from a stream, the records being collected
+    std::vector<ZDSpellRecord> check_stream(const ZDDictionary& dictionary, const ZDSpellOptions& options, const std::string& text)
+    {
+        std::vector<ZDSpellRecord> result;
+        std::istringstream in(text);
+        const uint64_t count = ZDSpellChecker(dictionary, options).check(in, [&result](const ZDSpellRecord& record)
+        {
+            result.push_back(record);
+        });
+        ZD_CHECK(count == result.size());
+        return result;
+    }
+
+    //! @brief true if two lists of records are equal
+    bool same_records(const std::vector<ZDSpellRecord>& a, const std::vector<ZDSpellRecord>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].offset != b[i].offset || a[i].length != b[i].length || a[i].suggestions != b[i].suggestions)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+ZD_TEST(spell_checker_chunks_match_whole_text)
+{
+    std::mt19937 random(33);
+    for (int round = 0; round < 4; ++round)
+    {
+        ZDDictionary dictionary;
+        std::vector<std::string> known;
+        for (int i = 0; i < 300; ++i)
+        {
+            known.push_back(random_utf8_word(random));
+            dictionary.insert_word(known.back(), random() % 20);
+        }
+        dictionary.insert_word("l");
+        dictionary.insert_word("aujourd'hui");
+
+        const std::string text = random_text(random, known, 3000);
+        const ZDSpellChecker checker(dictionary);
+        const std::vector<ZDSpellRecord> reference = checker.check(text);
+        ZD_CHECK(!reference.empty());
+
+        //every record is a whole word, starting and ending on a letter boundary
+        for (const auto& record : reference)
+        {
+            ZD_CHECK(record.offset + record.length <= text.size());
+            ZD_CHECK((static_cast<unsigned char>(text[record.offset]) & 0xC0) != 0x80);
+            ZD_CHECK(record.offset + record.length == text.size() || (static_cast<unsigned char>(text[record.offset + record.length]) & 0xC0) != 0x80);
+        }
+
+        //chunks cut inside the letters, one thread then several
+        for (const std::size_t chunk_size : { 1, 2, 3, 5, 7, 16, 61, 1 << 20 })
+        {
+            for (const unsigned int threads : { 1u, 2u, 4u })
+            {
+                ZDSpellOptions options;
+                options.chunk_size = chunk_size;
+                options.threads = threads;
+                ZD_CHECK(same_records(check_stream(dictionary, options, text), reference));
+            }
+        }
+    }
+}
+
+ZD_TEST(spell_checker_single_group)
+{
+    //a text with no boundary at all is read as one chunk, whatever the chunk size
+    ZDDictionary dictionary;
+    dictionary.insert_word("\xC3\xA9t\xC3\xA9");
+    std::string text;
+    for (int i = 0; i < 200; ++i)
+    {
+        text += (i % 2) ? "\xC3\xA9t\xC3\xA9-" : "\xC3\xA9t\xC3\xA9\xE2\x80\x99";
+    }
+    text += "\xC3\xA9tt\xC3\xA9";
+
+    const std::vector<ZDSpellRecord> reference = ZDSpellChecker(dictionary).check(text);
+    ZD_CHECK(reference.size() == 1);
+    for (const unsigned int threads : { 1u, 3u })
+    {
+        ZDSpellOptions options;
+        options.chunk_size = 3;
+        options.threads = threads;
+        ZD_CHECK(same_records(check_stream(dictionary, options, text), reference));
+    }
+}
@@ -0,0 +1,81 @@
+#include <random>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Embed/ZDStaticDictionary.h"
+#include "Embed/ZDStaticDictionaryWriter.h"
+
+using namespace Dico;
+
+ZD_TEST(static_dictionary_matches_dictionary)
+{
+    std::mt19937 random(50);
+    for (int round = 0; round < 10; ++round)
+    {
+        //removed words leave nodes without words, which the view must skip
+        ZDDictionary dictionary;
+        const auto words = Test::random_words(random, 2000, 9, "abcdeE");
+        for (const auto& word : words)
+        {
+            dictionary.insert_word(word, random() % 50);
+        }
+        for (std::size_t i = 0; i < words.size(); i += 3)
+        {
+            dictionary.remove_word(words[i]);
+        }
+
+        const std::vector<ZDStaticNode> nodes = ZDStaticDictionaryWriter::flatten(dictionary);
+        const ZDStaticDictionary view(nodes.data(), nodes.size());
+        ZD_CHECK(view.word_count() == dictionary.word_count());
+
+        auto queries = Test::random_words(random, 300, 9, "abcdeE");
+        queries.push_back("-" + words[1]);
+        queries.push_back("");
+        for (const auto& query : queries)
+        {
+            ZD_CHECK(view.find_word(query) == dictionary.find_word(query));
+            ZD_CHECK(view.word_weight(query) == dictionary.word_weight(query));
+            ZD_CHECK(view.rank(query) == dictionary.rank(query));
+            ZD_CHECK(view.count_prefix(query.substr(0, 2)) == dictionary.count_prefix(query.substr(0, 2)));
+        }
+        for (const auto& query : std::vector<std::string>(queries.begin(), queries.begin() + 40))
+        {
+            const int max_error = static_cast<int>(random() % 3);
+            ZD_CHECK(view.find_words(query, max_error) == dictionary.find_words(query, max_error));
+            ZD_CHECK(view.find_word(query, max_error) == dictionary.find_word(query, max_error));
+        }
+        for (std::size_t index = 0; index <= dictionary.word_count(); index += 1 + random() % 20)
+        {
+            ZD_CHECK(view.select(index) == dictionary.select(index));
+        }
+
+        //words of equal weight may come in any order, and the last ones be any of them
+        for (const std::string prefix : { "", "a", "Bc", "zz" })
+        {
+            const auto completed = view.complete(prefix, 15);
+            const auto reference = dictionary.complete(prefix, 15);
+            ZD_CHECK(completed.size() == reference.size());
+            for (std::size_t i = 0; i < std::min(completed.size(), reference.size()); ++i)
+            {
+                ZD_CHECK(completed[i].second == reference[i].second);
+                ZD_CHECK(dictionary.word_weight(completed[i].first) == std::make_tuple(true, completed[i].second));
+            }
+        }
+    }
+}
+
+ZD_TEST(static_dictionary_empty)
+{
+    const ZDStaticDictionary none;
+    ZD_CHECK(none.word_count() == 0);
+    ZD_CHECK(!none.find_word("a"));
+    ZD_CHECK(none.find_words("a", 2).empty());
+    ZD_CHECK(none.complete("", 5).empty());
+    ZD_CHECK(none.select(0).empty());
+
+    const ZDDictionary dictionary;
+    const std::vector<ZDStaticNode> nodes = ZDStaticDictionaryWriter::flatten(dictionary);
+    const ZDStaticDictionary view(nodes.data(), nodes.size());
+    ZD_CHECK(view.word_count() == 0);
+    ZD_CHECK(view.find_words("abc", 3).empty());
+    ZD_CHECK(view.count_prefix("") == 0);
+}
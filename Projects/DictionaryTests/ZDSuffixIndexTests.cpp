@@ -0,0 +1,127 @@
+#include <set>
+#include <sstream>
+#include <random>
+#include "ZDTest.h"
+#include "Index/ZDSuffixIndex.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get the words of a set containing a string, or ending with it, compared one by one
+    std::vector<std::string> reference_matches(const std::set<std::string>& words, const std::string& part, bool ending)
+    {
+        std::vector<std::string> result;
+        for (const auto& word : words)
+        {
+            const bool found = ending ? (word.size() >= part.size() && word.compare(word.size() - part.size(), part.size(), part) == 0)
+                                      : word.find(part) != std::string::npos;
+            if (found)
+            {
+                result.push_back(word);
+            }
+        }
+        return result;
+    }
+}
+
+ZD_TEST(suffix_index_matches_scan)
+{
+    std::mt19937 random(30);
+    const auto words = Test::random_words(random, 3000, 10, "abcdE");
+    std::set<std::string> reference;
+    for (auto word : words)
+    {
+        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+        reference.insert(word);
+    }
+
+    ZDSuffixIndex index;
+    index.build(words);
+    ZD_CHECK(index.word_count() == reference.size());
+    ZD_CHECK(index.word(0) == *reference.begin());
+
+    for (const auto& part : Test::random_words(random, 300, 4, "abcdeE"))
+    {
+        std::string key = part;
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+        ZD_CHECK(index.find_words_containing(part) == reference_matches(reference, key, false));
+        ZD_CHECK(index.find_words_ending_with(part) == reference_matches(reference, key, true));
+    }
+    ZD_CHECK(index.find_containing(std::string()).size() == reference.size());
+}
+
+ZD_TEST(suffix_index_save_load)
+{
+    std::mt19937 random(130);
+    ZDSuffixIndex index;
+    index.build(Test::random_words(random, 1000, 8, "abcd"));
+
+    std::stringstream stream;
+    ZD_CHECK(index.save(stream));
+    ZDSuffixIndex loaded;
+    ZD_CHECK(loaded.load(stream));
+    ZD_CHECK(loaded.word_count() == index.word_count());
+    for (const std::string part : { "a", "ab", "dcb", "abcd" })
+    {
+        ZD_CHECK(loaded.find_containing(part) == index.find_containing(part));
+        ZD_CHECK(loaded.find_ending_with(part) == index.find_ending_with(part));
+    }
+
+    std::stringstream empty;
+    ZD_CHECK(ZDSuffixIndex().save(empty));
+    ZD_CHECK(loaded.load(empty));
+    ZD_CHECK(loaded.word_count() == 0 && loaded.find_containing("a").empty());
+}
+
+ZD_TEST(suffix_index_corrupt_load)
+{
+    //a damaged file is either rejected, leaving an empty index, or loads an index whose queries stay in bounds
+    std::mt19937 random(230);
+    ZDSuffixIndex index;
+    index.build(Test::random_words(random, 200, 8, "abcd"));
+    std::stringstream stream;
+    index.save(stream);
+    const std::string file = stream.str();
+
+    for (int round = 0; round < 3000; ++round)
+    {
+        std::string damaged = file;
+        if (round % 2 == 0)
+        {
+            damaged.resize(random() % file.size());
+        }
+        else
+        {
+            for (int flip = 1 + random() % 3; flip > 0; --flip)
+            {
+                damaged[random() % damaged.size()] ^= static_cast<char>(1 << (random() % 8));
+            }
+        }
+
+        ZDSuffixIndex loaded;
+        std::istringstream in(damaged);
+        if (!loaded.load(in))
+        {
+            ZD_CHECK(loaded.word_count() == 0);
+            ZD_CHECK(loaded.find_containing("a").empty());
+            continue;
+        }
+
+        for (const std::string part : { "a", "bc", "dab", "" })
+        {
+            for (const uint32_t id : loaded.find_containing(part))
+            {
+                ZD_CHECK(id < loaded.word_count());
+            }
+            for (const uint32_t id : loaded.find_ending_with(part))
+            {
+                ZD_CHECK(id < loaded.word_count());
+            }
+        }
+        for (uint32_t id = 0; id < loaded.word_count(); ++id)
+        {
+            loaded.word(id);
+        }
+    }
+}
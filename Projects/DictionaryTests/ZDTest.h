@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+
+namespace Dico
+{
+    namespace Test
+    {
+        //! @brief a test case : its name and the function running it
+        struct ZDTestCase
+        {
+            const char* name;
+            void (*run)();
+        };
+
+        //! @brief get the test cases of the executable, in the order they are registered
+        //! @return
+        inline std::vector<ZDTestCase>& test_cases()
+        {
+            static std::vector<ZDTestCase> cases;
+            return cases;
+        }
+
+        //! @brief get the number of failed checks so far
+        //! @return
+        inline int& check_failures()
+        {
+            static int failures = 0;
+            return failures;
+        }
+
+        //! @brief registers a test case when built, see ZD_TEST
+        struct ZDTestRegistrar
+        {
+            ZDTestRegistrar(const char* name, void (*run)())
+            {
+                test_cases().push_back(ZDTestCase{ name, run });
+            }
+        };
+
+        //! @brief count and print a failed check
+        //! @param condition the checked condition
+        //! @param expression the text of the condition
+        //! @param file the file of the check
+        //! @param line the line of the check
+        //! @return the condition
+        inline bool check(bool condition, const char* expression, const char* file, int line)
+        {
+            if (!condition)
+            {
+                ++check_failures();
+                std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+            }
+            return condition;
+        }
+
+        //! @brief get the path of a temporary file, in the temporary directory; a random part chosen once per
+        //! run keeps the files of runs started together apart
+        //! @param name the name of the file
+        //! @return
+        inline std::string temporary_path(const std::string& name)
+        {
+            static const std::string run = std::to_string(std::random_device()());
+            return (std::filesystem::temp_directory_path() / ("DictionaryTests_" + run + "_" + name)).string();
+        }
+
+        //! @brief get random words over a small alphabet, so that they share prefixes and are close to each other
+        //! @param random the random generator
+        //! @param count the number of words
+        //! @param max_size the largest size of a word, the smallest being 1
+        //! @param alphabet the chars of the words
+        //! @return the words, with duplicates
+        inline std::vector<std::string> random_words(std::mt19937& random, std::size_t count, std::size_t max_size, const std::string& alphabet = "abcdefgh")
+        {
+            std::vector<std::string> result;
+            result.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::string word(1 + random() % max_size, ' ');
+                for (auto& c : word)
+                {
+                    c = alphabet[random() % alphabet.size()];
+                }
+                result.push_back(word);
+            }
+            return result;
+        }
+
+        //! @brief compute the Levenshtein distance with the whole DP matrix, the reference of the kernels
+        //! @param a the first word
+        //! @param b the second word
+        //! @return the matrix, D[i][j] being the distance between the first i chars of a and the first j chars of b
+        inline std::vector<std::vector<int>> reference_matrix(const std::string& a, const std::string& b)
+        {
+            std::vector<std::vector<int>> d(a.size() + 1, std::vector<int>(b.size() + 1, 0));
+            for (std::size_t i = 0; i <= a.size(); ++i)
+            {
+                d[i][0] = static_cast<int>(i);
+            }
+            for (std::size_t j = 0; j <= b.size(); ++j)
+            {
+                d[0][j] = static_cast<int>(j);
+            }
+            for (std::size_t i = 1; i <= a.size(); ++i)
+            {
+                for (std::size_t j = 1; j <= b.size(); ++j)
+                {
+                    d[i][j] = std::min({ d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1) });
+                }
+            }
+            return d;
+        }
+
+        //! @brief compute the Levenshtein distance with the whole DP matrix
+        //! @return
+        inline int reference_distance(const std::string& a, const std::string& b)
+        {
+            return reference_matrix(a, b).back().back();
+        }
+    }
+}
+
+//! @brief define a test case, run by DictionaryTests
+#define ZD_TEST(name) \
+    static void name(); \
+    static const Dico::Test::ZDTestRegistrar name##_registrar(#name, &name); \
+    static void name()
+
+//! @brief check a condition, a failure being printed and counted without stopping the test case
+//! (variadic so that the condition may hold commas, as in template arguments)
+#define ZD_CHECK(...) Dico::Test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
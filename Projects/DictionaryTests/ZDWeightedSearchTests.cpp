@@ -0,0 +1,115 @@
+#include <set>
+#include <random>
+#include "ZDTest.h"
+#include "ZDDictionary.h"
+#include "Distance/ZDCostModel.h"
+
+using namespace Dico;
+
+namespace
+{
+    //! @brief get random words mixing plain letters with accented letters written in Latin-1 and in UTF-8
+    std::vector<std::string> accented_words(std::mt19937& random, std::size_t count)
+    {
+        static const char* const first[] = { "a", "c", "e", "u" };
+        static const char* const rest[] = { "a", "c", "e", "u", "s", "\xE9", "\xC3\xA9", "\xE8", "\xC3\xA8", "\xE7", "\xC3\xA7", "\xFB", "\xC3\xBB" };
+        std::vector<std::string> result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string word = first[random() % 4];
+            for (std::size_t size = random() % 7; size > 0; --size)
+            {
+                word += rest[random() % (sizeof(rest) / sizeof(rest[0]))];
+            }
+            result.push_back(word);
+        }
+        return result;
+    }
+
+    //! @brief get the words of a set within a budget of a word, compared one by one with ZDCostModel::distance
+    //! @return the words with their cost, sorted by cost then alphabetically
+    std::vector<std::pair<std::string, float>> reference_words(const std::set<std::string>& words, const std::string& word, const ZDCostModel& model, float budget)
+    {
+        std::vector<std::pair<std::string, float>> result;
+        for (const auto& candidate : words)
+        {
+            const float cost = model.distance(word, candidate);
+            if (cost <= budget)
+            {
+                result.emplace_back(candidate, cost);
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const std::pair<std::string, float>& a, const std::pair<std::string, float>& b)
+        {
+            return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+        });
+        return result;
+    }
+}
+
+ZD_TEST(weighted_search_matches_distance)
+{
+    std::mt19937 random(46);
+
+    ZDCostModel uneven(1.0f, 0.75f, 1.25f, 0.5f);
+    uneven.set_insertion('s', 0.25f);
+    uneven.set_deletion('e', 0.5f);
+    uneven.set_substitution('c', 's', 0.25f);
+    const ZDCostModel models[] = { ZDCostModel(), ZDCostModel::french(), uneven };
+
+    const auto words = accented_words(random, 3000);
+    const std::set<std::string> reference(words.begin(), words.end());
+    ZDDictionary dictionary;
+    for (const auto& word : words)
+    {
+        dictionary.insert_word(word);
+    }
+
+    auto queries = accented_words(random, 150);
+    for (std::size_t i = 0; i < 150; ++i)
+    {
+        //a dictionary word with one accent changed from Latin-1 to UTF-8, or one letter swapped
+        std::string query = words[random() % words.size()];
+        const std::size_t at = query.find('\xE9');
+        if (at != std::string::npos)
+        {
+            query.replace(at, 1, "\xC3\xA9");
+        }
+        else if (query.size() > 2 && static_cast<unsigned char>(query[1]) < 0x80 && static_cast<unsigned char>(query[2]) < 0x80)
+        {
+            std::swap(query[1], query[2]);
+        }
+        queries.push_back(query);
+    }
+
+    std::size_t found = 0;
+    for (const auto& model : models)
+    {
+        for (const auto& query : queries)
+        {
+            const float budget = 0.25f * static_cast<float>(random() % 7);
+            const auto expected = reference_words(reference, query, model, budget);
+            ZD_CHECK(dictionary.find_words(query, model, budget) == expected);
+            ZD_CHECK(dictionary.find_word(query, model, budget) == !expected.empty());
+            found += expected.size();
+        }
+    }
+    //the budgets are wide enough for the comparisons to matter
+    ZD_CHECK(found > queries.size());
+}
+
+ZD_TEST(weighted_search_folds_accents)
+{
+    ZDDictionary dictionary;
+    dictionary.insert_word("caf\xE9");
+    dictionary.insert_word("c\xC3\xA8pe");
+    const ZDCostModel model = ZDCostModel::french();
+
+    //the same letter in Latin-1 or in UTF-8 costs nothing, an accent changed costs the accent cost
+    ZD_CHECK(dictionary.find_words("caf\xC3\xA9", model, 0.0f) == (std::vector<std::pair<std::string, float>>{ { "caf\xE9", 0.0f } }));
+    ZD_CHECK(dictionary.find_words("c\xE8pe", model, 0.0f) == (std::vector<std::pair<std::string, float>>{ { "c\xC3\xA8pe", 0.0f } }));
+    ZD_CHECK(dictionary.find_words("cafe", model, 0.25f) == (std::vector<std::pair<std::string, float>>{ { "caf\xE9", 0.25f } }));
+    ZD_CHECK(dictionary.find_words("c\xC3\xA9pe", model, 0.25f) == (std::vector<std::pair<std::string, float>>{ { "c\xC3\xA8pe", 0.25f } }));
+    ZD_CHECK(!dictionary.find_word("cape", model, 0.2f));
+    ZD_CHECK(model.distance("c\xC3\xA9pe", "c\xE9pe") == 0.0f);
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+#include <random>
+#include <utility>
+#include <tuple>
+#include <algorithm>
+#include "ZDTest.h"
+
+namespace Dico
+{
+    namespace Test
+    {
+        //! @brief get the words of a reference set starting with a prefix
+        //! @return the words, sorted
+        inline std::vector<std::string> reference_prefix(const std::set<std::string>& words, const std::string& prefix)
+        {
+            std::vector<std::string> result;
+            for (auto it = words.lower_bound(prefix); it != words.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+            {
+                result.push_back(*it);
+            }
+            return result;
+        }
+
+        //! @brief get the words of a reference set close to a word, compared one by one
+        //! @return the words with their number of errors, sorted by number of errors then alphabetically
+        inline std::vector<std::pair<std::string, int>> reference_words(const std::set<std::string>& words, const std::string& word, int max_error)
+        {
+            std::vector<std::pair<std::string, int>> result;
+            for (const auto& candidate : words)
+            {
+                const int errors = reference_distance(word, candidate);
+                if (errors <= max_error)
+                {
+                    result.emplace_back(candidate, errors);
+                }
+            }
+            std::sort(result.begin(), result.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+            {
+                return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+            });
+            return result;
+        }
+
+        //! @brief check a tree of words (ZDRadixTree, ZDAdaptiveRadixTree) against a std::set through random
+        //! inserts and removes, then its exact, prefix and approximate searches
+        //! @param seed the seed of the random words
+        template<class Tree>
+        void check_word_tree(unsigned seed)
+        {
+            std::mt19937 random(seed);
+            Tree tree;
+            std::set<std::string> reference;
+
+            //few letters : shared prefixes and words ending inside others; many symbols in short words : wide
+            //nodes; the removes of words inserted before make the nodes shrink
+            const std::string wide = "abcdefghijklmnopqrstuvwxyz0123456789-'.,;:!?()[]{}<>/+*=&%$#@~^_|";
+            auto words = random_words(random, 3000, 10, "abcde");
+            const auto wideWords = random_words(random, 1500, 3, wide);
+            words.insert(words.end(), wideWords.begin(), wideWords.end());
+            std::shuffle(words.begin(), words.end(), random);
+            for (std::size_t i = 0; i < words.size(); ++i)
+            {
+                const std::string& word = (random() % 4 == 0) ? words[random() % (i + 1)] : words[i];
+                if (&word != &words[i])
+                {
+                    ZD_CHECK(tree.remove_word(word) == (reference.erase(word) == 1));
+                }
+                else
+                {
+                    ZD_CHECK(tree.insert_word(word) == reference.insert(word).second);
+                }
+            }
+            ZD_CHECK(tree.word_count() == reference.size());
+
+            for (const auto& word : words)
+            {
+                ZD_CHECK(tree.find_word(word) == (reference.count(word) == 1));
+            }
+            if (!reference.empty())
+            {
+                std::string upperCase = *reference.begin();
+                std::transform(upperCase.begin(), upperCase.end(), upperCase.begin(), ::toupper);
+                ZD_CHECK(tree.find_word(upperCase));
+            }
+
+            for (const auto& prefix : random_words(random, 200, 4, "abcde#"))
+            {
+                const auto expected = reference_prefix(reference, prefix);
+                ZD_CHECK(tree.find_prefix(prefix) == expected);
+
+                const std::size_t max_count = random() % 5;
+                const auto first = tree.find_prefix(prefix, max_count);
+                ZD_CHECK(first == std::vector<std::string>(expected.begin(), expected.begin() + std::min(max_count, expected.size())));
+            }
+            ZD_CHECK(tree.find_prefix(std::string()).size() == reference.size());
+
+            for (const auto& word : random_words(random, 60, 8, "abcde#"))
+            {
+                const int max_error = static_cast<int>(random() % 3);
+                const auto expected = reference_words(reference, word, max_error);
+                ZD_CHECK(tree.find_words(word, max_error) == expected);
+
+                //the closest words first, the ones with fewer errors
+                const std::size_t max_count = 1 + random() % 6;
+                const auto closest = tree.find_words(word, max_error, max_count);
+                ZD_CHECK(closest == std::vector<std::pair<std::string, int>>(expected.begin(), expected.begin() + std::min(max_count, expected.size())));
+            }
+
+            //remove everything, then the tree is empty and usable again
+            for (const auto& word : reference)
+            {
+                ZD_CHECK(tree.remove_word(word));
+            }
+            ZD_CHECK(tree.word_count() == 0);
+            ZD_CHECK(tree.find_prefix(std::string()).empty());
+            ZD_CHECK(tree.insert_word("again"));
+            ZD_CHECK(tree.find_word("again"));
+        }
+    }
+}
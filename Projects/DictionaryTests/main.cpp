@@ -0,0 +1,35 @@
+#include <iostream>
+#include <string>
+#include "ZDTest.h"
+
+using namespace std;
+using namespace Dico::Test;
+
+//! @brief run the test cases, or those whose name starts with a given prefix
+//! @param argc 
+//! @param argv the optional prefix
+//! @return 0 if every check passed, 1 otherwise
+int main(int argc, char* argv[])
+{
+    const string prefix = (argc > 1) ? argv[1] : "";
+
+    int failedCases = 0;
+    int runCases = 0;
+    for (const auto& testCase : test_cases())
+    {
+        if (string(testCase.name).compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+
+        const int before = check_failures();
+        testCase.run();
+        ++runCases;
+        const bool passed = check_failures() == before;
+        failedCases += passed ? 0 : 1;
+        cout << (passed ? "[ OK ] " : "[FAIL] ") << testCase.name << endl;
+    }
+
+    cout << runCases - failedCases << " of " << runCases << " test cases passed" << endl;
+    return (failedCases == 0 && runCases != 0) ? 0 : 1;
+}